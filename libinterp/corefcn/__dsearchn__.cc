@@ -29,14 +29,402 @@
 
 #include <cmath>
 
+#include <algorithm>
+#include <limits>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "oct-parallel.h"
+
+#include "Cell.h"
 #include "defun.h"
 #include "error.h"
+#include "oct-map.h"
 #include "ovl.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+// A k-d tree for nearest neighbor and radius searches.
+//
+// The points are stored in the order of a balanced tree: the points of
+// each node are a contiguous range, the point that splits the node is
+// in the middle of the range, the points before it are not greater and
+// the points after it are not less than it in the split dimension.
+// Ranges of at most m_leaf_size points are searched linearly.
+//
+// The tree can be converted to a struct and back, so that it can be
+// built once and passed to several queries.  Its fields are
+//
+//   x          points in tree order, one per column
+//   idx        original (one-based) index of each point
+//   dim        (one-based) split dimension for each point
+//   leaf_size  maximum number of points in a leaf
+//
+// Points with NaN coordinates are left out of the tree.
+
+class kd_tree
+{
+public:
+
+  // Distance (squared) and original index of a point found by a search.
+  // Points at the same distance are ordered by their index.
+  typedef std::pair<double, double> entry;
+
+  kd_tree () = delete;
+
+  // Build the tree for the points in the columns of X.
+
+  kd_tree (const Matrix& x, octave_idx_type leaf_size = 16)
+    : m_x (), m_idx (), m_dim (), m_ndim (x.rows ()),
+      m_leaf_size (leaf_size)
+  {
+    octave_idx_type nx = x.columns ();
+
+    std::vector<octave_idx_type> perm;
+    perm.reserve (nx);
+
+    for (octave_idx_type j = 0; j < nx; j++)
+      {
+        const double *px = x.data () + j * m_ndim;
+
+        if (std::none_of (px, px + m_ndim,
+                          [] (double v) { return math::isnan (v); }))
+          perm.push_back (j);
+      }
+
+    octave_idx_type n = perm.size ();
+
+    std::vector<int> dim (n, 0);
+
+    build (x, perm, dim, 0, n);
+
+    m_x = Matrix (m_ndim, n);
+    m_idx = ColumnVector (n);
+    m_dim = int32NDArray (dim_vector (n, 1));
+
+    for (octave_idx_type i = 0; i < n; i++)
+      {
+        std::copy_n (x.data () + perm[i] * m_ndim, m_ndim,
+                     m_x.rwdata () + i * m_ndim);
+        m_idx.xelem (i) = perm[i] + 1;
+        m_dim.xelem (i) = dim[i] + 1;
+      }
+  }
+
+  kd_tree (const octave_scalar_map& m, const char *who)
+    : m_x (), m_idx (), m_dim (), m_ndim (0), m_leaf_size (0)
+  {
+    octave_value x = m.getfield ("x");
+    octave_value idx = m.getfield ("idx");
+    octave_value dim = m.getfield ("dim");
+    octave_value leaf_size = m.getfield ("leaf_size");
+
+    if (x.is_undefined () || idx.is_undefined () || dim.is_undefined ()
+        || leaf_size.is_undefined ())
+      error ("%s: TREE must be created by __kdtree_build__", who);
+
+    m_x = x.matrix_value ();
+    m_idx = idx.column_vector_value ();
+    m_dim = dim.int32_array_value ();
+    m_ndim = m_x.rows ();
+    m_leaf_size = leaf_size.idx_type_value ();
+
+    octave_idx_type n = m_x.columns ();
+
+    if (m_idx.numel () != n || m_dim.numel () != n || m_leaf_size < 1)
+      error ("%s: TREE must be created by __kdtree_build__", who);
+
+    for (octave_idx_type i = 0; i < n; i++)
+      {
+        int d = m_dim.xelem (i).value ();
+
+        if (d < 1 || d > m_ndim)
+          error ("%s: TREE must be created by __kdtree_build__", who);
+      }
+  }
+
+  OCTAVE_DEFAULT_COPY_MOVE (kd_tree)
+
+  ~kd_tree () = default;
+
+  octave_scalar_map as_struct () const
+  {
+    octave_scalar_map m;
+
+    m.assign ("x", m_x);
+    m.assign ("idx", m_idx);
+    m.assign ("dim", m_dim);
+    m.assign ("leaf_size", m_leaf_size);
+
+    return m;
+  }
+
+  octave_idx_type ndims () const { return m_ndim; }
+
+  octave_idx_type numel () const { return m_x.columns (); }
+
+  // Find the K points closest to Q and store them in RESULT, sorted
+  // by distance.  K must not be larger than the number of points.
+
+  void knn (const double *q, octave_idx_type k, entry *result) const
+  {
+    octave_idx_type n_found = 0;
+
+    knn (q, k, result, n_found, 0, numel ());
+
+    std::sort_heap (result, result + n_found);
+  }
+
+  // Number of points within distance sqrt (R2) of Q.
+
+  octave_idx_type count_in_radius (const double *q, double r2) const
+  {
+    return in_radius (q, r2, nullptr, 0, numel ());
+  }
+
+  // Store the points within distance sqrt (R2) of Q in RESULT, sorted
+  // by distance.  RESULT must have room for count_in_radius points.
+
+  void find_in_radius (const double *q, double r2, entry *result) const
+  {
+    octave_idx_type n_found = in_radius (q, r2, result, 0, numel ());
+
+    std::sort (result, result + n_found);
+  }
+
+private:
+
+  void build (const Matrix& x, std::vector<octave_idx_type>& perm,
+              std::vector<int>& dim, octave_idx_type lo, octave_idx_type hi)
+  {
+    if (hi - lo <= m_leaf_size)
+      return;
+
+    // Split the dimension with the largest spread.
+
+    std::vector<double> xmin (m_ndim, std::numeric_limits<double>::max ());
+    std::vector<double> xmax (m_ndim, std::numeric_limits<double>::lowest ());
+
+    for (octave_idx_type i = lo; i < hi; i++)
+      {
+        const double *px = x.data () + perm[i] * m_ndim;
+
+        for (octave_idx_type k = 0; k < m_ndim; k++)
+          {
+            xmin[k] = std::min (xmin[k], px[k]);
+            xmax[k] = std::max (xmax[k], px[k]);
+          }
+      }
+
+    int d = 0;
+    for (octave_idx_type k = 1; k < m_ndim; k++)
+      {
+        if (xmax[k] - xmin[k] > xmax[d] - xmin[d])
+          d = k;
+      }
+
+    octave_idx_type mid = lo + (hi - lo) / 2;
+
+    const double *px = x.data () + d;
+    octave_idx_type stride = m_ndim;
+
+    std::nth_element (perm.begin () + lo, perm.begin () + mid,
+                      perm.begin () + hi,
+                      [px, stride] (octave_idx_type a, octave_idx_type b)
+                      { return px[a * stride] < px[b * stride]; });
+
+    dim[mid] = d;
+
+    build (x, perm, dim, lo, mid);
+    build (x, perm, dim, mid + 1, hi);
+  }
+
+  double dist2 (const double *q, octave_idx_type i) const
+  {
+    const double *px = m_x.data () + i * m_ndim;
+
+    double dd = 0.0;
+    for (octave_idx_type k = 0; k < m_ndim; k++)
+      {
+        double yd = px[k] - q[k];
+        dd += yd * yd;
+      }
+
+    return dd;
+  }
+
+  // The candidates found so far are a max-heap in RESULT.
+
+  void knn_add (const entry& e, octave_idx_type k, entry *result,
+                octave_idx_type& n_found) const
+  {
+    if (n_found < k)
+      {
+        result[n_found++] = e;
+        std::push_heap (result, result + n_found);
+      }
+    else if (e < result[0])
+      {
+        std::pop_heap (result, result + k);
+        result[k-1] = e;
+        std::push_heap (result, result + k);
+      }
+  }
+
+  void knn (const double *q, octave_idx_type k, entry *result,
+            octave_idx_type& n_found, octave_idx_type lo,
+            octave_idx_type hi) const
+  {
+    if (hi - lo <= m_leaf_size)
+      {
+        for (octave_idx_type i = lo; i < hi; i++)
+          knn_add (entry (dist2 (q, i), m_idx.xelem (i)), k, result,
+                   n_found);
+        return;
+      }
+
+    octave_idx_type mid = lo + (hi - lo) / 2;
+    int d = m_dim.xelem (mid).value () - 1;
+    double diff = q[d] - m_x.xelem (d, mid);
+
+    knn_add (entry (dist2 (q, mid), m_idx.xelem (mid)), k, result, n_found);
+
+    // Search the side of Q first, and the other side only if it may
+    // hold a closer point.  Ties are kept because they may have a
+    // smaller index.
+
+    bool left_first = (diff < 0);
+
+    if (left_first)
+      knn (q, k, result, n_found, lo, mid);
+    else
+      knn (q, k, result, n_found, mid + 1, hi);
+
+    if (n_found < k || diff * diff <= result[0].first)
+      {
+        if (left_first)
+          knn (q, k, result, n_found, mid + 1, hi);
+        else
+          knn (q, k, result, n_found, lo, mid);
+      }
+  }
+
+  // Count the points within the radius and store them in RESULT,
+  // unless it is a null pointer.
+
+  octave_idx_type in_radius (const double *q, double r2, entry *result,
+                             octave_idx_type lo, octave_idx_type hi) const
+  {
+    octave_idx_type n_found = 0;
+
+    auto check = [&] (octave_idx_type i)
+    {
+      double dd = dist2 (q, i);
+
+      if (dd <= r2)
+        {
+          if (result)
+            result[n_found] = entry (dd, m_idx.xelem (i));
+          n_found++;
+        }
+    };
+
+    if (hi - lo <= m_leaf_size)
+      {
+        for (octave_idx_type i = lo; i < hi; i++)
+          check (i);
+
+        return n_found;
+      }
+
+    octave_idx_type mid = lo + (hi - lo) / 2;
+    int d = m_dim.xelem (mid).value () - 1;
+    double diff = q[d] - m_x.xelem (d, mid);
+
+    check (mid);
+
+    if (diff <= 0 || diff * diff <= r2)
+      n_found += in_radius (q, r2, result ? result + n_found : nullptr,
+                            lo, mid);
+
+    if (diff >= 0 || diff * diff <= r2)
+      n_found += in_radius (q, r2, result ? result + n_found : nullptr,
+                            mid + 1, hi);
+
+    return n_found;
+  }
+
+  Matrix m_x;
+  ColumnVector m_idx;
+  int32NDArray m_dim;
+  octave_idx_type m_ndim;
+  octave_idx_type m_leaf_size;
+};
+
+static bool
+any_nan (const double *q, octave_idx_type n)
+{
+  return std::any_of (q, q + n, [] (double v) { return math::isnan (v); });
+}
+
+// Find the K nearest neighbors of the points in the columns of XI.
+// Queries are done in parallel.  Query points with NaN coordinates
+// (or a tree without points) yield the first K indices and distance
+// NaN, like an exhaustive search does.
+
+static octave_value_list
+kd_tree_knn (const kd_tree& tree, const Matrix& xi, octave_idx_type k)
+{
+  octave_idx_type nxi = xi.columns ();
+  octave_idx_type ndim = tree.ndims ();
+
+  std::vector<kd_tree::entry> found (nxi * k);
+
+  parallel_for (nxi, 64, [&] (octave_idx_type lo, octave_idx_type hi)
+  {
+    for (octave_idx_type i = lo; i < hi; i++)
+      {
+        const double *q = xi.data () + i * ndim;
+        kd_tree::entry *result = found.data () + i * k;
+
+        if (tree.numel () == 0 || any_nan (q, ndim))
+          {
+            for (octave_idx_type j = 0; j < k; j++)
+              result[j] = kd_tree::entry (numeric_limits<double>::NaN (),
+                                          j + 1);
+          }
+        else
+          tree.knn (q, k, result);
+      }
+  });
+
+  Matrix idx (nxi, k);
+  Matrix dist (nxi, k);
+
+  for (octave_idx_type j = 0; j < k; j++)
+    for (octave_idx_type i = 0; i < nxi; i++)
+      {
+        const kd_tree::entry& e = found[i * k + j];
+
+        idx.xelem (i, j) = e.second;
+        dist.xelem (i, j) = std::sqrt (e.first);
+      }
+
+  return ovl (idx, dist);
+}
+
+static Matrix
+query_points (const octave_value& arg, octave_idx_type ndim, const char *who)
+{
+  Matrix xi = arg.matrix_value ().transpose ();
+
+  if (xi.rows () != ndim)
+    error ("%s: number of columns of X and XI must match", who);
+
+  return xi;
+}
+
 DEFUN (__dsearchn__, args, ,
        doc: /* -*- texinfo -*-
 @deftypefn {} {[@var{idx}, @var{d}] =} dsearch (@var{x}, @var{xi})
@@ -52,55 +440,184 @@ Undocumented internal function.
   if (x.rows () != xi.rows () || x.columns () < 1)
     error ("__dsearchn__: number of rows of X and XI must match");
 
-  octave_idx_type n = x.rows ();
-  octave_idx_type nx = x.columns ();
+  return kd_tree_knn (kd_tree (x), xi, 1);
+}
+
+DEFUN (__kdtree_build__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{tree} =} __kdtree_build__ (@var{x})
+@deftypefnx {} {@var{tree} =} __kdtree_build__ (@var{x}, @var{leaf_size})
+Undocumented internal function.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 1 || nargin > 2)
+    print_usage ();
+
+  Matrix x = args(0).matrix_value ().transpose ();
+
+  octave_idx_type leaf_size = 16;
+  if (nargin == 2)
+    {
+      leaf_size = args(1).idx_type_value (true);
+
+      if (leaf_size < 1)
+        error ("__kdtree_build__: LEAF_SIZE must be positive");
+    }
+
+  return ovl (kd_tree (x, leaf_size).as_struct ());
+}
+
+DEFUN (__kdtree_knn__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{idx}, @var{d}] =} __kdtree_knn__ (@var{tree}, @var{xi}, @var{k})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 3)
+    print_usage ();
+
+  const char *who = "__kdtree_knn__";
+
+  kd_tree tree (args(0).xscalar_map_value ("%s: TREE must be a struct",
+                                           who), who);
+
+  Matrix xi = query_points (args(1), tree.ndims (), who);
+
+  octave_idx_type k = args(2).idx_type_value (true);
+
+  if (k < 1 || k > tree.numel ())
+    error ("%s: K must be between 1 and the number of points", who);
+
+  return kd_tree_knn (tree, xi, k);
+}
+
+DEFUN (__kdtree_radius__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{idx}, @var{d}] =} __kdtree_radius__ (@var{tree}, @var{xi}, @var{r})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 3)
+    print_usage ();
+
+  const char *who = "__kdtree_radius__";
+
+  kd_tree tree (args(0).xscalar_map_value ("%s: TREE must be a struct",
+                                           who), who);
+
+  Matrix xi = query_points (args(1), tree.ndims (), who);
+
+  double r = args(2).xdouble_value ("%s: R must be a real scalar", who);
+
+  if (! (r >= 0))
+    error ("%s: R must be nonnegative", who);
+
   octave_idx_type nxi = xi.columns ();
+  octave_idx_type ndim = tree.ndims ();
+  double r2 = r * r;
+
+  // Count the points for each query first, so that no memory is
+  // allocated in parallel.
+
+  std::vector<octave_idx_type> offset (nxi + 1, 0);
+
+  parallel_for (nxi, 64, [&] (octave_idx_type lo, octave_idx_type hi)
+  {
+    for (octave_idx_type i = lo; i < hi; i++)
+      {
+        const double *q = xi.data () + i * ndim;
+
+        if (! any_nan (q, ndim))
+          offset[i+1] = tree.count_in_radius (q, r2);
+      }
+  });
+
+  for (octave_idx_type i = 0; i < nxi; i++)
+    offset[i+1] += offset[i];
+
+  std::vector<kd_tree::entry> found (offset[nxi]);
+
+  parallel_for (nxi, 64, [&] (octave_idx_type lo, octave_idx_type hi)
+  {
+    for (octave_idx_type i = lo; i < hi; i++)
+      {
+        const double *q = xi.data () + i * ndim;
+
+        if (offset[i+1] > offset[i])
+          tree.find_in_radius (q, r2, found.data () + offset[i]);
+      }
+  });
+
+  Cell idx (nxi, 1);
+  Cell dist (nxi, 1);
 
-  ColumnVector idx (nxi);
-  double *pidx = idx.rwdata ();
-  ColumnVector dist (nxi);
-  double *pdist = dist.rwdata ();
-
-#define DIST(dd, y, yi, m)                      \
-  dd = 0.0;                                     \
-  for (octave_idx_type k = 0; k < m; k++)       \
-    {                                           \
-      double yd = y[k] - yi[k];                 \
-      dd += yd * yd;                            \
-    }                                           \
-  dd = sqrt (dd)
-
-  const double *pxi = xi.data ();
   for (octave_idx_type i = 0; i < nxi; i++)
     {
-      double d0;
-      const double *px = x.data ();
-      DIST(d0, px, pxi, n);
-      *pidx = 1.;
-      for (octave_idx_type j = 1; j < nx; j++)
+      octave_idx_type n_found = offset[i+1] - offset[i];
+      ColumnVector qidx (n_found);
+      ColumnVector qdist (n_found);
+
+      for (octave_idx_type j = 0; j < n_found; j++)
         {
-          px += n;
-          double d;
-          DIST (d, px, pxi, n);
-          if (d < d0)
-            {
-              d0 = d;
-              *pidx = static_cast<double> (j + 1);
-            }
-          octave_quit ();
+          const kd_tree::entry& e = found[offset[i] + j];
+
+          qidx.xelem (j) = e.second;
+          qdist.xelem (j) = std::sqrt (e.first);
         }
 
-      *pdist++ = d0;
-      pidx++;
-      pxi += n;
+      idx(i) = qidx;
+      dist(i) = qdist;
     }
 
   return ovl (idx, dist);
 }
 
 /*
-## No test needed for internal helper function.
-%!assert (1)
+%!shared x, xi, D
+%! x = rand (500, 3);
+%! x(7,:) = x(3,:);
+%! x(11,2) = NaN;
+%! xi = [rand(200, 3); x(3,:); NaN, 1, 1];
+%! D = sqrt (sumsq (permute (xi, [1 3 2]) - permute (x, [3 1 2]), 3));
+%! D(:,11) = Inf;
+
+%!test
+%! [idx, d] = __dsearchn__ (x, xi(1:end-1,:));
+%! [d0, idx0] = min (D(1:end-1,:), [], 2);
+%! assert (idx, idx0);
+%! assert (d, d0, 1e-14);
+
+%!test
+%! [idx, d] = __dsearchn__ (x, xi(end,:));
+%! assert (idx, 1);
+%! assert (d, NaN);
+
+%!test
+%! tree = __kdtree_build__ (x, 4);
+%! [idx, d] = __kdtree_knn__ (tree, xi(1:end-1,:), 5);
+%! [d0, idx0] = sort (D(1:end-1,:), 2);
+%! assert (idx, idx0(:,1:5));
+%! assert (d, d0(:,1:5), 1e-14);
+
+%!test
+%! tree = __kdtree_build__ (x);
+%! [idx, d] = __kdtree_radius__ (tree, xi, 0.2);
+%! assert (size (idx), [rows(xi), 1]);
+%! for i = 1:rows (xi)
+%!   [d0, idx0] = sort (D(i,:)');
+%!   n = nnz (d0 <= 0.2);
+%!   assert (idx{i}, idx0(1:n));
+%!   assert (d{i}, d0(1:n), 1e-14);
+%! endfor
+
+%!error <number of columns of X and XI must match>
+%! __kdtree_knn__ (__kdtree_build__ (rand (5, 2)), rand (3, 3), 1)
+%!error <K must be between 1 and the number of points>
+%! __kdtree_knn__ (__kdtree_build__ (rand (5, 2)), rand (3, 2), 6)
+%!error <TREE must be created by __kdtree_build__>
+%! __kdtree_knn__ (struct ("x", 1), 1, 1)
 */
 
 OCTAVE_END_NAMESPACE(octave)
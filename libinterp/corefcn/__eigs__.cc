@@ -378,9 +378,9 @@ Undocumented internal function.
       if (tmp.is_defined ())
         {
           if (a_is_complex || b_is_complex)
-            cresid = ComplexColumnVector (tmp.complex_vector_value ());
+            cresid = eigs_starting_vector (tmp.complex_matrix_value ());
           else
-            resid = ColumnVector (tmp.vector_value ());
+            resid = eigs_starting_vector (tmp.matrix_value ());
         }
 
       tmp = map.getfield ("disp");
@@ -709,6 +709,19 @@ Undocumented internal function.
 #endif
 }
 
+DEFUN (__eigs_free_workspaces__, , ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} __eigs_free_workspaces__ ()
+Undocumented internal function.
+@end deftypefn */)
+{
+#if defined (HAVE_ARPACK)
+  eigs_free_workspaces ();
+#endif
+
+  return ovl ();
+}
+
 /*
 ## No test needed for internal helper function.
 %!assert (1)
@@ -449,6 +449,27 @@ call_stack::push (octave_user_function *fcn,
   m_curr_frame = new_frame_idx;
 }
 
+void
+call_stack::push (octave_user_function *fcn,
+                  const stack_frame::local_vars_list& local_vars,
+                  const std::shared_ptr<stack_frame>& closure_frames)
+{
+  std::size_t new_frame_idx;
+  std::shared_ptr<stack_frame> parent_link;
+  std::shared_ptr<stack_frame> static_link;
+
+  get_new_frame_index_and_links (new_frame_idx, parent_link, static_link);
+
+  std::shared_ptr<stack_frame>
+  new_frame (stack_frame::create (m_evaluator, fcn, new_frame_idx,
+                                  parent_link, static_link, local_vars,
+                                  closure_frames));
+
+  m_cs.push_back (new_frame);
+
+  m_curr_frame = new_frame_idx;
+}
+
 void
 call_stack::push (octave_user_script *script)
 {
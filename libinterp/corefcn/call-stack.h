@@ -160,6 +160,10 @@ public:
              const stack_frame::local_vars_map& local_vars,
              const std::shared_ptr<stack_frame>& closure_frames = std::shared_ptr<stack_frame> ());
 
+  void push (octave_user_function *fcn,
+             const stack_frame::local_vars_list& local_vars,
+             const std::shared_ptr<stack_frame>& closure_frames = std::shared_ptr<stack_frame> ());
+
   void push (octave_user_script *script);
 
   void push (octave_function *fcn);
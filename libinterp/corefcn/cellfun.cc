@@ -63,6 +63,12 @@
 #include "ov-uint8.h"
 
 #include "ov-fcn-handle.h"
+#include "ov-usr-fcn.h"
+#include "pt-arg-list.h"
+#include "pt-const.h"
+#include "pt-id.h"
+#include "pt-idx.h"
+#include "pt-misc.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
@@ -222,6 +228,214 @@ try_cellfun_internal_ops (const octave_value_list& args, int nargin)
   return retval;
 }
 
+// If FCN is an anonymous function of one argument X that captures no
+// variables and whose body is the index expression IDX_EXPR, return
+// the name of X.  Otherwise, return an empty string.
+
+static std::string
+anonymous_fcn_index_expr (const octave_value& fcn,
+                          tree_index_expression *& idx_expr)
+{
+  octave_fcn_handle *fh = fcn.fcn_handle_value ();
+
+  if (! fh->is_anonymous ())
+    return "";
+
+  Cell workspace = fh->workspace ().cell_value ();
+
+  if (workspace.numel () != 1 || workspace(0).nfields () != 0)
+    return "";
+
+  octave_user_function *user_fcn = fh->user_function_value ();
+
+  if (! user_fcn)
+    return "";
+
+  tree_parameter_list *param_list = user_fcn->parameter_list ();
+
+  if (! param_list || param_list->takes_varargs ()
+      || param_list->size () != 1)
+    return "";
+
+  tree_expression *expr = user_fcn->special_expr ();
+
+  if (! expr || ! expr->is_index_expression ())
+    return "";
+
+  idx_expr = dynamic_cast<tree_index_expression *> (expr);
+
+  std::list<tree_argument_list *> arg_lists = idx_expr->arg_lists ();
+
+  if (idx_expr->type_tags () != "(" || arg_lists.size () != 1
+      || ! arg_lists.front () || ! idx_expr->expression ()
+      || ! idx_expr->expression ()->is_identifier ())
+    return "";
+
+  return param_list->front ()->name ();
+}
+
+// If FCN is a handle to a function, or an anonymous function of the
+// form @(x) f (x), return the function that calling it with arguments
+// ARGS would run if that is a built-in function.  Otherwise, return an
+// undefined value.
+
+static octave_value
+builtin_fcn_handle_target (symbol_table& symtab, const octave_value& fcn,
+                           const octave_value_list& args)
+{
+  if (! fcn.is_function_handle ())
+    return octave_value ();
+
+  octave_fcn_handle *fh = fcn.fcn_handle_value ();
+
+  std::string name;
+  symbol_scope scope = symbol_scope::invalid ();
+
+  if (fh->is_simple ())
+    {
+      name = fh->fcn_name ();
+      scope = symtab.current_scope ();
+    }
+  else
+    {
+      if (args.length () != 1)
+        return octave_value ();
+
+      tree_index_expression *idx_expr = nullptr;
+
+      std::string param = anonymous_fcn_index_expr (fcn, idx_expr);
+
+      if (param.empty ())
+        return octave_value ();
+
+      tree_argument_list *arg_list = idx_expr->arg_lists ().front ();
+
+      if (arg_list->size () != 1 || ! arg_list->front ()
+          || ! arg_list->front ()->is_identifier ()
+          || arg_list->front ()->name () != param)
+        return octave_value ();
+
+      name = idx_expr->expression ()->name ();
+
+      if (name == param)
+        return octave_value ();
+
+      scope = fh->user_function_value ()->scope ();
+    }
+
+  if (name.empty () || name.find ('.') != std::string::npos)
+    return octave_value ();
+
+  octave_value retval = symtab.find_function (name, args, scope);
+
+  octave_function *target
+    = (retval.is_function () ? retval.function_value (true) : nullptr);
+
+  if (! target || ! target->is_builtin_function ()
+      || target->is_class_method ())
+    return octave_value ();
+
+  // A simple handle calls the function found when it was created
+  // unless a class method overrides it.
+
+  if (fh->is_simple ())
+    {
+      octave_value fcn_val = fh->fcn_val ();
+
+      if (fcn_val.is_defined () && fcn_val.function_value (true) != target)
+        return octave_value ();
+    }
+
+  return retval;
+}
+
+// If FCN is an anonymous function of the form @(x) x(i, j, ...) whose
+// indices are all constants, return the name of X and store the
+// indices in IDX.  Otherwise, return an empty string.
+
+static std::string
+anonymous_fcn_const_index (const octave_value& fcn, octave_value_list& idx)
+{
+  if (! fcn.is_function_handle ())
+    return "";
+
+  tree_index_expression *idx_expr = nullptr;
+
+  std::string param = anonymous_fcn_index_expr (fcn, idx_expr);
+
+  if (param.empty () || idx_expr->expression ()->name () != param)
+    return "";
+
+  tree_argument_list *arg_list = idx_expr->arg_lists ().front ();
+
+  octave_value_list retval;
+
+  for (tree_expression *elt : *arg_list)
+    {
+      if (! elt || ! elt->is_constant ())
+        return "";
+
+      retval.append (dynamic_cast<tree_constant *> (elt)->value ());
+    }
+
+  idx = retval;
+
+  return param;
+}
+
+// Return TRUE if any element of ARGS is an object whose class may
+// overload the built-in operations.
+
+static bool
+any_object (const octave_value *args, octave_idx_type n)
+{
+  for (octave_idx_type i = 0; i < n; i++)
+    {
+      if (args[i].isobject () || args[i].is_classdef_object ()
+          || args[i].isjava ())
+        return true;
+    }
+
+  return false;
+}
+
+// Return TRUE if indexing any element of ARGS may do more than extract
+// elements.  Objects may overload indexing, and indexing a function
+// handle or inline function calls it.
+
+static bool
+any_indexing_call (const octave_value *args, octave_idx_type n)
+{
+  if (any_object (args, n))
+    return true;
+
+  for (octave_idx_type i = 0; i < n; i++)
+    {
+      if (args[i].is_function_handle () || args[i].is_inline_function ())
+        return true;
+    }
+
+  return false;
+}
+
+static octave_value
+index_elem (octave_value val, const octave_value_list& idx,
+            const std::string& var)
+{
+  try
+    {
+      return val.index_op (idx);
+    }
+  catch (index_exception& ie)
+    {
+      ie.set_var (var);
+
+      std::string msg = ie.message ();
+
+      error_with_id (ie.err_id (), "%s", msg.c_str ());
+    }
+}
+
 static void
 get_mapper_fun_options (symbol_table& symtab,
                         const octave_value_list& args,
@@ -457,10 +671,61 @@ v = cellfun (@@det, C);         # 40% faster
   {
     if (fcn.is_function_handle () || fcn.is_inline_function ())
       {
-        // FIXME: instead of checking for overloaded functions as we did
-        // previously but is no longer possible, we could check whether
-        // the types of all the cell array elements are the same, then
-        // lookup the function for that type just once.
+        // A handle to a built-in function, or an anonymous function
+        // that only calls one, can be resolved once for all elements
+        // if they are not objects and each class of elements
+        // dispatches to the same function.
+
+        if (nargin == 1 && nargout <= 1 && fcn.is_function_handle ()
+            && args(1).iscell ())
+          {
+            const Cell f_args = args(1).cell_value ();
+
+            octave_idx_type n = f_args.numel ();
+
+            if (n == 0 || any_object (f_args.data (), n))
+              goto nevermind;
+
+            octave_value f
+              = builtin_fcn_handle_target (symtab, fcn, ovl (f_args(0)));
+
+            std::string elt_class = f_args(0).class_name ();
+
+            for (octave_idx_type i = 1; f.is_defined () && i < n; i++)
+              {
+                if (f_args(i).class_name () == elt_class)
+                  continue;
+
+                elt_class = f_args(i).class_name ();
+
+                octave_value g
+                  = builtin_fcn_handle_target (symtab, fcn, ovl (f_args(i)));
+
+                if (g.is_undefined ()
+                    || g.function_value (true) != f.function_value (true))
+                  f = octave_value ();
+              }
+
+            if (f.is_undefined ())
+              goto nevermind;
+
+            std::string name = f.function_value (true)->name ();
+
+            if (name != "size" && name != "class")
+              {
+                octave_value_list tmp_args = ovl (name, args(1));
+
+                if (uniform_output)
+                  retval = try_cellfun_internal_ops<boolNDArray, NDArray> (tmp_args, 2);
+                else
+                  retval = try_cellfun_internal_ops<Cell, Cell> (tmp_args, 2);
+
+                if (! retval.empty ())
+                  return retval;
+              }
+
+            fcn = f;
+          }
 
         goto nevermind;
       }
@@ -494,6 +759,21 @@ v = cellfun (@@det, C);         # 40% faster
 
 nevermind:
 
+  // Anonymous functions of the form @(x) x(1) are applied by indexing
+  // each element directly.
+
+  octave_value_list const_idx;
+  std::string const_idx_var;
+
+  if (nargin == 1 && nargout <= 1 && error_handler.is_undefined ()
+      && args(1).iscell ())
+    {
+      const Cell f_args = args(1).cell_value ();
+
+      if (! any_indexing_call (f_args.data (), f_args.numel ()))
+        const_idx_var = anonymous_fcn_const_index (fcn, const_idx);
+    }
+
   // Extract cell arguments.
 
   octave_value_list inputlist (nargin, octave_value ());
@@ -556,8 +836,10 @@ nevermind:
             }
 
           const octave_value_list tmp
-            = get_output_list (interp, count, nargout, inputlist, fcn,
-                               error_handler);
+            = (const_idx_var.empty ()
+               ? get_output_list (interp, count, nargout, inputlist, fcn,
+                                  error_handler)
+               : ovl (index_elem (inputlist(0), const_idx, const_idx_var)));
 
           int tmp_numel = tmp.length ();
           if (count == 0)
@@ -642,8 +924,10 @@ nevermind:
             }
 
           const octave_value_list tmp
-            = get_output_list (interp, count, nargout, inputlist, fcn,
-                               error_handler);
+            = (const_idx_var.empty ()
+               ? get_output_list (interp, count, nargout, inputlist, fcn,
+                                  error_handler)
+               : ovl (index_elem (inputlist(0), const_idx, const_idx_var)));
 
           if (nargout > 0 && tmp.length () < nargout)
             error ("cellfun: function returned fewer than nargout values");
@@ -1044,6 +1328,19 @@ nevermind:
 %!         [1, 2, NaN]);
 %! assert (! isempty (__errmsg));
 %! clear -global __errmsg;
+
+## Handles to built-in functions and simple anonymous functions
+%!assert (cellfun (@isempty, {[], 1, "", {}}), [true, false, true, true])
+%!assert (cellfun (@numel, {1:3, [], "ab"}), [3, 0, 2])
+%!assert (cellfun (@(x) numel (x), {1:3, [], "ab"}), [3, 0, 2])
+%!assert (cellfun (@ndims, {ones(2,2,2), 1}, "UniformOutput", false), {3, 2})
+%!assert (cellfun (@(x) x(1), {[5, 6], "ab", {7}}, "UniformOutput", false),
+%!        {5, "a", {7}})
+%!assert (cellfun (@(x) x(2), {[5, 6], int8([1, 2])}), [6, 2])
+%!assert (cellfun (@(x) x(end), {[5, 6], [1, 2]}), [6, 2])
+%!error <x\(2\): out of bound 1> cellfun (@(x) x(2), {[5, 6], 7})
+%!assert (cellfun (@(f) f(2), {@sqrt, @exp}), [sqrt(2), exp(2)])
+%!assert (cellfun (@(f) f(4), {@sqrt, [1, 2, 3, 5]}), [2, 5])
 */
 
 // Arrayfun was originally a .m file written by Bill Denney and Jaroslav
@@ -1274,6 +1571,25 @@ arrayfun (@@str2num, [1234],
             }
         }
 
+      // An element of an array that is not an object has the class of
+      // the array, so a handle to a built-in function, or an anonymous
+      // function that only calls one, can be resolved once for all
+      // elements.
+
+      if (fcn.is_function_handle () && ! any_object (inputs, nargin))
+        {
+          octave_value_list dispatch_args (nargin, octave_value ());
+
+          for (int j = 0; j < nargin; j++)
+            dispatch_args(j) = inputs[j];
+
+          octave_value f
+            = builtin_fcn_handle_target (symtab, fcn, dispatch_args);
+
+          if (f.is_defined ())
+            fcn = f;
+        }
+
       // Apply functions.
 
       if (uniform_output)
@@ -1668,6 +1984,13 @@ arrayfun (@@str2num, [1234],
 %! assert ([(isempty (A(1).message)), (isempty (A(2).message))],
 %!         [false, false]);
 %! assert ([A(1).index, A(2).index], [1, 2]);
+
+## Handles to built-in functions and simple anonymous functions
+%!assert (arrayfun (@abs, [-1, 2, -3]), [1, 2, 3])
+%!assert (arrayfun (@(x) abs (x), int8 ([-1, 2, -3])), int8 ([1, 2, 3]))
+%!assert (arrayfun (@numel, {1:3, []}), [1, 1])
+%!assert (arrayfun (@max, [1, 5], [4, 2]), [4, 5])
+%!error arrayfun (@(x) abs (x), [1, 2], [3, 4])
 */
 
 static void
@@ -65,6 +65,15 @@ The size of the result is @code{max (size (A) - size (B) + 1, 0)}.
 When the third argument is a matrix, return the convolution of the matrix
 @var{m} by the vector @var{v1} in the column direction and by the vector
 @var{v2} in the row direction.
+
+Small convolutions are computed directly, with the columns of the result
+distributed among threads.  For large arrays and kernels, @code{conv2} may
+instead use FFTs of the whole arrays, or FFTs of blocks of @var{A}
+(overlap-add), whichever takes the fewest operations.  The results of the
+FFT methods are accurate to round-off.  When all elements of both @var{A}
+and @var{B} are integers, or when either contains @code{Inf} or @code{NaN}
+values, the convolution is always computed directly, so that integer inputs
+give exact results.
 @seealso{conv, convn}
 @end deftypefn */)
 {
@@ -300,6 +309,52 @@ When the third argument is a matrix, return the convolution of the matrix
 %! B = conv2 (x, y, "valid");
 %! assert (B, A);   # Yes, this test is for *exact* equivalence.
 
+## Test the FFT methods against direct summation
+%!shared A, B, C
+%! old_state = rand ("state");
+%! restore_state = onCleanup (@() rand ("state", old_state));
+%! rand ("state", 42);
+%! A = rand (200, 150);
+%! B = rand (30, 20);
+%! C = zeros (size (A) + size (B) - 1);
+%! for j = 1:columns (B)
+%!   for i = 1:rows (B)
+%!     C(i:i+199, j:j+149) += B(i,j) * A;
+%!   endfor
+%! endfor
+%!assert (conv2 (A, B), C, -1e-12)
+%!assert (conv2 (A, B, "same"), C(16:215,11:160), -1e-12)
+%!assert (conv2 (A, B, "valid"), C(30:200,20:150), -1e-12)
+%!assert (conv2 (single (A), single (B)), single (C), -1e-5)
+%!assert (conv2 (A + 2i*A, B), (1 + 2i) * C, -1e-12)
+
+%!test
+%! x = repmat ([1, 2, 3], 1, 20000);
+%! y = ones (1, 500) / 4;
+%! c = conv2 (x, y);
+%! assert (size (c), [1, 60499]);
+%! assert (c(500:end-499), repmat ([999, 1001, 1000] / 4, 1, 19834)(1:59501),
+%!         -1e-12);
+
+## Integer-valued inputs give exact results, even when large
+%!assert (all (conv2 (ones (300), ones (25), "valid")(:) == 625))
+%!test
+%! mask = double (rand (400) > 0.5);
+%! c = conv2 (mask, ones (31), "same");
+%! assert (c, round (c));
+%! assert (c(200,200), sum (mask(185:215,185:215)(:)));
+%!assert (conv2 (1i * ones (300), ones (25), "valid"), 625i * ones (276))
+
+## NaN values stay local
+%!test
+%! A = rand (200, 150);
+%! A(50, 60) = NaN;
+%! C = conv2 (A, ones (30, 20));
+%! assert (nnz (isnan (C)), 600);
+
+## Clear shared variables so they are not reported for tests below
+%!shared
+
 ## Test input validation
 %!error conv2 ()
 %!error conv2 (1)
@@ -333,6 +388,9 @@ Return only the parts which do not include zero-padded edges.
 The size of the result is @code{max (size (A) - size (B) + 1, 0)}.
 @end table
 
+As for @code{conv2}, the algorithm (direct, FFT, or overlap-add FFT) is
+chosen from the sizes of @var{A} and @var{B}, and integer-valued inputs are
+always convolved directly.
 @seealso{conv2, conv}
 @end deftypefn */)
 {
@@ -59,9 +59,6 @@ static octave_value daspk_jac;
 static bool warned_fcn_imaginary = false;
 static bool warned_jac_imaginary = false;
 
-// Is this a recursive call?
-static int call_depth = 0;
-
 static ColumnVector
 daspk_user_function (const ColumnVector& x, const ColumnVector& xdot,
                      double t, octave_idx_type& ires)
@@ -270,22 +267,18 @@ parameters for @code{daspk}.
   if (nargin < 4 || nargin > 5)
     print_usage ();
 
-  warned_fcn_imaginary = false;
-  warned_jac_imaginary = false;
-
   octave_value_list retval (4);
 
-  unwind_protect_var<int> restore_var (call_depth);
-  call_depth++;
+  // Save the functions of an outer call, if any, so that the user
+  // functions may themselves call daspk.
 
-  if (call_depth > 1)
-    error ("daspk: invalid recursive call");
+  unwind_protect_var<octave_value> restore_fcn (daspk_fcn, octave_value ());
+  unwind_protect_var<octave_value> restore_jac (daspk_jac, octave_value ());
+  unwind_protect_var<bool> restore_warned_fcn (warned_fcn_imaginary, false);
+  unwind_protect_var<bool> restore_warned_jac (warned_jac_imaginary, false);
 
   std::string fcn_name, fname, jac_name, jname;
 
-  daspk_fcn = octave_value ();
-  daspk_jac = octave_value ();
-
   octave_value f_arg = args(0);
 
   std::list<std::string> fcn_param_names ({"x", "xdot", "t"});
@@ -408,4 +401,23 @@ parameters for @code{daspk}.
   return retval;
 }
 
+/*
+## Call daspk from the residual and Jacobian functions of daspk.  Only the
+## outer call has a Jacobian, and the inner calls have different numbers
+## of equations, so DDASPK must not keep values derived from the options
+## of another call.
+%!function res = __f_nested (x, xdot, t)
+%!  y = daspk (@(y, ydot, s) ydot - [1; 2; 3], zeros (3, 1), [1; 2; 3], [0; 1]);
+%!  res = xdot + y(end,2) * x;
+%!endfunction
+%!function jac = __jac_nested (x, xdot, t, cj)
+%!  y = daspk (@(y, ydot, s) ydot - 2, 0, 2, [0; 1]);
+%!  jac = (y(end) + cj) * eye (2);
+%!endfunction
+%!test
+%! t = [0; 0.5; 1];
+%! x = daspk ({"__f_nested", "__jac_nested"}, [1; 3], [-2; -6], t);
+%! assert (x, exp (-2 * t) * [1, 3], 1e-4);
+*/
+
 OCTAVE_END_NAMESPACE(octave)
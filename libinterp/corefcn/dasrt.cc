@@ -60,9 +60,6 @@ static bool warned_fcn_imaginary = false;
 static bool warned_jac_imaginary = false;
 static bool warned_cf_imaginary = false;
 
-// Is this a recursive call?
-static int call_depth = 0;
-
 static ColumnVector
 dasrt_user_f (const ColumnVector& x, const ColumnVector& xdot,
               double t, octave_idx_type&)
@@ -350,25 +347,21 @@ parameters for @code{dasrt}.
   if (nargin < 4 || nargin > 6)
     print_usage ();
 
-  warned_fcn_imaginary = false;
-  warned_jac_imaginary = false;
-  warned_cf_imaginary = false;
-
   octave_value_list retval (5);
 
-  unwind_protect_var<int> restore_var (call_depth);
-  call_depth++;
+  // Save the functions of an outer call, if any, so that the user
+  // functions may themselves call dasrt.
 
-  if (call_depth > 1)
-    error ("dasrt: invalid recursive call");
+  unwind_protect_var<octave_value> restore_fcn (dasrt_fcn, octave_value ());
+  unwind_protect_var<octave_value> restore_jac (dasrt_jac, octave_value ());
+  unwind_protect_var<octave_value> restore_cf (dasrt_cf, octave_value ());
+  unwind_protect_var<bool> restore_warned_fcn (warned_fcn_imaginary, false);
+  unwind_protect_var<bool> restore_warned_jac (warned_jac_imaginary, false);
+  unwind_protect_var<bool> restore_warned_cf (warned_cf_imaginary, false);
 
   int argp = 0;
   std::string fcn_name, fname, jac_name, jname;
 
-  dasrt_fcn = octave_value ();
-  dasrt_jac = octave_value ();
-  dasrt_cf = octave_value ();
-
   // Check all the arguments.  Are they the right animals?
 
   // Here's where I take care of f and j in one shot:
@@ -528,4 +521,19 @@ parameters for @code{dasrt}.
   return retval;
 }
 
+/*
+## Call dasrt from the constraint function of dasrt.  The root of the
+## inner constraint function, which has two components, gives the value
+## at which the outer constraint function of one component has its root.
+%!function g = __g_nested (x, t)
+%!  [~, ~, t_y] = dasrt (@(y, ydot, s) ydot - 1, @(y, s) [y - 0.5; y - 2],
+%!                       0, 1, [0; 1]);
+%!  g = x - t_y(end);
+%!endfunction
+%!test
+%! [x, ~, t] = dasrt (@(x, xdot, t) xdot + 2*x, "__g_nested", 1, -2, [0; 1]);
+%! assert (t(end), log (2) / 2, 1e-4);
+%! assert (x(end), 0.5, 1e-4);
+*/
+
 OCTAVE_END_NAMESPACE(octave)
@@ -58,9 +58,6 @@ static octave_value dassl_jac;
 static bool warned_fcn_imaginary = false;
 static bool warned_jac_imaginary = false;
 
-// Is this a recursive call?
-static int call_depth = 0;
-
 static ColumnVector
 dassl_user_function (const ColumnVector& x, const ColumnVector& xdot,
                      double t, octave_idx_type& ires)
@@ -270,22 +267,18 @@ parameters for @code{dassl}.
   if (nargin < 4 || nargin > 5)
     print_usage ();
 
-  warned_fcn_imaginary = false;
-  warned_jac_imaginary = false;
-
   octave_value_list retval (4);
 
-  unwind_protect_var<int> restore_var (call_depth);
-  call_depth++;
+  // Save the functions of an outer call, if any, so that the user
+  // functions may themselves call dassl.
 
-  if (call_depth > 1)
-    error ("dassl: invalid recursive call");
+  unwind_protect_var<octave_value> restore_fcn (dassl_fcn, octave_value ());
+  unwind_protect_var<octave_value> restore_jac (dassl_jac, octave_value ());
+  unwind_protect_var<bool> restore_warned_fcn (warned_fcn_imaginary, false);
+  unwind_protect_var<bool> restore_warned_jac (warned_jac_imaginary, false);
 
   std::string fcn_name, fname, jac_name, jname;
 
-  dassl_fcn = octave_value ();
-  dassl_jac = octave_value ();
-
   octave_value f_arg = args(0);
 
   std::list<std::string> fcn_param_names ({"x", "xdot", "t"});
@@ -493,6 +486,23 @@ parameters for @code{dassl}.
 %! dassl_options ("absolute tolerance", old_tol);
 
 %!error dassl_options ("foo", 1, 2)
+
+## Call dassl from the residual and Jacobian functions of dassl.  The
+## inner calls differ from the outer one in the number of equations and
+## in whether they have a Jacobian, so the outer call fails if they replace
+## its functions.
+%!function res = __f_nested (x, xdot, t)
+%!  y = dassl ({@(y, ydot, s) ydot - 2, @(y, ydot, s, c) c}, 0, 2, [0; 1]);
+%!  res = xdot + y(end) * x;
+%!endfunction
+%!function jac = __jac_nested (x, xdot, t, cj)
+%!  y = dassl (@(y, ydot, s) ydot - [2; 4], [0; 0], [2; 4], [0; 1]);
+%!  jac = (y(end,1) + cj) * eye (2);
+%!endfunction
+%!test
+%! t = [0; 0.5; 1];
+%! x = dassl ({"__f_nested", "__jac_nested"}, [1; 3], [-2; -6], t);
+%! assert (x, exp (-2 * t) * [1, 3], 1e-4);
 */
 
 OCTAVE_END_NAMESPACE(octave)
@@ -34,12 +34,15 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <string>
 
 #include "lo-ieee.h"
 #include "mx-base.h"
+#include "mx-inlines.cc"
 #include "oct-base64.h"
 #include "oct-binmap.h"
+#include "oct-parallel.h"
 #include "oct-time.h"
 #include "quit.h"
 
@@ -2583,6 +2586,31 @@ returns the original array @var{A}.
   return do_permute (args, true);
 }
 
+/*
+## Large arrays use the blocked and multithreaded code paths
+%!test
+%! x = reshape (1:(65*67*31*3), [65, 67, 31, 3]);
+%! for p = {[2, 1, 3, 4], [3, 2, 1, 4], [4, 3, 2, 1], [2, 3, 4, 1]}
+%!   y = permute (x, p{1});
+%!   assert (size (y), size (x)(p{1}));
+%!   assert (ipermute (y, p{1}), x);
+%! endfor
+%! y = permute (x, [2, 1, 3, 4]);
+%! assert (y(:,:,7,2), x(:,:,7,2).');
+
+%!test
+%! x = int8 (mod (reshape (1:(130*70*40), [130, 70, 40]), 256) - 128);
+%! y = permute (x, [3, 1, 2]);
+%! assert (class (y), "int8");
+%! assert (squeeze (y(:,5,9)), squeeze (x(5,9,:)));
+%! assert (ipermute (y, [3, 1, 2]), x);
+
+%!test
+%! x = mod (reshape (1:(700*500), [700, 500]), 3) == 0;
+%! assert (x.', permute (x, [2, 1]));
+%! assert (x.'(17,:), x(:,17).');
+*/
+
 DEFUN (length, args, ,
        doc: /* -*- texinfo -*-
 @deftypefn {} {@var{n} =} length (@var{A})
@@ -7664,29 +7692,364 @@ the ratio K/M is small; otherwise, it may be better to use @code{sort}.
 %!error nth_element ("abcd", 3)
 */
 
-template <typename NDT>
-static NDT
-do_accumarray_sum (const idx_vector& idx, const NDT& vals,
-                   octave_idx_type n = -1)
+// Grouped reductions for accumarray.
+//
+// Each reduction is described by a class with the type of the values it
+// reduces (value_type), of the partial result it keeps for each group
+// (state_type), and of the final result (result_type).  The values are
+// split into contiguous chunks that are reduced in parallel, each into
+// its own array of partial results, which are merged group by group at
+// the end.  Chunks are only used if there are many more values than
+// groups, so that the partial results stay small.
+
+static const octave_idx_type accum_max_chunks = 16;
+static const octave_idx_type accum_chunk_len = 65536;
+static const octave_idx_type accum_slab_len = 1048576;
+static const octave_idx_type accum_merge_grain = 4096;
+
+static octave_idx_type
+accum_num_chunks (octave_idx_type len, octave_idx_type n)
+{
+#if defined (HAVE_OPENMP)
+  octave_idx_type nc = len / std::max (accum_chunk_len, 4 * n);
+  return std::max (static_cast<octave_idx_type> (1),
+                   std::min (nc, accum_max_chunks));
+#else
+  octave_unused_parameter (len);
+  octave_unused_parameter (n);
+
+  return 1;
+#endif
+}
+
+template <typename OP>
+static Array<typename OP::result_type>
+do_accum_reduce (const OP& op, const idx_vector& idx_arg,
+                 const Array<typename OP::value_type>& vals,
+                 octave_idx_type n)
 {
-  typedef typename NDT::element_type T;
+  typedef typename OP::value_type T;
+  typedef typename OP::state_type S;
+  typedef typename OP::result_type R;
+
+  idx_vector idx = idx_arg;
+
   if (n < 0)
     n = idx.extent (0);
   else if (idx.extent (n) > n)
     error ("accumarray: index out of range");
 
-  NDT retval (dim_vector (n, 1), T ());
+  octave_idx_type len = idx.length (n);
 
-  if (vals.numel () == 1)
-    retval.idx_add (idx, vals (0));
-  else if (vals.numel () == idx.length (n))
-    retval.idx_add (idx, vals);
-  else
+  if (vals.numel () != 1 && vals.numel () != len)
     error ("accumarray: dimensions mismatch");
 
+  const octave_idx_type *ip = (len > 0 ? idx.raw () : nullptr);
+
+  // A scalar value is used for all subscripts.
+  const T *vp = vals.data ();
+  octave_idx_type vstride = (vals.numel () == 1 ? 0 : 1);
+
+  octave_idx_type nc = accum_num_chunks (len, n);
+
+  // Not std::vector, because std::vector<bool> can't be written
+  // concurrently.
+  std::unique_ptr<S[]> part (new S [nc * n]);
+  std::fill_n (part.get (), nc * n, op.init ());
+
+  // Process the values in slabs so that interrupts are checked
+  // regularly.  Each chunk of a slab updates its own partial results.
+
+  for (octave_idx_type beg = 0; beg < len; beg += nc * accum_slab_len)
+    {
+      octave_idx_type end = std::min (len, beg + nc * accum_slab_len);
+      octave_idx_type clen = (end - beg + nc - 1) / nc;
+
+      parallel_for (nc, 1, [&] (octave_idx_type lo, octave_idx_type hi)
+      {
+        for (octave_idx_type c = lo; c < hi; c++)
+          {
+            S *acc = part.get () + c * n;
+
+            octave_idx_type i_end = std::min (end, beg + (c+1) * clen);
+
+            for (octave_idx_type i = beg + c * clen; i < i_end; i++)
+              op.add (acc[ip[i]], vp[i * vstride]);
+          }
+      });
+    }
+
+  Array<R> retval (dim_vector (n, 1));
+  R *rp = retval.rwdata ();
+
+  parallel_for (n, accum_merge_grain,
+                [&] (octave_idx_type lo, octave_idx_type hi)
+  {
+    for (octave_idx_type g = lo; g < hi; g++)
+      {
+        S st = part[g];
+
+        for (octave_idx_type c = 1; c < nc; c++)
+          op.merge (st, part[c * n + g]);
+
+        rp[g] = op.result (st);
+      }
+  });
+
   return retval;
 }
 
+template <typename T>
+class accum_sum
+{
+public:
+
+  typedef T value_type;
+  typedef T state_type;
+  typedef T result_type;
+
+  T init () const { return T (); }
+
+  void add (T& st, const T& x) const { st += x; }
+
+  void merge (T& st, const T& other) const { st += other; }
+
+  T result (const T& st) const { return st; }
+};
+
+template <typename T>
+class accum_minmax
+{
+public:
+
+  typedef T value_type;
+  typedef T state_type;
+  typedef T result_type;
+
+  accum_minmax (bool ismin, const T& zero_val)
+    : m_ismin (ismin), m_zero_val (zero_val)
+  { }
+
+  T init () const { return m_zero_val; }
+
+  void add (T& st, const T& x) const
+  {
+    st = (m_ismin ? math::min (st, x) : math::max (st, x));
+  }
+
+  void merge (T& st, const T& other) const { add (st, other); }
+
+  T result (const T& st) const { return st; }
+
+private:
+
+  bool m_ismin;
+  T m_zero_val;
+};
+
+// Partial result of a reduction that needs the number of values in the
+// group.  Groups without values are zero in the result.
+
+template <typename T>
+struct accum_counted
+{
+  T m_val;
+  octave_idx_type m_count;
+};
+
+template <typename T>
+class accum_prod
+{
+public:
+
+  typedef T value_type;
+  typedef accum_counted<T> state_type;
+  typedef T result_type;
+
+  state_type init () const { return { T (1), 0 }; }
+
+  void add (state_type& st, const T& x) const
+  {
+    st.m_val *= x;
+    st.m_count++;
+  }
+
+  void merge (state_type& st, const state_type& other) const
+  {
+    st.m_val *= other.m_val;
+    st.m_count += other.m_count;
+  }
+
+  T result (const state_type& st) const
+  {
+    return (st.m_count > 0 ? st.m_val : T ());
+  }
+};
+
+template <typename T>
+class accum_mean
+{
+public:
+
+  typedef T value_type;
+  typedef accum_counted<T> state_type;
+  typedef T result_type;
+
+  state_type init () const { return { T (), 0 }; }
+
+  void add (state_type& st, const T& x) const
+  {
+    st.m_val += x;
+    st.m_count++;
+  }
+
+  void merge (state_type& st, const state_type& other) const
+  {
+    st.m_val += other.m_val;
+    st.m_count += other.m_count;
+  }
+
+  T result (const state_type& st) const
+  {
+    return (st.m_count > 0 ? st.m_val / T (st.m_count) : T ());
+  }
+};
+
+template <typename T>
+class accum_count
+{
+public:
+
+  typedef T value_type;
+  typedef octave_idx_type state_type;
+  typedef double result_type;
+
+  octave_idx_type init () const { return 0; }
+
+  void add (octave_idx_type& st, const T&) const { st++; }
+
+  void merge (octave_idx_type& st, octave_idx_type other) const
+  {
+    st += other;
+  }
+
+  double result (octave_idx_type st) const { return st; }
+};
+
+template <typename T>
+class accum_any
+{
+public:
+
+  typedef T value_type;
+  typedef bool state_type;
+  typedef bool result_type;
+
+  bool init () const { return false; }
+
+  void add (bool& st, const T& x) const { st = st || xis_true (x); }
+
+  void merge (bool& st, bool other) const { st = st || other; }
+
+  bool result (bool st) const { return st; }
+};
+
+template <typename T>
+class accum_all
+{
+public:
+
+  typedef T value_type;
+  typedef accum_counted<bool> state_type;
+  typedef bool result_type;
+
+  state_type init () const { return { true, 0 }; }
+
+  void add (state_type& st, const T& x) const
+  {
+    st.m_val = st.m_val && ! xis_false (x);
+    st.m_count++;
+  }
+
+  void merge (state_type& st, const state_type& other) const
+  {
+    st.m_val = st.m_val && other.m_val;
+    st.m_count += other.m_count;
+  }
+
+  bool result (const state_type& st) const
+  {
+    return st.m_count > 0 && st.m_val;
+  }
+};
+
+// Standard deviation normalized by N-1, computed with Welford's update
+// and merged with the formula of Chan, Golub, and LeVeque.  R is the
+// real type of T.
+
+template <typename T, typename R>
+struct accum_moments
+{
+  T m_mean;
+  R m_m2;
+  octave_idx_type m_count;
+};
+
+template <typename T, typename R>
+class accum_std
+{
+public:
+
+  typedef T value_type;
+  typedef accum_moments<T, R> state_type;
+  typedef R result_type;
+
+  state_type init () const { return { T (), R (), 0 }; }
+
+  void add (state_type& st, const T& x) const
+  {
+    st.m_count++;
+    T delta = x - st.m_mean;
+    st.m_mean += delta / T (st.m_count);
+    st.m_m2 += std::real (math::conj (delta) * (x - st.m_mean));
+  }
+
+  void merge (state_type& st, const state_type& other) const
+  {
+    if (other.m_count == 0)
+      return;
+
+    if (st.m_count == 0)
+      {
+        st = other;
+        return;
+      }
+
+    octave_idx_type count = st.m_count + other.m_count;
+    T delta = other.m_mean - st.m_mean;
+    R frac = R (other.m_count) / R (count);
+
+    st.m_mean += delta * frac;
+    st.m_m2 += other.m_m2 + std::norm (delta) * R (st.m_count) * frac;
+    st.m_count = count;
+  }
+
+  R result (const state_type& st) const
+  {
+    return (st.m_count > 1 ? std::sqrt (st.m_m2 / R (st.m_count - 1)) : R ());
+  }
+};
+
+template <typename NDT>
+static NDT
+do_accumarray_sum (const idx_vector& idx, const NDT& vals,
+                   octave_idx_type n = -1)
+{
+  typedef typename NDT::element_type T;
+
+  return do_accum_reduce (accum_sum<T> (), idx, vals, n);
+}
+
 DEFUN (__accumarray_sum__, args, ,
        doc: /* -*- texinfo -*-
 @deftypefn {} {} __accumarray_sum__ (@var{idx}, @var{vals}, @var{n})
@@ -7755,26 +8118,8 @@ do_accumarray_minmax (const idx_vector& idx, const NDT& vals,
                       const typename NDT::element_type& zero_val)
 {
   typedef typename NDT::element_type T;
-  if (n < 0)
-    n = idx.extent (0);
-  else if (idx.extent (n) > n)
-    error ("accumarray: index out of range");
-
-  NDT retval (dim_vector (n, 1), zero_val);
-
-  // Pick minimizer or maximizer.
-  void (MArray<T>::*op) (const idx_vector&, const MArray<T>&)
-    = ismin ? (&MArray<T>::idx_min) : (&MArray<T>::idx_max);
-
-  octave_idx_type l = idx.length (n);
-  if (vals.numel () == 1)
-    (retval.*op) (idx, NDT (dim_vector (l, 1), vals(0)));
-  else if (vals.numel () == l)
-    (retval.*op) (idx, vals);
-  else
-    error ("accumarray: dimensions mismatch");
 
-  return retval;
+  return do_accum_reduce (accum_minmax<T> (ismin, zero_val), idx, vals, n);
 }
 
 static octave_value_list
@@ -7877,12 +8222,179 @@ Undocumented internal function.
   return do_accumarray_minmax_fcn (args, false);
 }
 
+template <template <typename> class OP>
+static octave_value
+do_accumarray_reduce_float (const idx_vector& idx, const octave_value& vals,
+                            octave_idx_type n)
+{
+  if (vals.is_single_type ())
+    {
+      if (vals.iscomplex ())
+        return do_accum_reduce (OP<FloatComplex> (), idx,
+                                vals.float_complex_array_value (), n);
+      else
+        return do_accum_reduce (OP<float> (), idx,
+                                vals.float_array_value (), n);
+    }
+  else if (vals.isfloat () || vals.islogical ())
+    {
+      if (vals.iscomplex ())
+        return do_accum_reduce (OP<Complex> (), idx,
+                                vals.complex_array_value (), n);
+      else
+        return do_accum_reduce (OP<double> (), idx, vals.array_value (), n);
+    }
+  else
+    err_wrong_type_arg ("accumarray", vals);
+}
+
+template <typename T>
+using accum_std_real = accum_std<T, double>;
+
+template <typename T>
+using accum_std_float = accum_std<T, float>;
+
+static octave_value
+do_accumarray_std (const idx_vector& idx, const octave_value& vals,
+                   octave_idx_type n)
+{
+  if (vals.is_single_type ())
+    {
+      if (vals.iscomplex ())
+        return do_accum_reduce (accum_std_float<FloatComplex> (), idx,
+                                vals.float_complex_array_value (), n);
+      else
+        return do_accum_reduce (accum_std_float<float> (), idx,
+                                vals.float_array_value (), n);
+    }
+  else if (vals.isfloat () || vals.islogical ())
+    {
+      if (vals.iscomplex ())
+        return do_accum_reduce (accum_std_real<Complex> (), idx,
+                                vals.complex_array_value (), n);
+      else
+        return do_accum_reduce (accum_std_real<double> (), idx,
+                                vals.array_value (), n);
+    }
+  else
+    err_wrong_type_arg ("accumarray", vals);
+}
+
+template <template <typename> class OP>
+static octave_value
+do_accumarray_reduce_any (const idx_vector& idx, const octave_value& vals,
+                          octave_idx_type n)
+{
+  switch (vals.builtin_type ())
+    {
+    case btyp_double:
+      return do_accum_reduce (OP<double> (), idx, vals.array_value (), n);
+
+    case btyp_float:
+      return do_accum_reduce (OP<float> (), idx, vals.float_array_value (),
+                              n);
+
+    case btyp_complex:
+      return do_accum_reduce (OP<Complex> (), idx,
+                              vals.complex_array_value (), n);
+
+    case btyp_float_complex:
+      return do_accum_reduce (OP<FloatComplex> (), idx,
+                              vals.float_complex_array_value (), n);
+
+#define MAKE_INT_BRANCH(X)                                              \
+    case btyp_ ## X:                                                    \
+      return do_accum_reduce (OP<X ## NDArray::element_type> (), idx,   \
+                              vals.X ## _array_value (), n);
+
+      MAKE_INT_BRANCH (int8);
+      MAKE_INT_BRANCH (int16);
+      MAKE_INT_BRANCH (int32);
+      MAKE_INT_BRANCH (int64);
+      MAKE_INT_BRANCH (uint8);
+      MAKE_INT_BRANCH (uint16);
+      MAKE_INT_BRANCH (uint32);
+      MAKE_INT_BRANCH (uint64);
+
+#undef MAKE_INT_BRANCH
+
+    case btyp_bool:
+      return do_accum_reduce (OP<bool> (), idx, vals.bool_array_value (), n);
+
+    default:
+      err_wrong_type_arg ("accumarray", vals);
+    }
+}
+
+DEFUN (__accumarray_reduce__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} __accumarray_reduce__ (@var{idx}, @var{vals}, @var{op}, @var{n})
+Undocumented internal function.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 3 || nargin > 4)
+    print_usage ();
+
+  if (! args(0).isnumeric ())
+    error ("__accumarray_reduce__: first argument must be numeric");
+
+  std::string op = args(2).xstring_value ("__accumarray_reduce__: OP must be a string");
+
+  octave_value retval;
+
+  try
+    {
+      idx_vector idx = args(0).index_vector ();
+      octave_idx_type n = -1;
+      if (nargin == 4)
+        n = args(3).idx_type_value (true);
+
+      octave_value vals = args(1);
+
+      if (op == "sum")
+        retval = do_accumarray_reduce_float<accum_sum> (idx, vals, n);
+      else if (op == "prod")
+        retval = do_accumarray_reduce_float<accum_prod> (idx, vals, n);
+      else if (op == "mean")
+        retval = do_accumarray_reduce_float<accum_mean> (idx, vals, n);
+      else if (op == "std")
+        retval = do_accumarray_std (idx, vals, n);
+      else if (op == "count")
+        {
+          // Only the number of values matters.
+          if (vals.numel () != 1 && vals.numel () != idx.length (n))
+            error ("accumarray: dimensions mismatch");
+
+          retval = do_accum_reduce (accum_count<double> (), idx,
+                                    NDArray (dim_vector (1, 1), 0.0), n);
+        }
+      else if (op == "any")
+        retval = do_accumarray_reduce_any<accum_any> (idx, vals, n);
+      else if (op == "all")
+        retval = do_accumarray_reduce_any<accum_all> (idx, vals, n);
+      else
+        error (R"(__accumarray_reduce__: unknown reduction "%s")",
+               op.c_str ());
+    }
+  catch (const index_exception& ie)
+    {
+      error ("__accumarray_reduce__: invalid index %s", ie.what ());
+    }
+
+  return retval;
+}
+
 template <typename NDT>
 static NDT
-do_accumdim_sum (const idx_vector& idx, const NDT& vals,
+do_accumdim_sum (const idx_vector& idx_arg, const NDT& vals,
                  int dim = -1, octave_idx_type n = -1)
 {
   typedef typename NDT::element_type T;
+
+  idx_vector idx = idx_arg;
+
   if (n < 0)
     n = idx.extent (0);
   else if (idx.extent (n) > n)
@@ -7896,14 +8408,65 @@ do_accumdim_sum (const idx_vector& idx, const NDT& vals,
   else if (dim >= rdv.ndims ())
     rdv.resize (dim+1, 1);
 
+  octave_idx_type ns = rdv(dim);
+
   rdv(dim) = n;
 
+  if (idx.length () != ns)
+    error ("accumdim: dimension mismatch");
+
+  // Sizes of the dimensions before and after DIM.
+  octave_idx_type l = 1;
+  octave_idx_type u = 1;
+  for (int k = 0; k < dim; k++)
+    l *= rdv(k);
+  for (int k = dim + 1; k < rdv.ndims (); k++)
+    u *= rdv(k);
+
+  if (l == 1 && u == 1)
+    return NDT (do_accumarray_sum (idx, vals, n).reshape (rdv));
+
   NDT retval (rdv, T ());
 
-  if (idx.length () != vals_dim(dim))
-    error ("accumdim: dimension mismatch");
+  if (ns == 0 || retval.isempty ())
+    return retval;
+
+  // The slices along the dimensions after DIM, and the columns of
+  // each slice in the dimensions before DIM, are independent.  Each
+  // task sums a range of columns of one slice.
+
+  const octave_idx_type col_len = std::min (l, accum_chunk_len);
+  const octave_idx_type n_col_chunks = (l + col_len - 1) / col_len;
+  const octave_idx_type grain
+    = std::max (static_cast<octave_idx_type> (1),
+                accum_chunk_len / (ns * col_len));
+
+  const octave_idx_type *ip = idx.raw ();
+  const T *src = vals.data ();
+  T *dst = retval.rwdata ();
 
-  retval.idx_add_nd (idx, vals, dim);
+  parallel_for (u * n_col_chunks, grain,
+                [&] (octave_idx_type lo, octave_idx_type hi)
+  {
+    for (octave_idx_type t = lo; t < hi; t++)
+      {
+        octave_idx_type j = t / n_col_chunks;
+        octave_idx_type k_beg = (t % n_col_chunks) * col_len;
+        octave_idx_type k_end = std::min (l, k_beg + col_len);
+
+        T *d = dst + j * l * n;
+        const T *s = src + j * l * ns;
+
+        for (octave_idx_type i = 0; i < ns; i++)
+          {
+            T *dk = d + l * ip[i];
+            const T *sk = s + l * i;
+
+            for (octave_idx_type k = k_beg; k < k_end; k++)
+              dk[k] += sk[k];
+          }
+      }
+  });
 
   return retval;
 }
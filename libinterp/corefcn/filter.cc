@@ -35,6 +35,10 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+
+#include "oct-locbuf.h"
+#include "oct-parallel.h"
 #include "quit.h"
 
 #include "defun.h"
@@ -43,6 +47,372 @@
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+// Number of interleaved channels that are filtered together.
+static const octave_idx_type FILTER_BLOCK = 64;
+
+// Minimum number of multiply-adds worth handing to a separate thread.
+static const double FILTER_MIN_THREAD_WORK = 65536;
+
+// Maximum number of multiply-adds of one task that is done in parallel
+// and therefore without checks for interrupts.
+static const double FILTER_MAX_PARALLEL_WORK = 1e7;
+
+// Maximum number of multiply-adds of the tasks done in parallel between
+// two checks for interrupts.
+static const double FILTER_MAX_ROUND_WORK = 2.5e8;
+
+// Filter the contiguous channel PX of length X_LEN with the normalized
+// coefficients PB and PA (if HAS_A) and the state PSI of length SI_LEN.
+
+template <typename T>
+static void
+filter_channel (const T *pb, const T *pa, bool has_a,
+                octave_idx_type si_len, const T *px, T *py,
+                octave_idx_type x_len, T *psi, bool interruptible)
+{
+  // Try to achieve a balance between speed and interruptibility.
+  //
+  // One extreme is to not check for interruptions at all, which gives
+  // good speed but the user cannot use Ctrl-C for the whole duration.
+  // The other end is to check frequently from inside an inner loop,
+  // which slows down performance by 5X or 6X.
+  //
+  // Putting any sort of check in an inner loop seems to prevent the
+  // compiler from optimizing the loop, so we cannot say "check for
+  // interruptions every M iterations" using an if-statement.
+  //
+  // This is a compromise approach to split the total numer of loop
+  // executions into num_outer and num_inner, to provide periodic checks
+  // for interruptions without writing a conditional inside a tight loop.
+  //
+  // To make it more interruptible and run more slowly, reduce num_inner.
+  // To speed it up but make it less interruptible, increase it.
+  // May need to increase it slowly over time as computers get faster.
+  // The aim is to not lose Ctrl-C ability for longer than about 2 seconds.
+  //
+  // In December 2021, num_inner = 100000 is acceptable.
+  //
+  // Channels that are filtered in parallel are not interruptible, since
+  // octave_quit may only be called from the main thread.
+
+  octave_idx_type num_execs = si_len-1; // 0 to num_execs-1
+  octave_idx_type num_inner = 100000;
+  octave_idx_type num_outer = num_execs / num_inner;
+
+  if (has_a)
+    {
+      // Usually the last element to be written will be si_len-1
+      // but if si_len is 0, then we need the 0th element to be written.
+      // Pulling this check out of the for-loop makes it run faster.
+      octave_idx_type iidx = (si_len > 0) ? si_len-1 : 0;
+
+      for (octave_idx_type i = 0; i < x_len; i++)
+        {
+          py[i] = psi[0] + pb[0] * px[i];
+
+          // Outer and inner loops for interruption management
+          for (octave_idx_type u = 0; u <= num_outer; u++)
+            {
+              octave_idx_type lo = u * num_inner;
+              octave_idx_type hi = (lo + num_inner < num_execs-1)
+                                   ? lo + num_inner : num_execs-1;
+
+              // Inner loop, no interruption
+              for (octave_idx_type j = lo; j <= hi; j++)
+                psi[j] = psi[j+1] - pa[j+1] * py[i] + pb[j+1] * px[i];
+
+              if (interruptible)
+                octave_quit ();  // Check for interruptions
+            }
+
+          psi[iidx] = pb[si_len] * px[i] - pa[si_len] * py[i];
+        }
+    }
+  else // ! has_a ==> si_len MUST be > 0
+    {
+      // This else-block is almost the same as the above if-block,
+      // except for the absence of variable pa.
+
+      for (octave_idx_type i = 0; i < x_len; i++)
+        {
+          py[i] = psi[0] + pb[0] * px[i];
+
+          // Outer and inner loops for interruption management
+          for (octave_idx_type u = 0; u <= num_outer; u++)
+            {
+              octave_idx_type lo = u * num_inner;
+              octave_idx_type hi = (lo + num_inner < num_execs-1)
+                                   ? lo + num_inner : num_execs-1;
+
+              // Inner loop, no interruption
+              for (octave_idx_type j = lo; j <= hi; j++)
+                psi[j] = psi[j+1] + pb[j+1] * px[i];
+
+              if (interruptible)
+                octave_quit ();  // Check for interruptions
+            }
+
+          psi[si_len-1] = pb[si_len] * px[i];
+        }
+    }
+}
+
+// Same as filter_channel, for a state vector of fixed length N.  The
+// coefficients and the state are kept in local variables, and the loop
+// over the state is unrolled by the compiler.  The operations are the
+// same as in filter_channel, so the results are identical.
+
+template <typename T, int N, bool HAS_A>
+static void
+filter_channel_fixed (const T *pb, const T *pa, const T *px, T *py,
+                      octave_idx_type x_len, T *psi, bool interruptible)
+{
+  T b[N+1], a[N+1], z[N];
+
+  for (int k = 0; k <= N; k++)
+    {
+      b[k] = pb[k];
+      a[k] = (HAS_A ? pa[k] : T (0));
+    }
+  for (int k = 0; k < N; k++)
+    z[k] = psi[k];
+
+  for (octave_idx_type i = 0; i < x_len; i++)
+    {
+      if (interruptible && (i & 0xffff) == 0)
+        octave_quit ();
+
+      T xi = px[i];
+      T yi = z[0] + b[0] * xi;
+      py[i] = yi;
+
+      for (int k = 0; k < N-1; k++)
+        {
+          if (HAS_A)
+            z[k] = z[k+1] - a[k+1] * yi + b[k+1] * xi;
+          else
+            z[k] = z[k+1] + b[k+1] * xi;
+        }
+
+      if (HAS_A)
+        z[N-1] = b[N] * xi - a[N] * yi;
+      else
+        z[N-1] = b[N] * xi;
+    }
+
+  for (int k = 0; k < N; k++)
+    psi[k] = z[k];
+}
+
+template <typename T, int N>
+static void
+filter_channel_fixed (const T *pb, const T *pa, bool has_a,
+                      const T *px, T *py, octave_idx_type x_len, T *psi,
+                      bool interruptible)
+{
+  if (has_a)
+    filter_channel_fixed<T, N, true> (pb, pa, px, py, x_len, psi,
+                                      interruptible);
+  else
+    filter_channel_fixed<T, N, false> (pb, pa, px, py, x_len, psi,
+                                       interruptible);
+}
+
+// Filter NC channels that are interleaved in memory: sample I of
+// channel C is PX[I*STRIDE + C], and its state is PSI[C*SI_LEN ...].
+// The states of all channels for one delay are kept next to each other
+// so that the loops over the channels can be vectorized.
+
+template <typename T>
+static void
+filter_interleaved (const T *pb, const T *pa, bool has_a,
+                    octave_idx_type si_len, const T *px, T *py,
+                    octave_idx_type x_len, octave_idx_type stride,
+                    T *psi, octave_idx_type nc, bool interruptible)
+{
+  OCTAVE_LOCAL_BUFFER (T, z, si_len * nc);
+
+  for (octave_idx_type c = 0; c < nc; c++)
+    for (octave_idx_type k = 0; k < si_len; k++)
+      z[k*nc + c] = psi[c*si_len + k];
+
+  for (octave_idx_type i = 0; i < x_len; i++)
+    {
+      if (interruptible && (i & 0xfff) == 0)
+        octave_quit ();
+
+      const T *xi = px + i*stride;
+      T *yi = py + i*stride;
+
+      for (octave_idx_type c = 0; c < nc; c++)
+        yi[c] = z[c] + pb[0] * xi[c];
+
+      for (octave_idx_type k = 0; k < si_len-1; k++)
+        {
+          T *zk = z + k*nc;
+          const T *zk1 = zk + nc;
+
+          if (has_a)
+            {
+              for (octave_idx_type c = 0; c < nc; c++)
+                zk[c] = zk1[c] - pa[k+1] * yi[c] + pb[k+1] * xi[c];
+            }
+          else
+            {
+              for (octave_idx_type c = 0; c < nc; c++)
+                zk[c] = zk1[c] + pb[k+1] * xi[c];
+            }
+        }
+
+      T *zl = z + (si_len-1)*nc;
+
+      if (has_a)
+        {
+          for (octave_idx_type c = 0; c < nc; c++)
+            zl[c] = pb[si_len] * xi[c] - pa[si_len] * yi[c];
+        }
+      else
+        {
+          for (octave_idx_type c = 0; c < nc; c++)
+            zl[c] = pb[si_len] * xi[c];
+        }
+    }
+
+  for (octave_idx_type c = 0; c < nc; c++)
+    for (octave_idx_type k = 0; k < si_len; k++)
+      psi[c*si_len + k] = z[k*nc + c];
+}
+
+// Apply the cascade of the NSEC second-order sections with normalized
+// coefficients PS (b0, b1, b2, a1, a2 for each section) to the
+// contiguous channel PX of length X_LEN.  PZ holds the two states of
+// each section.  The sections are applied to each sample in turn, so
+// the signal between the sections is never stored.
+
+template <typename T>
+static void
+sosfilt_channel (const T *ps, octave_idx_type nsec, const T *px, T *py,
+                 octave_idx_type x_len, T *pz, bool interruptible)
+{
+  for (octave_idx_type i = 0; i < x_len; i++)
+    {
+      if (interruptible && (i & 0xffff) == 0)
+        octave_quit ();
+
+      T w = px[i];
+
+      for (octave_idx_type k = 0; k < nsec; k++)
+        {
+          const T *c = ps + 5*k;
+          T *z = pz + 2*k;
+
+          T v = z[0] + c[0] * w;
+          z[0] = z[1] + c[1] * w - c[3] * v;
+          z[1] = c[2] * w - c[4] * v;
+          w = v;
+        }
+
+      py[i] = w;
+    }
+}
+
+// Same as sosfilt_channel for NC channels that are interleaved in
+// memory, as in filter_interleaved: sample I of channel C is
+// PX[I*STRIDE + C], and its states are PZ[C*2*NSEC ...].  The
+// operations are the same, so the results are identical.
+
+template <typename T>
+static void
+sosfilt_interleaved (const T *ps, octave_idx_type nsec, const T *px, T *py,
+                     octave_idx_type x_len, octave_idx_type stride, T *pz,
+                     octave_idx_type nc, bool interruptible)
+{
+  octave_idx_type z_len = 2 * nsec;
+
+  OCTAVE_LOCAL_BUFFER (T, z, z_len * nc);
+  OCTAVE_LOCAL_BUFFER (T, w, nc);
+
+  for (octave_idx_type c = 0; c < nc; c++)
+    for (octave_idx_type k = 0; k < z_len; k++)
+      z[k*nc + c] = pz[c*z_len + k];
+
+  for (octave_idx_type i = 0; i < x_len; i++)
+    {
+      if (interruptible && (i & 0xfff) == 0)
+        octave_quit ();
+
+      const T *xi = px + i*stride;
+      T *yi = py + i*stride;
+
+      for (octave_idx_type c = 0; c < nc; c++)
+        w[c] = xi[c];
+
+      for (octave_idx_type k = 0; k < nsec; k++)
+        {
+          const T *cf = ps + 5*k;
+          T *z0 = z + 2*k*nc;
+          T *z1 = z0 + nc;
+
+          for (octave_idx_type c = 0; c < nc; c++)
+            {
+              T v = z0[c] + cf[0] * w[c];
+              z0[c] = z1[c] + cf[1] * w[c] - cf[3] * v;
+              z1[c] = cf[2] * w[c] - cf[4] * v;
+              w[c] = v;
+            }
+        }
+
+      for (octave_idx_type c = 0; c < nc; c++)
+        yi[c] = w[c];
+    }
+
+  for (octave_idx_type c = 0; c < nc; c++)
+    for (octave_idx_type k = 0; k < z_len; k++)
+      pz[c*z_len + k] = z[k*nc + c];
+}
+
+// Run TASK (T, INTERRUPTIBLE) for 0 <= T < NTASKS, where each task does
+// about WORK multiply-adds.  The tasks are independent, so they are run
+// in parallel unless a single one takes too long to go without checks
+// for interrupts.  parallel_for checks for interrupts only every 64
+// grains, which may be a lot of work when run on a single thread, so the
+// tasks are handed to it in batches of bounded total work.
+
+template <typename F>
+static void
+filter_run_tasks (octave_idx_type ntasks, double work, F task)
+{
+  if (ntasks > 1 && work <= FILTER_MAX_PARALLEL_WORK)
+    {
+      work = std::max (work, 1.0);
+
+      octave_idx_type grain
+        = static_cast<octave_idx_type> (FILTER_MIN_THREAD_WORK / work) + 1;
+      octave_idx_type batch
+        = static_cast<octave_idx_type> (FILTER_MAX_ROUND_WORK / work);
+
+      for (octave_idx_type t0 = 0; t0 < ntasks; t0 += batch)
+        {
+          octave_idx_type n = std::min (batch, ntasks - t0);
+
+          parallel_for (n, grain, [&] (octave_idx_type lo,
+                                       octave_idx_type hi)
+            {
+              for (octave_idx_type t = t0 + lo; t < t0 + hi; t++)
+                task (t, false);
+            });
+        }
+    }
+  else
+    {
+      for (octave_idx_type t = 0; t < ntasks; t++)
+        {
+          octave_quit ();
+          task (t, true);
+        }
+    }
+}
+
 template <typename T>
 MArray<T>
 filter (MArray<T>& b, MArray<T>& a, MArray<T>& x, MArray<T>& si,
@@ -110,127 +480,76 @@ filter (MArray<T>& b, MArray<T>& a, MArray<T>& x, MArray<T>& si,
 
   y.resize (x_dims, 0.0);
 
+  if (y.isempty ())
+    return y;
+
   octave_idx_type x_stride = 1;
   for (int i = 0; i < dim; i++)
     x_stride *= x_dims(i);
 
   octave_idx_type x_num = x_dims.numel () / x_len;
-  // For deconv and fftfilt, x_num seems to always be 1.
-  // For directly calling filter, it can be more than 1.
 
-  for (octave_idx_type num = 0; num < x_num; num++)
+  T *py = y.rwdata ();
+  T *psi = si.rwdata ();
+  const T *pb = b.data ();
+  const T *pa = a.data ();
+  const T *px = x.data ();
+  bool has_a = (a_len > 1);
+
+  // The channels are independent.  If the filter runs along the first
+  // dimension, each channel is contiguous and is a task of its own.
+  // Otherwise, consecutive channels are interleaved in memory, and
+  // blocks of them are filtered together.
+
+  octave_idx_type blk = (x_stride == 1 ? 1 : std::min (x_stride,
+                                                        FILTER_BLOCK));
+  octave_idx_type nblk = (x_stride + blk - 1) / blk;
+  octave_idx_type ntasks = (x_num / x_stride) * nblk;
+  double work = static_cast<double> (x_len) * (si_len + 1) * blk;
+
+  filter_run_tasks (ntasks, work, [=] (octave_idx_type t,
+                                       bool interruptible)
     {
-      octave_idx_type x_offset = (x_stride == 1) ? num * x_len
-                                 : num + (num / x_stride) * x_stride * (x_len - 1);
-
-      octave_idx_type si_offset = num * si_len;
-
-      // Try to achieve a balance between speed and interruptibility.
-      //
-      // One extreme is to not check for interruptions at all, which gives
-      // good speed but the user cannot use Ctrl-C for the whole duration.
-      // The other end is to check frequently from inside an inner loop,
-      // which slows down performance by 5X or 6X.
-      //
-      // Putting any sort of check in an inner loop seems to prevent the
-      // compiler from optimizing the loop, so we cannot say "check for
-      // interruptions every M iterations" using an if-statement.
-      //
-      // This is a compromise approach to split the total numer of loop
-      // executions into num_outer and num_inner, to provide periodic checks
-      // for interruptions without writing a conditional inside a tight loop.
-      //
-      // To make it more interruptible and run more slowly, reduce num_inner.
-      // To speed it up but make it less interruptible, increase it.
-      // May need to increase it slowly over time as computers get faster.
-      // The aim is to not lose Ctrl-C ability for longer than about 2 seconds.
-      //
-      // In December 2021, num_inner = 100000 is acceptable.
-
-      octave_idx_type num_execs = si_len-1; // 0 to num_execs-1
-      octave_idx_type num_inner = 100000;
-      octave_idx_type num_outer = num_execs / num_inner;
-
-      // The following if-else block depends on a_len and si_len,
-      // both of which are loop invariants in this 0 <= num < x_num loop.
-      // But x_num is so small in practice that using the if-else inside
-      // the loop has more benefits than duplicating the outer for-loop,
-      // even though the checks are on loop invariants.
-
-      // We cannot have a_len <= 1 AND si_len <= 0 because that case already
-      // returned above. This means exactly one of the following blocks
-      // inside the if-conditional will be obeyed: it is not possible for the
-      // if-block and the else-block to *both* skip. Therefore any code that
-      // is common to both branches can be pulled out here without affecting
-      // correctness or speed.
-
-      T *py = y.rwdata ();
-      T *psi = si.rwdata ();
-      const T *pb = b.data ();
-      const T *px = x.data ();
-      psi += si_offset;
-
-      if (a_len > 1)
+      octave_idx_type g = t / nblk;
+      octave_idx_type c0 = (t % nblk) * blk;
+      octave_idx_type x_offset = c0 + g * x_stride * x_len;
+      T *ps = psi + (g * x_stride + c0) * si_len;
+
+      if (x_stride > 1)
+        filter_interleaved (pb, pa, has_a, si_len, px + x_offset,
+                            py + x_offset, x_len, x_stride, ps,
+                            std::min (blk, x_stride - c0), interruptible);
+      else
         {
-          const T *pa = a.data ();
-
-          // Usually the last element to be written will be si_len-1
-          // but if si_len is 0, then we need the 0th element to be written.
-          // Pulling this check out of the for-loop makes it run faster.
-          octave_idx_type iidx = (si_len > 0) ? si_len-1 : 0;
-
-          for (octave_idx_type i = 0, idx = x_offset;
-               i < x_len;
-               i++, idx += x_stride)
+          switch (si_len)
             {
-              py[idx] = psi[0] + pb[0] * px[idx];
-
-              // Outer and inner loops for interruption management
-              for (octave_idx_type u = 0; u <= num_outer; u++)
-                {
-                  octave_idx_type lo = u * num_inner;
-                  octave_idx_type hi = (lo + num_inner < num_execs-1)
-                                       ? lo + num_inner : num_execs-1;
-
-                  // Inner loop, no interruption
-                  for (octave_idx_type j = lo; j <= hi; j++)
-                    psi[j] = psi[j+1] - pa[j+1] * py[idx] + pb[j+1] * px[idx];
-
-                  octave_quit();  // Check for interruptions
-                }
-
-              psi[iidx] = pb[si_len] * px[idx] - pa[si_len] * py[idx];
+            case 1:
+              filter_channel_fixed<T, 1> (pb, pa, has_a, px + x_offset,
+                                          py + x_offset, x_len, ps,
+                                          interruptible);
+              break;
+            case 2:
+              filter_channel_fixed<T, 2> (pb, pa, has_a, px + x_offset,
+                                          py + x_offset, x_len, ps,
+                                          interruptible);
+              break;
+            case 3:
+              filter_channel_fixed<T, 3> (pb, pa, has_a, px + x_offset,
+                                          py + x_offset, x_len, ps,
+                                          interruptible);
+              break;
+            case 4:
+              filter_channel_fixed<T, 4> (pb, pa, has_a, px + x_offset,
+                                          py + x_offset, x_len, ps,
+                                          interruptible);
+              break;
+            default:
+              filter_channel (pb, pa, has_a, si_len, px + x_offset,
+                              py + x_offset, x_len, ps, interruptible);
+              break;
             }
         }
-      else // a_len <= 1 ==> si_len MUST be > 0
-        {
-          // This else-block is almost the same as the above if-block,
-          // except for the absence of variable pa.
-
-          for (octave_idx_type i = 0, idx = x_offset;
-               i < x_len;
-               i++, idx += x_stride)
-            {
-              py[idx] = psi[0] + pb[0] * px[idx];
-
-              // Outer and inner loops for interruption management
-              for (octave_idx_type u = 0; u <= num_outer; u++)
-                {
-                  octave_idx_type lo = u * num_inner;
-                  octave_idx_type hi = (lo + num_inner < num_execs-1)
-                                       ? lo + num_inner : num_execs-1;
-
-                  // Inner loop, no interruption
-                  for (octave_idx_type j = lo; j <= hi; j++)
-                    psi[j] = psi[j+1] + pb[j+1] * px[idx];
-
-                  octave_quit();  // Check for interruptions
-                }
-
-              psi[si_len-1] = pb[si_len] * px[idx];
-            }
-        }
-    }
+    });
 
   return y;
 }
@@ -260,6 +579,96 @@ filter (MArray<T>& b, MArray<T>& a, MArray<T>& x, int dim = -1)
   return filter (b, a, x, si, dim);
 }
 
+template <typename T>
+MArray<T>
+sosfilt (const MArray<T>& sos, const MArray<T>& x, MArray<T>& zi, int dim)
+{
+  octave_idx_type nsec = sos.rows ();
+
+  if (sos.ndims () != 2 || sos.columns () != 6 || nsec < 1)
+    error ("sosfilt: SOS must be an L-by-6 matrix");
+
+  // Normalize each section by its leading denominator coefficient.
+  MArray<T> coef (dim_vector (5, nsec));
+  for (octave_idx_type k = 0; k < nsec; k++)
+    {
+      T a0 = sos(k, 3);
+
+      if (a0 == static_cast<T> (0.0))
+        error ("sosfilt: the leading denominator coefficient of each section must be nonzero");
+
+      coef(0, k) = sos(k, 0) / a0;
+      coef(1, k) = sos(k, 1) / a0;
+      coef(2, k) = sos(k, 2) / a0;
+      coef(3, k) = sos(k, 4) / a0;
+      coef(4, k) = sos(k, 5) / a0;
+    }
+
+  const dim_vector& x_dims = x.dims ();
+  if (dim < 0 || dim >= x_dims.ndims ())
+    error ("sosfilt: DIM must be a valid dimension");
+
+  octave_idx_type x_len = x_dims(dim);
+
+  octave_idx_type x_stride = 1;
+  for (int i = 0; i < dim; i++)
+    x_stride *= x_dims(i);
+
+  octave_idx_type x_num = 1;
+  for (int i = 0; i < x_dims.ndims (); i++)
+    if (i != dim)
+      x_num *= x_dims(i);
+
+  dim_vector zi_dims (2, nsec, x_num);
+  if (x_num == 1)
+    zi_dims = dim_vector (2, nsec);
+
+  if (zi.isempty ())
+    zi = MArray<T> (zi_dims, T (0.0));
+  else if (zi.numel () != 2 * nsec * x_num)
+    error ("sosfilt: ZI must be a 2-by-L-by-C array, where C is the number of channels of X");
+  else
+    zi = zi.reshape (zi_dims);
+
+  MArray<T> y (x_dims);
+
+  if (y.isempty ())
+    return y;
+
+  T *py = y.rwdata ();
+  T *pz = zi.rwdata ();
+  const T *ps = coef.data ();
+  const T *px = x.data ();
+
+  // As in filter, channels along the first dimension are tasks of their
+  // own, and blocks of interleaved channels are filtered together.
+
+  octave_idx_type blk = (x_stride == 1 ? 1 : std::min (x_stride,
+                                                        FILTER_BLOCK));
+  octave_idx_type nblk = (x_stride + blk - 1) / blk;
+  octave_idx_type ntasks = (x_num / x_stride) * nblk;
+  double work = 5.0 * x_len * nsec * blk;
+
+  filter_run_tasks (ntasks, work, [=] (octave_idx_type t,
+                                       bool interruptible)
+    {
+      octave_idx_type g = t / nblk;
+      octave_idx_type c0 = (t % nblk) * blk;
+      octave_idx_type x_offset = c0 + g * x_stride * x_len;
+      T *pzc = pz + 2 * nsec * (g * x_stride + c0);
+
+      if (x_stride > 1)
+        sosfilt_interleaved (ps, nsec, px + x_offset, py + x_offset, x_len,
+                             x_stride, pzc, std::min (blk, x_stride - c0),
+                             interruptible);
+      else
+        sosfilt_channel (ps, nsec, px + x_offset, py + x_offset, x_len, pzc,
+                         interruptible);
+    });
+
+  return y;
+}
+
 DEFUN (filter, args, ,
        doc: /* -*- texinfo -*-
 @deftypefn  {} {@var{y} =} filter (@var{b}, @var{a}, @var{x})
@@ -360,7 +769,7 @@ H(z) = ---------------------
 @end example
 
 @end ifnottex
-@seealso{filter2, fftfilt, freqz}
+@seealso{filter2, fftfilt, freqz, sosfilt}
 @end deftypefn */)
 {
   int nargin = args.length ();
@@ -629,6 +1038,8 @@ filter (MArray<FloatComplex>&, MArray<FloatComplex>&, MArray<FloatComplex>&,
 
 %!assert (filter (1, ones (10,1) / 10, []), [])
 %!assert (filter (1, ones (10,1) / 10, zeros (0,10)), zeros (0,10))
+%!assert (filter (1, [1 0.5], zeros (0,5), [], 2), zeros (0,5))
+%!assert (filter (1, [1 0.5], zeros (3,0,4), [], 3), zeros (3,0,4))
 %!assert (filter (1, ones (10,1) / 10, single (1:5)),
 %!        repmat (single (10), 1, 5))
 
@@ -648,6 +1059,238 @@ filter (MArray<FloatComplex>&, MArray<FloatComplex>&, MArray<FloatComplex>&,
 %! y0 = reshape (y0, size (x));
 %! y = filter ([1 1 1], 1, x, [], 3);
 %! assert (y, y0);
+
+## Test multiple channels along dimensions other than the first, which
+## are filtered in interleaved blocks
+%!test
+%! old_state = rand ("state");
+%! restore_state = onCleanup (@() rand ("state", old_state));
+%! rand ("state", 42);
+%! x = rand (100, 70);
+%! b = [1, 2, 3, 4, 5, 6];
+%! a = [1, -0.2, 0.1];
+%! [y, sf] = filter (b, a, x);
+%! [yt, sft] = filter (b, a, x.', [], 2);
+%! assert (yt, y.');
+%! assert (sft, sf);
+%! si = rand (5, 70);
+%! [y, sf] = filter (b, a, x, si);
+%! [yt, sft] = filter (b, a, x.', si, 2);
+%! assert (yt, y.');
+%! assert (sft, sf);
+%! y3 = filter (b, a, permute (cat (3, x, -x), [3, 1, 2]), [], 2);
+%! assert (squeeze (y3(1,:,:)), filter (b, a, x));
+%! assert (squeeze (y3(2,:,:)), -filter (b, a, x));
+
+## Test the fixed-order kernels for short filters against a long filter
+## with zero coefficients
+%!test
+%! x = sin (1:50)';
+%! for n = 1:5
+%!   b = 1 ./ (1:n+1);
+%!   a = [1, 0.5 ./ (1:n)];
+%!   y = filter (b, a, x);
+%!   assert (filter ([b, zeros(1, 5)], a, x), y, -10*eps);
+%!   [y1, s1] = filter (b, a, x(1:20));
+%!   y2 = filter (b, a, x(21:end), s1);
+%!   assert ([y1; y2], y, -10*eps);
+%!   assert (filter (b, 1, x), conv (x, b')(1:50), -10*eps);
+%! endfor
+*/
+
+DEFUN (sosfilt, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{y} =} sosfilt (@var{sos}, @var{x})
+@deftypefnx {} {[@var{y}, @var{zf}] =} sosfilt (@var{sos}, @var{x}, @var{zi})
+@deftypefnx {} {[@var{y}, @var{zf}] =} sosfilt (@var{sos}, @var{x}, @var{zi}, @var{dim})
+Apply a cascade of second-order sections (biquad filters) to the data
+@var{x}.
+
+Each row @code{[b0, b1, b2, a0, a1, a2]} of the L-by-6 matrix @var{sos}
+describes one section with the transfer function
+
+@example
+@group
+        b0 + b1 z^(-1) + b2 z^(-2)
+H(z) = ----------------------------
+        a0 + a1 z^(-1) + a2 z^(-2)
+@end group
+@end example
+
+@noindent
+and the sections are applied in order.  The result is the same as calling
+@code{filter} once for each section, but the data are passed through all
+sections in a single sweep and each section is implemented in direct form
+II transposed.  For high-order IIR filters, a cascade of second-order
+sections is numerically much better behaved than a single transfer function.
+
+The filter runs along the first non-singleton dimension of @var{x}, or along
+@var{dim} if supplied.  Each vector along that dimension is an independent
+channel, and the channels are filtered in parallel if Octave was built with
+OpenMP.
+
+The optional argument @var{zi} holds the initial states of the sections.
+It is a 2-by-L-by-C array, where C is the number of channels of @var{x}
+(or a 2-by-L matrix if there is only one channel).  If @var{zi} is omitted
+or empty, the initial states are zero.  The final states are returned in
+@var{zf} with the same layout, so that a long signal can be filtered in
+pieces:
+
+@example
+@group
+[y1, zf] = sosfilt (sos, x(1:1000));
+y2 = sosfilt (sos, x(1001:end), zf);
+@end group
+@end example
+@seealso{filter}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 2 || nargin > 4)
+    print_usage ();
+
+  int dim;
+  const dim_vector& x_dims = args(1).dims ();
+
+  if (nargin == 4)
+    {
+      dim = args(3).nint_value () - 1;
+      if (dim < 0 || dim >= x_dims.ndims ())
+        error ("sosfilt: DIM must be a valid dimension");
+    }
+  else
+    dim = x_dims.first_non_singleton ();
+
+  octave_value_list retval;
+
+  const char *sos_errmsg = "sosfilt: SOS must be a numeric matrix";
+  const char *x_zi_errmsg = "sosfilt: X and ZI must be arrays";
+
+  bool have_zi = (nargin >= 3 && ! args(2).isempty ());
+
+  bool isfloat = (args(0).is_single_type ()
+                  || args(1).is_single_type ()
+                  || (have_zi && args(2).is_single_type ()));
+
+  if (args(0).iscomplex ()
+      || args(1).iscomplex ()
+      || (have_zi && args(2).iscomplex ()))
+    {
+      if (isfloat)
+        {
+          FloatComplexNDArray sos = args(0).xfloat_complex_array_value (sos_errmsg);
+          FloatComplexNDArray x = args(1).xfloat_complex_array_value (x_zi_errmsg);
+          FloatComplexNDArray zi;
+          if (have_zi)
+            zi = args(2).xfloat_complex_array_value (x_zi_errmsg);
+
+          FloatComplexNDArray y (sosfilt<FloatComplex> (sos, x, zi, dim));
+
+          retval = ovl (y, zi);
+        }
+      else
+        {
+          ComplexNDArray sos = args(0).xcomplex_array_value (sos_errmsg);
+          ComplexNDArray x = args(1).xcomplex_array_value (x_zi_errmsg);
+          ComplexNDArray zi;
+          if (have_zi)
+            zi = args(2).xcomplex_array_value (x_zi_errmsg);
+
+          ComplexNDArray y (sosfilt<Complex> (sos, x, zi, dim));
+
+          retval = ovl (y, zi);
+        }
+    }
+  else
+    {
+      if (isfloat)
+        {
+          FloatNDArray sos = args(0).xfloat_array_value (sos_errmsg);
+          FloatNDArray x = args(1).xfloat_array_value (x_zi_errmsg);
+          FloatNDArray zi;
+          if (have_zi)
+            zi = args(2).xfloat_array_value (x_zi_errmsg);
+
+          FloatNDArray y (sosfilt<float> (sos, x, zi, dim));
+
+          retval = ovl (y, zi);
+        }
+      else
+        {
+          NDArray sos = args(0).xarray_value (sos_errmsg);
+          NDArray x = args(1).xarray_value (x_zi_errmsg);
+          NDArray zi;
+          if (have_zi)
+            zi = args(2).xarray_value (x_zi_errmsg);
+
+          NDArray y (sosfilt<double> (sos, x, zi, dim));
+
+          retval = ovl (y, zi);
+        }
+    }
+
+  return retval;
+}
+
+/*
+%!shared sos, x
+%! sos = [1, 2, 1, 1, -0.5, 0.25; 0.5, 0, -0.5, 2, 0.2, 0.1; 1, -1, 0, 1, 0.3, 0];
+%! x = sin (0.3 * (1:200)') + cos (0.05 * (1:200)');
+
+%!test
+%! y = x;
+%! for k = 1:rows (sos)
+%!   y = filter (sos(k,1:3), sos(k,4:6), y);
+%! endfor
+%! assert (sosfilt (sos, x), y, -10*eps);
+%! assert (sosfilt (sos, x.'), y.', -10*eps);
+
+%!test
+%! [y, zf] = sosfilt (sos, x);
+%! assert (size (zf), [2, 3]);
+%! [y1, z1] = sosfilt (sos, x(1:77));
+%! [y2, z2] = sosfilt (sos, x(78:end), z1);
+%! assert ([y1; y2], y, -10*eps);
+%! assert (z2, zf, -10*eps);
+
+%!test
+%! X = [x, 2*x, -x];
+%! [Y, zf] = sosfilt (sos, X);
+%! assert (size (zf), [2, 3, 3]);
+%! assert (Y, [1, 2, -1] .* sosfilt (sos, x), -10*eps);
+%! assert (sosfilt (sos, X.', [], 2), Y.');
+%! [Y1, z1] = sosfilt (sos, X(1:100,:));
+%! Y2 = sosfilt (sos, X(101:end,:), z1);
+%! assert ([Y1; Y2], Y, -10*eps);
+
+## More interleaved channels than are filtered together in one block
+%!test
+%! X = x * (1:150);
+%! [Y, zf] = sosfilt (sos, X);
+%! [Yt, zft] = sosfilt (sos, X.', [], 2);
+%! assert (Yt, Y.', -10*eps);
+%! assert (zft, zf, -10*eps);
+%! [Y1, z1] = sosfilt (sos, X(1:90, :).', [], 2);
+%! Y2 = sosfilt (sos, X(91:end, :).', z1, 2);
+%! assert ([Y1, Y2], Y.', -10*eps);
+%! X3 = permute (reshape (X, [200, 10, 15]), [2, 1, 3]);
+%! assert (sosfilt (sos, X3, [], 2),
+%!         permute (reshape (Y, [200, 10, 15]), [2, 1, 3]), -10*eps);
+
+%!test
+%! assert (class (sosfilt (single (sos), x)), "single");
+%! assert (sosfilt (single (sos), x), single (sosfilt (sos, x)), -1e-5);
+%! assert (sosfilt (sos, (1 + 2i) * x), (1 + 2i) * sosfilt (sos, x), -10*eps);
+%! assert (sosfilt (sos, zeros (0, 3)), zeros (0, 3));
+
+## Test input validation
+%!error sosfilt ()
+%!error sosfilt (1)
+%!error <SOS must be an L-by-6 matrix> sosfilt (ones (2, 5), 1:3)
+%!error <leading denominator coefficient> sosfilt ([1 0 0 0 1 0], 1:3)
+%!error <ZI must be a 2-by-L-by-C array> sosfilt ([1 0 0 1 0 0], 1:3, [1 2 3])
+%!error <DIM must be a valid dimension> sosfilt ([1 0 0 1 0 0], 1:3, [], 3)
 */
 
 OCTAVE_END_NAMESPACE(octave)
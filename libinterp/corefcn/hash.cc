@@ -40,6 +40,8 @@ for now.
 #  include "config.h"
 #endif
 
+#include <map>
+#include <memory>
 #include <string>
 
 #include "lo-hash.h"
@@ -48,12 +50,131 @@ for now.
 #include "error.h"
 #include "ov.h"
 #include "ovl.h"
+#include "utils.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+template <typename T>
+static void
+hash_array_data (crypto::hash_context& ctx, const T& a)
+{
+  ctx.update (a.data (), a.numel () * sizeof (typename T::element_type));
+}
+
+// Add the bytes of the elements of the array VAL to CTX, in their
+// native representation.
+
+static void
+hash_array_bytes (crypto::hash_context& ctx, const octave_value& val)
+{
+  if (val.issparse ())
+    error ("hash: sparse matrices are not supported");
+
+  switch (val.builtin_type ())
+    {
+    case btyp_double:
+      hash_array_data (ctx, val.array_value ());
+      break;
+
+    case btyp_complex:
+      hash_array_data (ctx, val.complex_array_value ());
+      break;
+
+    case btyp_float:
+      hash_array_data (ctx, val.float_array_value ());
+      break;
+
+    case btyp_float_complex:
+      hash_array_data (ctx, val.float_complex_array_value ());
+      break;
+
+    case btyp_int8:
+      hash_array_data (ctx, val.int8_array_value ());
+      break;
+
+    case btyp_int16:
+      hash_array_data (ctx, val.int16_array_value ());
+      break;
+
+    case btyp_int32:
+      hash_array_data (ctx, val.int32_array_value ());
+      break;
+
+    case btyp_int64:
+      hash_array_data (ctx, val.int64_array_value ());
+      break;
+
+    case btyp_uint8:
+      hash_array_data (ctx, val.uint8_array_value ());
+      break;
+
+    case btyp_uint16:
+      hash_array_data (ctx, val.uint16_array_value ());
+      break;
+
+    case btyp_uint32:
+      hash_array_data (ctx, val.uint32_array_value ());
+      break;
+
+    case btyp_uint64:
+      hash_array_data (ctx, val.uint64_array_value ());
+      break;
+
+    case btyp_bool:
+      hash_array_data (ctx, val.bool_array_value ());
+      break;
+
+    case btyp_char:
+      hash_array_data (ctx, val.char_array_value ());
+      break;
+
+    default:
+      error ("hash: DATA must be a numeric, logical, or character array");
+    }
+}
+
+// Hash contexts that are open for incremental hashing, by the integer
+// ID that was returned to the caller, similar to the IDs of open files.
+// IDs are not reused.
+
+static std::map<int, std::unique_ptr<crypto::hash_context>> hash_context_map;
+static int hash_context_next_id = 1;
+
+static int
+open_hash_context (const std::string& hash_type)
+{
+  std::unique_ptr<crypto::hash_context> ctx
+    = std::make_unique<crypto::hash_context> (hash_type);
+
+  int id = hash_context_next_id++;
+
+  hash_context_map[id] = std::move (ctx);
+
+  return id;
+}
+
+static std::map<int, std::unique_ptr<crypto::hash_context>>::iterator
+find_hash_context (const octave_value& id_arg)
+{
+  int id = id_arg.xint_value ("hash: ID must be an integer");
+
+  auto it = hash_context_map.find (id);
+
+  if (it == hash_context_map.end ())
+    error ("hash: invalid hash context ID = %d", id);
+
+  return it;
+}
+
 DEFUN (hash, args, ,
        doc: /* -*- texinfo -*-
-@deftypefn {} {@var{hashval} =} hash ("@var{hashfcn}", @var{str})
+@deftypefn  {} {@var{hashval} =} hash ("@var{hashfcn}", @var{str})
+@deftypefnx {} {@var{hashval} =} hash ("@var{hashfcn}", "file", @var{filename})
+@deftypefnx {} {@var{hashval} =} hash ("@var{hashfcn}", "bytes", @var{data})
+@deftypefnx {} {@var{id} =} hash ("init", "@var{hashfcn}")
+@deftypefnx {} {} hash ("update", @var{id}, @var{str})
+@deftypefnx {} {} hash ("update", @var{id}, "bytes", @var{data})
+@deftypefnx {} {@var{hashval} =} hash ("final", @var{id})
 Calculate the hash value of the string @var{str} using the hash function
 @var{hashfcn}.
 
@@ -104,24 +225,122 @@ hash ("sha1", "abc")
 @end group
 @end example
 
-And to compute the hash value of a file, e.g., @code{file = "file.txt"},
-call @code{hash} in combination with the @code{fileread}:
+With the option @qcode{"file"}, the hash value of the contents of the file
+@var{filename} is calculated.  The file is read in blocks, so it does not
+need to fit in memory.  The result is the same as that of
 
 @example
 @group
-hash ("md5", fileread (file));
+hash ("md5", fileread (@var{filename}));
 @end group
 @end example
 
+With the option @qcode{"bytes"}, the hash value of the elements of the
+numeric, logical, or character array @var{data} is calculated from their
+binary representation in memory, without converting them to characters
+first.  The result depends on the class of @var{data} and on the byte order
+of the machine.
+
+Data that arrives in pieces can be hashed incrementally.
+@code{hash ("init", @var{hashfcn})} returns an integer @var{id} for a new
+hash computation.  Each call of @code{hash ("update", @var{id}, @dots{})}
+adds a string @var{str}, or the bytes of an array @var{data} as with the
+option @qcode{"bytes"}.  Finally, @code{hash ("final", @var{id})} returns the
+hash value of all of the data added and releases @var{id}.  For example,
+
+@example
+@group
+id = hash ("init", "md5");
+hash ("update", id, "a");
+hash ("update", id, "bc");
+hash ("final", id)
+     @print{} ans = 900150983cd24fb0d6963f7d28e17f72
+@end group
+@end example
 @end deftypefn */)
 {
-  if (args.length () != 2)
+  int nargin = args.length ();
+
+  if (nargin < 2 || nargin > 4)
     print_usage ();
 
   std::string hash_type = args(0).string_value ();
-  std::string str = args(1).string_value ();
 
-  return ovl (crypto::hash (hash_type, str));
+  if (hash_type == "init")
+    {
+      if (nargin != 2)
+        print_usage ();
+
+      std::string fcn = args(1).xstring_value ("hash: HASHFCN must be a string");
+
+      return ovl (open_hash_context (fcn));
+    }
+  else if (hash_type == "update")
+    {
+      if (nargin < 3)
+        print_usage ();
+
+      crypto::hash_context& ctx = *(find_hash_context (args(1))->second);
+
+      if (nargin == 4)
+        {
+          std::string opt
+            = args(2).xstring_value (R"(hash: option must be "bytes")");
+
+          if (opt != "bytes")
+            error (R"(hash: option must be "bytes")");
+
+          hash_array_bytes (ctx, args(3));
+        }
+      else
+        ctx.update (args(2).string_value ());
+
+      return ovl ();
+    }
+  else if (hash_type == "final")
+    {
+      if (nargin != 2)
+        print_usage ();
+
+      auto it = find_hash_context (args(1));
+
+      std::unique_ptr<crypto::hash_context> ctx = std::move (it->second);
+      hash_context_map.erase (it);
+
+      return ovl (ctx->finish ());
+    }
+
+  if (nargin == 4)
+    print_usage ();
+
+  if (nargin == 2)
+    {
+      std::string str = args(1).string_value ();
+
+      return ovl (crypto::hash (hash_type, str));
+    }
+
+  std::string opt = args(1).xstring_value (R"(hash: option must be "file" or "bytes")");
+
+  if (opt == "file")
+    {
+      std::string file_name
+        = args(2).xstring_value ("hash: FILENAME must be a string");
+
+      file_name = find_data_file_in_load_path ("hash", file_name);
+
+      return ovl (crypto::hash_file (hash_type, file_name));
+    }
+  else if (opt == "bytes")
+    {
+      crypto::hash_context ctx (hash_type);
+
+      hash_array_bytes (ctx, args(2));
+
+      return ovl (ctx.finish ());
+    }
+  else
+    error (R"(hash: option must be "file" or "bytes")");
 }
 
 /*
@@ -229,6 +448,59 @@ hash ("md5", fileread (file));
 %! assert (hash ("md5", fileread (tfile)), "147a664a2ca9410911e61986d3f0d52a");
 %! unlink (tfile);
 
+## Hash files in blocks
+%!test
+%! tfile = tempname ();
+%! data = char (mod (0:199999, 256));
+%! fid = fopen (tfile, "wb");
+%! fwrite (fid, data);
+%! fclose (fid);
+%! unwind_protect
+%!   assert (hash ("sha256", "file", tfile), hash ("sha256", data));
+%!   assert (hash ("md2", "file", tfile), hash ("md2", data));
+%! unwind_protect_cleanup
+%!   unlink (tfile);
+%! end_unwind_protect
+
+## Hash the bytes of arrays
+%!assert (hash ("md5", "bytes", "abc"), hash ("md5", "abc"))
+%!assert (hash ("md5", "bytes", uint8 ([97, 98, 99])), hash ("md5", "abc"))
+%!assert (hash ("sha1", "bytes", [1, 2, 3]),
+%!        hash ("sha1", char (typecast ([1, 2, 3], "uint8"))))
+%!assert (hash ("sha1", "bytes", 1:3), hash ("sha1", "bytes", [1, 2, 3]))
+%!assert (hash ("sha384", "bytes", single ([])), hash ("sha384", ""))
+%!assert (! strcmp (hash ("md5", "bytes", int16 (1)),
+%!                  hash ("md5", "bytes", int32 (1))))
+
+## Hash data in several pieces
+%!test
+%! id = hash ("init", "sha256");
+%! hash ("update", id, "The quick brown ");
+%! hash ("update", id, "");
+%! hash ("update", id, "fox jumps over the lazy dog");
+%! assert (hash ("final", id),
+%!         hash ("sha256", "The quick brown fox jumps over the lazy dog"));
+%! fail ("hash ('final', id)", "invalid hash context ID");
+%! fail ("hash ('update', id, 'abc')", "invalid hash context ID");
+
+%!test
+%! id1 = hash ("init", "md5");
+%! id2 = hash ("init", "SHA1");
+%! assert (id1 != id2);
+%! hash ("update", id1, "bytes", [1, 2]);
+%! hash ("update", id2, "ab");
+%! hash ("update", id1, "bytes", 3);
+%! hash ("update", id2, "c");
+%! assert (hash ("final", id2), "a9993e364706816aba3e25717850c26c9cd0d89d");
+%! assert (hash ("final", id1), hash ("md5", "bytes", [1, 2, 3]));
+
+%!test
+%! id = hash ("init", "md2");
+%! assert (hash ("final", id), hash ("md2", ""));
+
+## "init", "update", and "final" as data for the two-argument form
+%!assert (hash ("md5", "init"), "e37f0136aa3ffaf149b351f6a4c948e9")
+
 ## Test bad function calls
 %!error hash ()
 %!error hash ("")
@@ -240,6 +512,18 @@ hash ("md5", fileread (file));
 %!error hash ("md5")
 %!error hash ("sha1")
 %!error hash ("sha512")
+%!error <option must be> hash ("md5", "abc", "def")
+%!error <FILENAME must be a string> hash ("md5", "file", 1)
+%!error <unable to open file> hash ("md5", "file", "%_nonexistent_file_%")
+%!error <DATA must be> hash ("md5", "bytes", {1})
+%!error <sparse matrices> hash ("md5", "bytes", sparse (1))
+%!error <not supported> hash ("init", "unknown")
+%!error <invalid hash context ID> hash ("update", -1, "abc")
+%!error <ID must be an integer> hash ("final", {1})
+%!error <option must be "bytes"> hash ("update", hash ("init", "md5"), "file", "x")
+%!error hash ("init")
+%!error hash ("final", 1, 2)
+%!error hash ("md5", "bytes", 1, 2)
 */
 
 OCTAVE_END_NAMESPACE(octave)
@@ -659,6 +659,9 @@ input_system::interactive_input (const std::string& s, bool& eof)
 {
   Vlast_prompt_time.stamp ();
 
+  // Functions are checked for changes again after the prompt.
+  m_interpreter.get_symbol_table ().invalidate_lookups ();
+
   if (Vdrawnow_requested && m_interpreter.interactive ())
     {
       bool eval_error = false;
@@ -292,6 +292,8 @@ load_path::initialize (bool set_initial_path)
 void
 load_path::clear ()
 {
+  m_interpreter.get_symbol_table ().invalidate_lookups ();
+
   m_dir_info_list.clear ();
 
   m_top_level_package.clear ();
@@ -411,6 +413,8 @@ load_path::remove (const std::string& dir_arg)
 void
 load_path::update ()
 {
+  m_interpreter.get_symbol_table ().invalidate_lookups ();
+
   // I don't see a better way to do this because we need to
   // preserve the correct directory ordering for new files that
   // have appeared.
@@ -1084,6 +1088,8 @@ load_path::move (const dir_info& di, bool at_end, const std::string& pname)
 void
 load_path::add (const std::string& dir_arg, bool at_end, bool warn)
 {
+  m_interpreter.get_symbol_table ().invalidate_lookups ();
+
   std::size_t len = dir_arg.length ();
 
   if (len > 1 && dir_arg.substr (len-2) == "//")
@@ -1136,6 +1142,8 @@ load_path::add (const std::string& dir_arg, bool at_end, bool warn)
 void
 load_path::remove (const dir_info& di, const std::string& pname)
 {
+  m_interpreter.get_symbol_table ().invalidate_lookups ();
+
   package_info& l = get_package (pname);
 
   l.remove (di);
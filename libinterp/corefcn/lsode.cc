@@ -27,6 +27,7 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <list>
 #include <string>
 
@@ -61,8 +62,9 @@ static octave_value lsode_jac;
 static bool warned_fcn_imaginary = false;
 static bool warned_jac_imaginary = false;
 
-// Is this a recursive call?
-static int call_depth = 0;
+// Number of states of each member if an ensemble of initial states is
+// integrated, or 0 otherwise.
+static octave_idx_type ensemble_rows = 0;
 
 static ColumnVector
 lsode_user_function (const ColumnVector& x, double t)
@@ -71,7 +73,16 @@ lsode_user_function (const ColumnVector& x, double t)
 
   octave_value_list args;
   args(1) = t;
-  args(0) = x;
+
+  // The members of an ensemble are passed as the columns of a matrix.
+  if (ensemble_rows > 0)
+    {
+      Matrix xm (ensemble_rows, x.numel () / ensemble_rows);
+      std::copy_n (x.data (), x.numel (), xm.rwdata ());
+      args(0) = xm;
+    }
+  else
+    args(0) = x;
 
   if (lsode_fcn.is_defined ())
     {
@@ -97,7 +108,19 @@ lsode_user_function (const ColumnVector& x, double t)
           warned_fcn_imaginary = true;
         }
 
-      retval = tmp(0).xvector_value ("lsode: expecting user supplied function to return numeric vector");
+      if (ensemble_rows > 0)
+        {
+          Matrix xdot = tmp(0).xmatrix_value ("lsode: expecting user supplied function to return numeric array");
+
+          if (xdot.rows () != ensemble_rows
+              || xdot.numel () != x.numel ())
+            error ("lsode: user supplied function must return a matrix of the same size as X_0");
+
+          retval.resize (xdot.numel ());
+          std::copy_n (xdot.data (), xdot.numel (), retval.rwdata ());
+        }
+      else
+        retval = tmp(0).xvector_value ("lsode: expecting user supplied function to return numeric vector");
 
       if (retval.isempty ())
         err_user_supplied_eval ("lsode");
@@ -251,6 +274,26 @@ The second argument specifies the initial state of the system @math{x_0}.  The
 third argument is a vector, @var{t}, specifying the time values for which a
 solution is sought.
 
+If @var{x_0} is a matrix, each of its columns is the initial state of
+one member of an ensemble of independent systems that are integrated
+together.  @var{fcn} is then called with the matrix of the current states
+of all members and must return the matrix of their derivatives, so that
+it can be vectorized over the members.  Different parameters for the
+members can be passed in additional columns or captured by an anonymous
+function.  All members share the same time steps, and the error control
+takes all of them into account.  The solution @var{x} is returned as an
+array of size @code{numel (@var{t})}-by-@code{rows (@var{x_0})}-by-@code{columns (@var{x_0})}.
+If the option @qcode{"ensemble"} of @code{lsode_options} is set to
+@qcode{"elements"}, each element of a vector @var{x_0} is instead the
+initial state of a scalar ODE.  @var{fcn} is then called with a row vector
+of the states of all members, and the solution is returned as an array of
+size @code{numel (@var{t})}-by-1-by-@code{numel (@var{x_0})}.
+A Jacobian function cannot be used with an ensemble.  Instead, the
+banded structure of the Jacobian is exploited when it is approximated
+by finite differences with the @qcode{"stiff"} integration method.
+
+The user-supplied functions may themselves call @code{lsode}.
+
 The fourth argument is optional, and may be used to specify a set of
 times that the ODE solver should not integrate past.  It is useful for
 avoiding difficulties with singularities and points where there is a
@@ -288,22 +331,19 @@ fvdp = @@(@var{y},@var{t}) [@var{y}(2); (1 - @var{y}(1)^2) * @var{y}(2) - @var{y
   if (nargin < 3 || nargin > 4)
     print_usage ();
 
-  warned_fcn_imaginary = false;
-  warned_jac_imaginary = false;
-
-  unwind_protect_var<int> restore_var (call_depth);
-  call_depth++;
+  // Save the functions of an outer call, if any, so that the user
+  // functions may themselves call lsode.
 
-  if (call_depth > 1)
-    error ("lsode: invalid recursive call");
+  unwind_protect_var<octave_value> restore_fcn (lsode_fcn, octave_value ());
+  unwind_protect_var<octave_value> restore_jac (lsode_jac, octave_value ());
+  unwind_protect_var<bool> restore_warned_fcn (warned_fcn_imaginary, false);
+  unwind_protect_var<bool> restore_warned_jac (warned_jac_imaginary, false);
+  unwind_protect_var<octave_idx_type> restore_rows (ensemble_rows, 0);
 
   symbol_table& symtab = interp.get_symbol_table ();
 
   std::string fcn_name, fname, jac_name, jname;
 
-  lsode_fcn = octave_value ();
-  lsode_jac = octave_value ();
-
   octave_value f_arg = args(0);
 
   std::list<std::string> parameter_names ({"x", "t"});
@@ -368,7 +408,69 @@ fvdp = @@(@var{y},@var{t}) [@var{y}(2); (1 - @var{y}(1)^2) * @var{y}(2) - @var{y
   if (lsode_fcn.is_undefined ())
     error ("lsode: FCN argument is not a valid function name or handle");
 
-  ColumnVector state = args(1).xvector_value ("lsode: initial state X_0 must be a vector");
+  ColumnVector state;
+
+  LSODE_options opts (lsode_opts);
+
+  // A matrix X_0 is an ensemble of initial states, one in each column,
+  // that are integrated together as one system.  With the option
+  // "ensemble" set to "elements", a vector X_0 is an ensemble of scalar
+  // ODEs, which is passed to FCN as a row vector.
+  octave_idx_type n_ens = 1;
+
+  bool scalar_members = (opts.ensemble () == "elements");
+
+  if (scalar_members
+      && (args(1).ndims () != 2
+          || (args(1).rows () != 1 && args(1).columns () != 1)))
+    error (R"(lsode: X_0 must be a vector if option "ensemble" is "elements")");
+
+  if (scalar_members
+      || (args(1).ndims () == 2 && args(1).rows () > 1
+          && args(1).columns () > 1))
+    {
+      if (lsode_jac.is_defined ())
+        error ("lsode: a Jacobian function may not be used with an ensemble");
+
+      Matrix x0 = args(1).xmatrix_value ("lsode: initial state X_0 must be a vector or matrix");
+
+      if (scalar_members)
+        x0 = x0.reshape (dim_vector (1, x0.numel ()));
+
+      ensemble_rows = x0.rows ();
+      n_ens = x0.columns ();
+
+      state.resize (x0.numel ());
+      std::copy_n (x0.data (), x0.numel (), state.rwdata ());
+
+      // The Jacobian of the ensemble is block diagonal, so only a band
+      // of it needs to be approximated.  That takes 2*N-1 calls to FCN
+      // instead of one for each element of X_0.
+      if (opts.integration_method () == "stiff"
+          && opts.jacobian_type () == "full")
+        {
+          opts.set_jacobian_type ("banded");
+          opts.set_lower_jacobian_subdiagonals (ensemble_rows - 1);
+          opts.set_upper_jacobian_subdiagonals (ensemble_rows - 1);
+        }
+
+      // Use the same absolute tolerances for all members.
+      Array<double> abs_tol = opts.absolute_tolerance ();
+
+      if (abs_tol.numel () == ensemble_rows)
+        {
+          Array<double> ens_tol (dim_vector (x0.numel (), 1));
+
+          for (octave_idx_type j = 0; j < n_ens; j++)
+            std::copy_n (abs_tol.data (), ensemble_rows,
+                         ens_tol.rwdata () + j * ensemble_rows);
+
+          opts.set_absolute_tolerance (ens_tol);
+        }
+    }
+  else
+    state = args(1).xvector_value ("lsode: initial state X_0 must be a vector");
+
   ColumnVector out_times = args(2).xvector_value ("lsode: output time variable T must be a vector");
 
   ColumnVector crit_times;
@@ -390,7 +492,7 @@ fvdp = @@(@var{y},@var{t}) [@var{y}(2); (1 - @var{y}(1)^2) * @var{y}(2) - @var{y
 
   LSODE ode (state, tzero, fcn);
 
-  ode.set_options (lsode_opts);
+  ode.set_options (opts);
 
   Matrix output;
   if (crit_times_set)
@@ -408,7 +510,14 @@ fvdp = @@(@var{y},@var{t}) [@var{y}(2); (1 - @var{y}(1)^2) * @var{y}(2) - @var{y
   octave_value_list retval (3);
 
   if (ode.integration_ok ())
-    retval(0) = output;
+    {
+      if (ensemble_rows > 0)
+        retval(0) = NDArray (output.reshape (dim_vector (output.rows (),
+                                                         ensemble_rows,
+                                                         n_ens)));
+      else
+        retval(0) = output;
+    }
   else if (nargout < 2)
     error ("lsode: %s", msg.c_str ());
   else
@@ -487,6 +596,58 @@ fvdp = @@(@var{y},@var{t}) [@var{y}(2); (1 - @var{y}(1)^2) * @var{y}(2) - @var{y
 %!
 %! assert (x, y, tol);
 
+## Nested calls
+%!function xdot = __f (x, t)
+%!  y = lsode (@(y, s) 2, 0, [0; 1]);
+%!  xdot = -y(end) * x;
+%!endfunction
+%!test
+%! x = lsode ("__f", 1, [0; 1]);
+%! assert (x(end), exp (-2), 1e-6);
+
+## Ensemble of initial states
+%!test
+%! k = [1, 2, 3];
+%! t = [0; 0.5; 1];
+%! x = lsode (@(x, t) [-k; -2*k] .* x, [1, 1, 1; 2, 2, 2], t);
+%! assert (size (x), [3, 2, 3]);
+%! assert (squeeze (x(:,1,:)), exp (-t * k), 1e-6);
+%! assert (squeeze (x(:,2,:)), 2 * exp (-2 * t * k), 1e-6);
+
+## Ensemble of scalar ODEs
+%!test
+%! k = [1, 2, 3];
+%! t = [0; 0.5; 1];
+%! lsode_options ("ensemble", "elements");
+%! unwind_protect
+%!   x = lsode (@(x, t) -k .* x, [1, 1, 1], t);
+%!   y = lsode (@(x, t) -x, [4; 5], t);
+%! unwind_protect_cleanup
+%!   lsode_options ("ensemble", "columns");
+%! end_unwind_protect
+%! assert (size (x), [3, 1, 3]);
+%! assert (squeeze (x), exp (-t * k), 1e-6);
+%! assert (squeeze (y), exp (-t) * [4, 5], 1e-5);
+
+## By default, a row vector X_0 is the state of a single system
+%!test
+%! x = lsode (@(x, t) [-x(2); x(1)], [1, 0], [0; pi/2]);
+%! assert (size (x), [2, 2]);
+%! assert (x(end,:), [0, 1], 1e-6);
+
+%!error <Jacobian function may not be used>
+%! lsode ({@(x, t) -x, @(x, t) -eye (2)}, ones (2), [0; 1]);
+
+%!error <X_0 must be a vector>
+%! lsode_options ("ensemble", "elements");
+%! unwind_protect
+%!   lsode (@(x, t) -x, ones (2), [0; 1]);
+%! unwind_protect_cleanup
+%!   lsode_options ("ensemble", "columns");
+%! end_unwind_protect
+
+%!error <ensemble must be> lsode_options ("ensemble", "rows")
+
 %!test
 %! lsode_options ("absolute tolerance", eps);
 %! assert (lsode_options ("absolute tolerance") == eps);
@@ -983,6 +983,16 @@ To compute the matrix exponential, @pxref{Linear Algebra}.
 %!assert (exp ([Inf, -Inf, NaN]), [Inf 0 NaN])
 %!assert (exp (single ([Inf, -Inf, NaN])), single ([Inf 0 NaN]))
 
+## Large arrays may be processed in parallel
+%!test
+%! x = linspace (-10, 10, 1e6);
+%! y = exp (x);
+%! assert (y(1:1e5:end), arrayfun (@exp, x(1:1e5:end)));
+%! assert (y(end), exp (10));
+%! y = exp (single (x));
+%! assert (class (y), "single");
+%! assert (y(end), exp (single (10)));
+
 %!error exp ()
 %!error exp (1, 2)
 */
@@ -1748,6 +1758,21 @@ To compute the matrix logarithm, @pxref{Linear Algebra}.
 %!assert (log (single ([-0.5, -1.5, -2.5])),
 %!        single (log ([0.5, 1.5, 2.5]) + pi*1i), 4* eps ("single"))
 
+## Large arrays may be processed in parallel
+%!test
+%! x = linspace (1, 100, 1e6);
+%! y = log (x);
+%! assert (isreal (y));
+%! assert (y([1, end]), [0, log(100)]);
+%! x(end) = -1;
+%! y = log (x);
+%! assert (iscomplex (y));
+%! assert (y(end), pi*1i);
+%! assert (real (y(1:end-1)), log (x(1:end-1)));
+%! y = log (single (x));
+%! assert (class (y), "single");
+%! assert (y(end), single (pi*1i));
+
 %!error log ()
 %!error log (1, 2)
 */
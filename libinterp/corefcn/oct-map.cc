@@ -27,6 +27,8 @@
 #  include "config.h"
 #endif
 
+#include <functional>
+
 #include "Array-util.h"
 #include "error.h"
 #include "oct-locbuf.h"
@@ -35,6 +37,74 @@
 #include "oct-map.h"
 #include "utils.h"
 
+const octave_fields::fields_rep::value_type *
+octave_fields::fields_rep::lookup (const std::string& key) const
+{
+  if (m_slots.empty ())
+    return nullptr;
+
+  std::size_t hash = std::hash<std::string> () (key);
+  std::size_t mask = m_slots.size () - 1;
+
+  for (std::size_t i = hash & mask; ; i = (i + 1) & mask)
+    {
+      const slot& s = m_slots[i];
+
+      if (! s.entry)
+        return nullptr;
+
+      if (s.hash == hash && s.entry->first == key)
+        return s.entry;
+    }
+}
+
+void
+octave_fields::fields_rep::insert_field (const std::string& key,
+                                         octave_idx_type idx)
+{
+  auto p = emplace (key, idx);
+
+  if (! p.second)
+    p.first->second = idx;
+  else if (2 * size () > m_slots.size ())
+    rehash ();
+  else
+    insert_slot (std::hash<std::string> () (key), &*p.first);
+}
+
+void
+octave_fields::fields_rep::erase_field (const std::string& key)
+{
+  // Removing fields is rare, so just rebuild the table.
+  if (erase (key))
+    rehash ();
+}
+
+void
+octave_fields::fields_rep::rehash ()
+{
+  std::size_t nslots = 8;
+  while (nslots < 2 * size ())
+    nslots *= 2;
+
+  m_slots.assign (nslots, slot {0, nullptr});
+
+  for (auto& fld_idx : *this)
+    insert_slot (std::hash<std::string> () (fld_idx.first), &fld_idx);
+}
+
+void
+octave_fields::fields_rep::insert_slot (std::size_t hash, value_type *entry)
+{
+  std::size_t mask = m_slots.size () - 1;
+
+  std::size_t i = hash & mask;
+  while (m_slots[i].entry)
+    i = (i + 1) & mask;
+
+  m_slots[i] = slot {hash, entry};
+}
+
 octave_fields::fields_rep *
 octave_fields::nil_rep ()
 {
@@ -47,7 +117,7 @@ octave_fields::octave_fields (const string_vector& fields)
 {
   octave_idx_type n = fields.numel ();
   for (octave_idx_type i = 0; i < n; i++)
-    (*m_rep)[fields(i)] = i;
+    m_rep->insert_field (fields(i), i);
 }
 
 octave_fields::octave_fields (const char *const *fields)
@@ -55,47 +125,48 @@ octave_fields::octave_fields (const char *const *fields)
 {
   octave_idx_type n = 0;
   while (*fields)
-    (*m_rep)[std::string (*fields++)] = n++;
+    m_rep->insert_field (std::string (*fields++), n++);
 }
 
 bool
 octave_fields::isfield (const std::string& field) const
 {
-  return m_rep->find (field) != m_rep->end ();
+  return m_rep->lookup (field) != nullptr;
 }
 
 octave_idx_type
 octave_fields::getfield (const std::string& field) const
 {
-  auto p = m_rep->find (field);
-  return (p != m_rep->end ()) ? p->second : -1;
+  auto p = m_rep->lookup (field);
+  return p ? p->second : -1;
 }
 
 octave_idx_type
 octave_fields::getfield (const std::string& field)
 {
-  auto p = m_rep->find (field);
-  if (p != m_rep->end ())
+  auto p = m_rep->lookup (field);
+  if (p)
     return p->second;
   else
     {
       make_unique ();
       octave_idx_type n = m_rep->size ();
-      return (*m_rep)[field] = n;
+      m_rep->insert_field (field, n);
+      return n;
     }
 }
 
 octave_idx_type
 octave_fields::rmfield (const std::string& field)
 {
-  auto p = m_rep->find (field);
-  if (p == m_rep->end ())
+  auto p = m_rep->lookup (field);
+  if (! p)
     return -1;
   else
     {
       octave_idx_type n = p->second;
       make_unique ();
-      m_rep->erase (field);
+      m_rep->erase_field (field);
       for (auto& fld_idx : *m_rep)
         {
           if (fld_idx.second >= n)
@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <map>
+#include <vector>
 
 #include "oct-refcount.h"
 
@@ -42,19 +43,54 @@ class string_vector;
 class OCTINTERP_API
 octave_fields
 {
+  // The fields are kept in a std::map for iteration in sorted order.
+  // Lookups by name go through an open addressing hash table of
+  // pointers to the map entries, which stores the hash of each name.
+
   class fields_rep : public std::map<std::string, octave_idx_type>
   {
   public:
 
-    fields_rep () : std::map<std::string, octave_idx_type> (), m_count (1) { }
+    fields_rep ()
+      : std::map<std::string, octave_idx_type> (), m_slots (), m_count (1)
+    { }
 
     fields_rep (const fields_rep& other)
-      : std::map<std::string, octave_idx_type> (other), m_count (1) { }
+      : std::map<std::string, octave_idx_type> (other), m_slots (),
+        m_count (1)
+    {
+      rehash ();
+    }
 
     fields_rep& operator = (const fields_rep&) = delete;
 
     ~fields_rep () = default;
 
+    // Return the entry for KEY, or nullptr if there is none.
+    const value_type * lookup (const std::string& key) const;
+
+    void insert_field (const std::string& key, octave_idx_type idx);
+
+    void erase_field (const std::string& key);
+
+  private:
+
+    struct slot
+    {
+      std::size_t hash;
+      value_type *entry;
+    };
+
+    void rehash ();
+
+    void insert_slot (std::size_t hash, value_type *entry);
+
+    // The number of slots is a power of two and at least twice the
+    // number of fields.  Empty slots have a null entry.
+    std::vector<slot> m_slots;
+
+  public:
+
     octave::refcount<octave_idx_type> m_count;
   };
 
@@ -30,9 +30,12 @@
 #include <cmath>
 
 #include <algorithm>
+#include <string>
 
 #include "lo-ieee.h"
 #include "oct-locbuf.h"
+#include "oct-parallel.h"
+#include "oct-string.h"
 
 #include "defun.h"
 #include "error.h"
@@ -65,6 +68,19 @@ static constexpr double DROP_RELTOL = std::numeric_limits<double>::epsilon () *
 
 // Some constants and matrices that we'll need.
 
+// Degree, stride in the 33 nodes, and offset of the coefficients in
+// the interval's coefficient array of each of the four rules.
+static const int rule_degree[4] = { 4, 8, 16, 32 };
+static const int rule_skip[4] = { 8, 4, 2, 1 };
+static const int rule_offset[4] = { 0, 5, 14, 31 };
+
+// Weight of the first Legendre coefficient in the integral.
+static const double c0_weight = M_SQRT2 / 2;
+
+// Number of subdivisions in which the first coefficient grows after
+// which the integral is considered divergent.
+static const int ndiv_max = 20;
+
 static const double xi[33] =
 {
   -1., -0.99518472667219688624, -0.98078528040323044912,
@@ -1486,6 +1502,254 @@ downdate (double *c, int n, int d, int *nans, int nnans)
     }
 }
 
+// Store in JDX the indices into the function values of the nodes of
+// degree D that have not been evaluated yet and return their number.
+// A new interval (D == 0) already has the values at its end points.
+
+static int
+cquad_missing_nodes (int d, int *jdx)
+{
+  int nj = 0;
+
+  if (d == 0)
+    {
+      for (int j = rule_skip[0]; j < 32; j += rule_skip[0])
+        jdx[nj++] = j;
+    }
+  else
+    {
+      for (int j = rule_skip[d]; j < 32; j += 2 * rule_skip[d])
+        jdx[nj++] = j;
+    }
+
+  return nj;
+}
+
+// Evaluate the integrand at the missing nodes of the NIV intervals IVS,
+// where DS gives the degree of the rule of each interval.  The nodes of
+// all intervals are passed to F in a single call.
+
+static void
+cquad_eval (interpreter& interp, const octave_value& fcn, bool wrap,
+            cquad_ival *const *ivs, const int *ds, int niv, int& neval)
+{
+  int jdx[32];
+  octave_idx_type nx = 0;
+
+  for (int k = 0; k < niv; k++)
+    nx += cquad_missing_nodes (ds[k], jdx);
+
+  ColumnVector ex (nx);
+
+  nx = 0;
+  for (int k = 0; k < niv; k++)
+    {
+      double m = (ivs[k]->a + ivs[k]->b) / 2;
+      double h = (ivs[k]->b - ivs[k]->a) / 2;
+      int nj = cquad_missing_nodes (ds[k], jdx);
+
+      if (wrap)
+        {
+          for (int i = 0; i < nj; i++)
+            ex(nx++) = tan (M_PI/2 * (m + xi[jdx[i]] * h));
+        }
+      else
+        {
+          for (int i = 0; i < nj; i++)
+            ex(nx++) = m + xi[jdx[i]] * h;
+        }
+    }
+
+  octave_value_list fvals = interp.feval (fcn, ovl (ex), 1);
+  if (fvals.length () != 1 || ! fvals(0).is_real_matrix ())
+    error ("quadcc: integrand F must return a single, real-valued vector");
+
+  Matrix effex = fvals(0).matrix_value ();
+  if (effex.numel () != ex.numel ())
+    error ("quadcc: integrand F must return a single, real-valued vector of the same size as the input");
+
+  neval += effex.numel ();
+
+  nx = 0;
+  for (int k = 0; k < niv; k++)
+    {
+      int nj = cquad_missing_nodes (ds[k], jdx);
+
+      for (int i = 0; i < nj; i++, nx++)
+        {
+          double& fx = ivs[k]->fx[jdx[i]];
+          fx = effex(nx);
+          if (wrap)
+            {
+              double xw = ex(nx);
+              fx *= (1.0 + xw*xw) * M_PI/2;
+            }
+        }
+    }
+}
+
+// Update the coefficients, integral and error estimate of IV once the
+// function values at the nodes of degree D are available.  Return true
+// if the interval should be split prematurely.
+
+static bool
+cquad_update_degree (cquad_ival *iv, int d)
+{
+  double h = (iv->b - iv->a) / 2;
+  double nc, ncdiff, temp;
+  int nnans = 0;
+  int nans[33];
+
+  for (int i = 0; i <= 32; i += rule_skip[d])
+    {
+      if (! math::isfinite (iv->fx[i]))
+        {
+          nans[nnans++] = i;
+          iv->fx[i] = 0.0;
+        }
+    }
+
+  // Compute the new coefficients.
+  Vinvfx (iv->fx, &(iv->c[rule_offset[d]]), d);
+  // Downdate any NaNs.
+  if (nnans > 0)
+    {
+      downdate (&(iv->c[rule_offset[d]]), rule_degree[d], d, nans, nnans);
+      for (int i = 0; i < nnans; i++)
+        iv->fx[nans[i]] = numeric_limits<double>::NaN ();
+    }
+
+  // Compute the error estimate.
+  nc = 0.0;
+  for (int i = rule_degree[d - 1] + 1; i <= rule_degree[d]; i++)
+    {
+      temp = iv->c[rule_offset[d] + i];
+      nc += temp * temp;
+    }
+  ncdiff = nc;
+  for (int i = 0; i <= rule_degree[d - 1]; i++)
+    {
+      temp = iv->c[rule_offset[d - 1] + i] - iv->c[rule_offset[d] + i];
+      ncdiff += temp * temp;
+      temp = iv->c[rule_offset[d] + i];
+      nc += temp * temp;
+    }
+  ncdiff = sqrt (ncdiff);
+  nc = sqrt (nc);
+  iv->err = ncdiff * 2 * h;
+  // Compute the local integral.
+  iv->igral = 2 * h * c0_weight * iv->c[rule_offset[d]];
+
+  return (nc > 0 && ncdiff / nc > 0.1);
+}
+
+// Set up the left (LEFT true) or right half IVC of the interval IV.
+
+static void
+cquad_init_child (cquad_ival *ivc, const cquad_ival *iv, bool left)
+{
+  double m = (iv->a + iv->b) / 2;
+
+  ivc->a = (left ? iv->a : m);
+  ivc->b = (left ? m : iv->b);
+  ivc->depth = 0;
+  ivc->rdepth = iv->rdepth + 1;
+  ivc->fx[0] = (left ? iv->fx[0] : iv->fx[16]);
+  ivc->fx[32] = (left ? iv->fx[16] : iv->fx[32]);
+}
+
+// Compute the coefficients, integral and error estimate of the half IVC
+// of the interval IV once its function values are available.  T is the
+// matrix (Tleft or Tright) that projects the coefficients of IV onto
+// IVC.  Return false if the integral appears to diverge.
+
+static bool
+cquad_update_child (cquad_ival *ivc, const cquad_ival *iv, const double *T)
+{
+  double h = (iv->b - iv->a) / 2;
+  double ncdiff, temp;
+  int d = iv->depth;
+  int nnans = 0;
+  int nans[33];
+
+  for (int i = 0; i <= 32; i += rule_skip[0])
+    {
+      if (! math::isfinite (ivc->fx[i]))
+        {
+          nans[nnans++] = i;
+          ivc->fx[i] = 0.0;
+        }
+    }
+  Vinvfx (ivc->fx, ivc->c, 0);
+  if (nnans > 0)
+    {
+      downdate (ivc->c, rule_degree[0], 0, nans, nnans);
+      for (int i = 0; i < nnans; i++)
+        ivc->fx[nans[i]] = numeric_limits<double>::NaN ();
+    }
+  for (int i = 0; i <= rule_degree[d]; i++)
+    {
+      ivc->c[rule_offset[d] + i] = 0.0;
+      for (int j = i; j <= rule_degree[d]; j++)
+        ivc->c[rule_offset[d] + i] += T[i*33 + j] * iv->c[rule_offset[d] + j];
+    }
+  ncdiff = 0.0;
+  for (int i = 0; i <= rule_degree[0]; i++)
+    {
+      temp = ivc->c[i] - ivc->c[rule_offset[d] + i];
+      ncdiff += temp * temp;
+    }
+  for (int i = rule_degree[0] + 1; i <= rule_degree[d]; i++)
+    {
+      temp = ivc->c[rule_offset[d] + i];
+      ncdiff += temp * temp;
+    }
+  ncdiff = sqrt (ncdiff);
+  ivc->err = ncdiff * h;
+  // Compute the local integral.
+  ivc->igral = h * c0_weight * ivc->c[0];
+
+  // Check for divergence.
+  ivc->ndiv = iv->ndiv + (fabs (iv->c[0]) > 0 && ivc->c[0] / iv->c[0] > 2);
+
+  return ! (ivc->ndiv > ndiv_max && 2*ivc->ndiv > ivc->rdepth);
+}
+
+// Move entry I of the first NIVALS entries of HEAP down until the heap
+// property holds again.
+
+static void
+cquad_sift_down (const cquad_ival *ivals, int *heap, int nivals, int i)
+{
+  while (2*i + 1 < nivals)
+    {
+      int j = 2*i + 1;
+      if (j + 1 < nivals && ivals[heap[j + 1]].err >= ivals[heap[j]].err)
+        j++;
+      if (ivals[heap[j]].err <= ivals[heap[i]].err)
+        break;
+
+      std::swap (heap[j], heap[i]);
+      i = j;
+    }
+}
+
+// Move entry I of HEAP up until the heap property holds again.
+
+static void
+cquad_sift_up (const cquad_ival *ivals, int *heap, int i)
+{
+  while (i > 0)
+    {
+      int j = (i - 1) / 2;
+      if (ivals[heap[j]].err >= ivals[heap[i]].err)
+        break;
+
+      std::swap (heap[j], heap[i]);
+      i = j;
+    }
+}
+
 // The actual integration routine.
 
 DEFMETHOD (quadcc, interp, args, nargout,
@@ -1493,6 +1757,7 @@ DEFMETHOD (quadcc, interp, args, nargout,
 @deftypefn  {} {@var{q} =} quadcc (@var{f}, @var{a}, @var{b})
 @deftypefnx {} {@var{q} =} quadcc (@var{f}, @var{a}, @var{b}, @var{tol})
 @deftypefnx {} {@var{q} =} quadcc (@var{f}, @var{a}, @var{b}, @var{tol}, @var{sing})
+@deftypefnx {} {@var{q} =} quadcc (@dots{}, "BatchSize", @var{nb})
 @deftypefnx {} {[@var{q}, @var{err}, @var{nr_points}] =} quadcc (@dots{})
 Numerically evaluate the integral of @var{f} from @var{a} to @var{b} using
 doubly-adaptive @nospell{Clenshaw-Curtis} quadrature.
@@ -1530,6 +1795,21 @@ x=1, the call to @code{quadcc} would be as follows
 int = quadcc (f, a, b, [], [ 1 ]);
 @end example
 
+By default, the subinterval with the largest error estimate is processed on
+each step, and @var{f} is called with the nodes of a single subinterval.  For
+a cheap integrand, the overhead of each call to @var{f} can then dominate the
+run time.  The optional property @qcode{"BatchSize"} instead processes up to
+@var{nb} of the subintervals with the largest error estimates on each step and
+passes the nodes of all of them to @var{f} in a single call.  The remaining
+work on these subintervals is done in parallel if Octave was built with
+OpenMP.  Batching may evaluate the integrand at more points than necessary,
+so it pays off only if the cost of a call to @var{f} is dominated by its
+overhead rather than by the number of points.  For example,
+
+@example
+q = quadcc (@@(x) exp (-x.^2), -Inf, Inf, [], [], "BatchSize", 32);
+@end example
+
 The result of the integration is returned in @var{q}.
 
 @var{err} is an estimate of the absolute integration error.
@@ -1565,13 +1845,6 @@ Mathematical Software, Vol.@: 37, Issue 3, Article No.@: 3, 2010.
 @seealso{quad, quadv, quadl, quadgk, trapz, dblquad, triplequad}
 @end deftypefn */)
 {
-  // Some constants that we will need.
-  static const int n[4] = { 4, 8, 16, 32 };
-  static const int skip[4] = { 8, 4, 2, 1 };
-  static const int idx[4] = { 0, 5, 14, 31 };
-  static const double w = M_SQRT2 / 2;
-  static const int ndiv_max = 20;
-
   // Arguments left and right.
   int nargin = args.length ();
   octave_value fcn;
@@ -1586,7 +1859,7 @@ Mathematical Software, Vol.@: 37, Issue 3, Article No.@: 3, 2010.
   octave_value_list fargs, fvals;
 
   // Actual variables (as opposed to constants above).
-  double m, h, ml, hl, mr, hr, temp;
+  double m, h, temp;
   double igral, err, igral_final, err_final;
   int nivals;
   int neval = 0;
@@ -1599,6 +1872,36 @@ Mathematical Software, Vol.@: 37, Issue 3, Article No.@: 3, 2010.
   if (nargin < 3)
     print_usage ();
 
+  // Any property/value pairs follow the positional arguments.
+  int nargs = nargin;
+  for (i = 3; i < nargin; i++)
+    {
+      if (args(i).is_string ())
+        {
+          nargs = i;
+          break;
+        }
+    }
+
+  if ((nargin - nargs) % 2 != 0)
+    error ("quadcc: property/value options must occur in pairs");
+
+  int batch_size = 1;
+  for (i = nargs; i < nargin; i += 2)
+    {
+      std::string prop
+        = args(i).xstring_value ("quadcc: property name must be a string");
+
+      if (string::strcmpi (prop, "BatchSize"))
+        {
+          batch_size = args(i+1).xint_value ("quadcc: BatchSize must be a positive integer");
+          if (batch_size < 1)
+            error ("quadcc: BatchSize must be a positive integer");
+        }
+      else
+        error ("quadcc: unknown property '%s'", prop.c_str ());
+    }
+
   fcn = get_function_handle (interp, args(0), "x");
 
   if (! args(1).is_real_scalar ())
@@ -1611,7 +1914,7 @@ Mathematical Software, Vol.@: 37, Issue 3, Article No.@: 3, 2010.
   b = args(2).double_value ();
   issingle = (issingle || args(2).is_single_type ());
 
-  if (nargin < 4 || args(3).isempty ())
+  if (nargs < 4 || args(3).isempty ())
     {
       if (issingle)
         {
@@ -1649,7 +1952,7 @@ Mathematical Software, Vol.@: 37, Issue 3, Article No.@: 3, 2010.
         }
     }
 
-  if (nargin < 5)
+  if (nargs < 5)
     nivals = 1;
   else if (! (args(4).is_real_scalar () || args(4).is_real_matrix ()))
     error ("quadcc: list of singularities (SING) must be a vector of real values");
@@ -1663,6 +1966,17 @@ Mathematical Software, Vol.@: 37, Issue 3, Article No.@: 3, 2010.
   OCTAVE_LOCAL_BUFFER (double, iivals, cquad_heapsize);
   OCTAVE_LOCAL_BUFFER (int, heap, cquad_heapsize);
 
+  // Work space for processing intervals in batches.  No more than half
+  // of the heap can be split at once.
+  batch_size = std::min (batch_size, cquad_heapsize / 2);
+  OCTAVE_LOCAL_BUFFER (cquad_ival *, bivs, batch_size);
+  OCTAVE_LOCAL_BUFFER (cquad_ival *, bparent, batch_size);
+  OCTAVE_LOCAL_BUFFER (cquad_ival *, bkids, 2 * batch_size);
+  OCTAVE_LOCAL_BUFFER (int, bdepth, 2 * batch_size);
+  OCTAVE_LOCAL_BUFFER (int, bsplit, batch_size);
+  OCTAVE_LOCAL_BUFFER (int, bkeep, 2 * batch_size);
+  OCTAVE_LOCAL_BUFFER (int, bfree, batch_size);
+
   if (nivals == 1)
     {
       iivals[0] = a;
@@ -1706,12 +2020,12 @@ Mathematical Software, Vol.@: 37, Issue 3, Article No.@: 3, 2010.
       ColumnVector ex (33);
       if (wrap)
         {
-          for (i = 0; i <= n[3]; i++)
+          for (i = 0; i <= rule_degree[3]; i++)
             ex(i) = tan (M_PI/2 * (m + xi[i]*h));
         }
       else
         {
-          for (i = 0; i <= n[3]; i++)
+          for (i = 0; i <= rule_degree[3]; i++)
             ex(i) = m + xi[i]*h;
         }
       fargs(0) = ex;
@@ -1723,7 +2037,7 @@ Mathematical Software, Vol.@: 37, Issue 3, Article No.@: 3, 2010.
       if (effex.numel () != ex.numel ())
         error ("quadcc: integrand F must return a single, real-valued vector of the same size as the input");
 
-      for (i = 0; i <= n[3]; i++)
+      for (i = 0; i <= rule_degree[3]; i++)
         {
           iv->fx[i] = effex(i);
           if (wrap)
@@ -1738,8 +2052,8 @@ Mathematical Software, Vol.@: 37, Issue 3, Article No.@: 3, 2010.
               iv->fx[i] = 0.0;
             }
         }
-      Vinvfx (iv->fx, &(iv->c[idx[3]]), 3);
-      Vinvfx (iv->fx, &(iv->c[idx[2]]), 2);
+      Vinvfx (iv->fx, &(iv->c[rule_offset[3]]), 3);
+      Vinvfx (iv->fx, &(iv->c[rule_offset[2]]), 2);
       Vinvfx (iv->fx, &(iv->c[0]), 0);
       for (i = 0; i < nnans; i++)
         iv->fx[nans[i]] = numeric_limits<double>::NaN ();
@@ -1748,19 +2062,19 @@ Mathematical Software, Vol.@: 37, Issue 3, Article No.@: 3, 2010.
       iv->depth = 3;
       iv->rdepth = 1;
       iv->ndiv = 0;
-      iv->igral = 2 * h * iv->c[idx[3]] * w;
+      iv->igral = 2 * h * iv->c[rule_offset[3]] * c0_weight;
       nc = 0.0;
-      for (i = n[2] + 1; i <= n[3]; i++)
+      for (i = rule_degree[2] + 1; i <= rule_degree[3]; i++)
         {
-          temp = iv->c[idx[3] + i];
+          temp = iv->c[rule_offset[3] + i];
           nc += temp * temp;
         }
       ncdiff = nc;
-      for (i = 0; i <= n[2]; i++)
+      for (i = 0; i <= rule_degree[2]; i++)
         {
-          temp = iv->c[idx[2] + i] - iv->c[idx[3] + i];
+          temp = iv->c[rule_offset[2] + i] - iv->c[rule_offset[3] + i];
           ncdiff += temp * temp;
-          temp = iv->c[idx[3] + i];
+          temp = iv->c[rule_offset[3] + i];
           nc += temp * temp;
         }
       ncdiff = sqrt (ncdiff);
@@ -1795,382 +2109,225 @@ Mathematical Software, Vol.@: 37, Issue 3, Article No.@: 3, 2010.
       // Allow the user to interrupt.
       octave_quit ();
 
-      // Put our finger on the interval with the largest error.
-      iv = &(ivals[heap[0]]);
-      m = (iv->a + iv->b) / 2;
-      h = (iv->b - iv->a) / 2;
-
-#if (DEBUG_QUADCC)
-      printf ("quadcc: processing ival %i (of %i) with [%e,%e] int=%e, err=%e, depth=%i\n",
-              heap[0], nivals, iv->a, iv->b, iv->igral, iv->err, iv->depth);
-#endif
-
-      // Should we try to increase the degree?
-      if (iv->depth < 3)
+      if (batch_size > 1)
         {
-          // Keep tabs on some variables.
-          d = ++iv->depth;
-
-          // Get the new (missing) function values.
-          {
-            ColumnVector ex (n[d] / 2);
-            if (wrap)
-              {
-                for (i = 0; i < n[d] / 2; i++)
-                  ex(i) = tan (M_PI/2 * (m + xi[(2*i + 1) * skip[d]] * h));
-              }
-            else
-              {
-                for (i = 0; i < n[d] / 2; i++)
-                  ex(i) = m + xi[(2*i + 1) * skip[d]] * h;
-              }
-            fargs(0) = ex;
-            fvals = interp.feval (fcn, fargs, 1);
-            if (fvals.length () != 1 || ! fvals(0).is_real_matrix ())
-              error ("quadcc: integrand F must return a single, real-valued vector");
-
-            Matrix effex = fvals(0).matrix_value ();
-            if (effex.numel () != ex.numel ())
-              error ("quadcc: integrand F must return a single, real-valued vector of the same size as the input");
-
-            neval += effex.numel ();
-            for (i = 0; i < n[d] / 2; i++)
-              {
-                j = (2*i + 1) * skip[d];
-                iv->fx[j] = effex(i);
-                if (wrap)
-                  {
-                    xw = ex(i);
-                    iv->fx[j] *= (1.0 + xw*xw) * M_PI/2;
-                  }
-              }
-          }
-          nnans = 0;
-          for (i = 0; i <= 32; i += skip[d])
+          // Process up to BATCH_SIZE of the intervals with the largest
+          // errors at once, leaving room on the heap for their halves.
+          int nb = std::min ({batch_size, nivals,
+                              std::max (1, (cquad_heapsize - nivals) / 2)});
+          int nivals0 = nivals;
+
+          // Pop them off the heap.  They end up in
+          // heap[nivals .. nivals0-1], and the halves of the intervals
+          // that are split are put in heap[nivals0 ...].
+          for (i = 0; i < nb; i++)
             {
-              if (! math::isfinite (iv->fx[i]))
-                {
-                  nans[nnans++] = i;
-                  iv->fx[i] = 0.0;
-                }
+              std::swap (heap[nivals - 1], heap[0]);
+              nivals--;
+              cquad_sift_down (ivals, heap, nivals, 0);
             }
 
-          // Compute the new coefficients.
-          Vinvfx (iv->fx, &(iv->c[idx[d]]), d);
-          // Downdate any NaNs.
-          if (nnans > 0)
+          // Increase the degree of all intervals for which this is
+          // still possible, evaluating all new nodes in one call.
+          int ninc = 0;
+          for (i = 0; i < nb; i++)
             {
-              downdate (&(iv->c[idx[d]]), n[d], d, nans, nnans);
-              for (i = 0; i < nnans; i++)
-                iv->fx[nans[i]] = numeric_limits<double>::NaN ();
+              iv = &(ivals[heap[nivals + i]]);
+              if (iv->depth < 3)
+                {
+                  bdepth[ninc] = ++iv->depth;
+                  bivs[ninc++] = iv;
+                }
             }
 
-          // Compute the error estimate.
-          nc = 0.0;
-          for (i = n[d - 1] + 1; i <= n[d]; i++)
+          if (ninc > 0)
             {
-              temp = iv->c[idx[d] + i];
-              nc += temp * temp;
-            }
-          ncdiff = nc;
-          for (i = 0; i <= n[d - 1]; i++)
-            {
-              temp = iv->c[idx[d - 1] + i] - iv->c[idx[d] + i];
-              ncdiff += temp * temp;
-              temp = iv->c[idx[d] + i];
-              nc += temp * temp;
-            }
-          ncdiff = sqrt (ncdiff);
-          nc = sqrt (nc);
-          iv->err = ncdiff * 2 * h;
-          // Compute the local integral.
-          iv->igral = 2 * h * w * iv->c[idx[d]];
-          // Split the interval prematurely?
-          split = (nc > 0 && ncdiff / nc > 0.1);
-        }
-      else
-        {
-          // Maximum degree reached, just split.
-          split = 1;
-        }
+              cquad_eval (interp, fcn, wrap, bivs, bdepth, ninc, neval);
 
-      // Should we drop this interval?
-      if ((m + h*xi[0]) >= (m + h*xi[1])
-          || (m + h*xi[31]) >= (m + h*xi[32])
-          || iv->err < fabs (iv->igral) * DROP_RELTOL)
-        {
-#if (DEBUG_QUADCC)
-          printf ("quadcc: dropping ival %i (of %i) with [%e,%e] int=%e, err=%e, depth=%i\n",
-                  heap[0], nivals, iv->a, iv->b, iv->igral, iv->err, iv->depth);
-#endif
+              // This does not call back into the interpreter, so the
+              // intervals can be updated concurrently.
+              parallel_for (ninc, 8, [&] (octave_idx_type lo,
+                                          octave_idx_type hi)
+                {
+                  for (octave_idx_type k = lo; k < hi; k++)
+                    bsplit[k] = cquad_update_degree (bivs[k], bdepth[k]);
+                });
+            }
 
-          // Keep this interval's contribution.
-          err_final += iv->err;
-          igral_final += iv->igral;
-          // Swap with the last element on the heap.
-          std::swap (heap[nivals - 1], heap[0]);
-          nivals--;
-          // Fix up the heap.
-          i = 0;
-          while (2*i + 1 < nivals)
+          // Decide what to do with each interval: drop it, keep it, or
+          // split it.  Intervals of maximum degree are always split.
+          int nsplit = 0;
+          int nkeep = 0;
+          int ndrop = 0;
+          for (i = 0, j = 0; i < nb; i++)
             {
-              // Get the kids.
-              j = 2*i + 1;
-              // If the j+1st entry exists and is larger than the jth,
-              // use it instead.
-              if (j + 1 < nivals
-                  && ivals[heap[j + 1]].err >= ivals[heap[j]].err)
-                j++;
-              // Do we need to move the ith entry up?
-              if (ivals[heap[j]].err <= ivals[heap[i]].err)
-                break;
+              int ii = heap[nivals + i];
+              iv = &(ivals[ii]);
+              if (j < ninc && bivs[j] == iv)
+                split = bsplit[j++];
               else
+                split = 1;
+
+              m = (iv->a + iv->b) / 2;
+              h = (iv->b - iv->a) / 2;
+
+              if ((m + h*xi[0]) >= (m + h*xi[1])
+                  || (m + h*xi[31]) >= (m + h*xi[32])
+                  || iv->err < fabs (iv->igral) * DROP_RELTOL)
                 {
-                  std::swap (heap[j], heap[i]);
-                  i = j;
+                  // Keep this interval's contribution.
+                  err_final += iv->err;
+                  igral_final += iv->igral;
+                  bfree[ndrop++] = ii;
                 }
-            }
-        }
-      else if (split)
-        {
-          // Some values we will need often...
-          d = iv->depth;
-          // Generate the interval on the left.
-          ivl = &(ivals[heap[nivals++]]);
-          ivl->a = iv->a;
-          ivl->b = m;
-          ml = (ivl->a + ivl->b) / 2;
-          hl = h / 2;
-          ivl->depth = 0;
-          ivl->rdepth = iv->rdepth + 1;
-          ivl->fx[0] = iv->fx[0];
-          ivl->fx[32] = iv->fx[16];
-          {
-            ColumnVector ex (n[0] - 1);
-            if (wrap)
-              {
-                for (i = 0; i < n[0] - 1; i++)
-                  ex(i) = tan (M_PI/2 * (ml + xi[(i + 1) * skip[0]] * hl));
-              }
-            else
-              {
-                for (i = 0; i < n[0] - 1; i++)
-                  ex(i) = ml + xi[(i + 1) * skip[0]] * hl;
-              }
-            fargs(0) = ex;
-            fvals = interp.feval (fcn, fargs, 1);
-            if (fvals.length () != 1 || ! fvals(0).is_real_matrix ())
-              error ("quadcc: integrand F must return a single, real-valued vector");
-
-            Matrix effex = fvals(0).matrix_value ();
-            if (effex.numel () != ex.numel ())
-              error ("quadcc: integrand F must return a single, real-valued vector of the same size as the input");
-
-            neval += effex.numel ();
-            for (i = 0; i < n[0] - 1; i++)
-              {
-                j = (i + 1) * skip[0];
-                ivl->fx[j] = effex(i);
-                if (wrap)
-                  {
-                    xw = ex(i);
-                    ivl->fx[j] *= (1.0 + xw*xw) * M_PI/2;
-                  }
-              }
-          }
-          nnans = 0;
-          for (i = 0; i <= 32; i += skip[0])
-            {
-              if (! math::isfinite (ivl->fx[i]))
+              else if (split)
                 {
-                  nans[nnans++] = i;
-                  ivl->fx[i] = 0.0;
+                  int il = heap[nivals0 + 2*nsplit];
+                  int ir = heap[nivals0 + 2*nsplit + 1];
+                  cquad_init_child (&(ivals[il]), iv, true);
+                  cquad_init_child (&(ivals[ir]), iv, false);
+                  bparent[nsplit] = iv;
+                  bkids[2*nsplit] = &(ivals[il]);
+                  bkids[2*nsplit + 1] = &(ivals[ir]);
+                  bkeep[nkeep++] = il;
+                  bkeep[nkeep++] = ir;
+                  bfree[ndrop++] = ii;
+                  nsplit++;
                 }
+              else
+                bkeep[nkeep++] = ii;
             }
-          Vinvfx (ivl->fx, ivl->c, 0);
-          if (nnans > 0)
-            {
-              downdate (ivl->c, n[0], 0, nans, nnans);
-              for (i = 0; i < nnans; i++)
-                ivl->fx[nans[i]] = numeric_limits<double>::NaN ();
-            }
-          for (i = 0; i <= n[d]; i++)
-            {
-              ivl->c[idx[d] + i] = 0.0;
-              for (j = i; j <= n[d]; j++)
-                ivl->c[idx[d] + i] += Tleft[i*33 + j] * iv->c[idx[d] + j];
-            }
-          ncdiff = 0.0;
-          for (i = 0; i <= n[0]; i++)
-            {
-              temp = ivl->c[i] - ivl->c[idx[d] + i];
-              ncdiff += temp * temp;
-            }
-          for (i = n[0] + 1; i <= n[d]; i++)
+
+          // Evaluate the new nodes of all halves in one call.
+          bool diverged = false;
+          if (nsplit > 0)
             {
-              temp = ivl->c[idx[d] + i];
-              ncdiff += temp * temp;
+              std::fill_n (bdepth, 2*nsplit, 0);
+              cquad_eval (interp, fcn, wrap, bkids, bdepth, 2*nsplit, neval);
+
+              parallel_for (nsplit, 4, [&] (octave_idx_type lo,
+                                            octave_idx_type hi)
+                {
+                  for (octave_idx_type k = lo; k < hi; k++)
+                    {
+                      bsplit[k]
+                        = (cquad_update_child (bkids[2*k], bparent[k], Tleft)
+                           && cquad_update_child (bkids[2*k + 1], bparent[k],
+                                                  Tright));
+                    }
+                });
+
+              for (i = 0; i < nsplit; i++)
+                diverged = diverged || ! bsplit[i];
             }
-          ncdiff = sqrt (ncdiff);
-          ivl->err = ncdiff * h;
-          // Check for divergence.
-          ivl->ndiv = iv->ndiv + (fabs (iv->c[0]) > 0
-                                  && ivl->c[0] / iv->c[0] > 2);
-          if (ivl->ndiv > ndiv_max && 2*ivl->ndiv > ivl->rdepth)
+
+          if (diverged)
             {
               igral = std::copysign (numeric_limits<double>::Inf (), igral);
               warning ("quadcc: divergent integral detected");
               break;
             }
 
-          // Compute the local integral.
-          ivl->igral = h * w * ivl->c[0];
-
-          // Generate the interval on the right.
-          ivr = &(ivals[heap[nivals++]]);
-          ivr->a = m;
-          ivr->b = iv->b;
-          mr = (ivr->a + ivr->b) / 2;
-          hr = h / 2;
-          ivr->depth = 0;
-          ivr->rdepth = iv->rdepth + 1;
-          ivr->fx[0] = iv->fx[16];
-          ivr->fx[32] = iv->fx[32];
-          {
-            ColumnVector ex (n[0] - 1);
-            if (wrap)
-              {
-                for (i = 0; i < n[0] - 1; i++)
-                  ex(i) = tan (M_PI/2 * (mr + xi[(i + 1) * skip[0]] * hr));
-              }
-            else
-              {
-                for (i = 0; i < n[0] - 1; i++)
-                  ex(i) = mr + xi[(i + 1) * skip[0]] * hr;
-              }
-            fargs(0) = ex;
-            fvals = interp.feval (fcn, fargs, 1);
-            if (fvals.length () != 1 || ! fvals(0).is_real_matrix ())
-              error ("quadcc: integrand F must return a single, real-valued vector");
-
-            Matrix effex = fvals(0).matrix_value ();
-            if (effex.numel () != ex.numel ())
-              error ("quadcc: integrand F must return a single, real-valued vector of the same size as the input");
-
-            neval += effex.numel ();
-            for (i = 0; i < n[0] - 1; i++)
-              {
-                j = (i + 1) * skip[0];
-                ivr->fx[j] = effex(i);
-                if (wrap)
-                  {
-                    xw = ex(i);
-                    ivr->fx[j] *= (1.0 + xw*xw) * M_PI/2;
-                  }
-              }
-          }
-          nnans = 0;
-          for (i = 0; i <= 32; i += skip[0])
-            {
-              if (! math::isfinite (ivr->fx[i]))
-                {
-                  nans[nnans++] = i;
-                  ivr->fx[i] = 0.0;
-                }
-            }
-          Vinvfx (ivr->fx, ivr->c, 0);
-          if (nnans > 0)
-            {
-              downdate (ivr->c, n[0], 0, nans, nnans);
-              for (i = 0; i < nnans; i++)
-                ivr->fx[nans[i]] = numeric_limits<double>::NaN ();
-            }
-          for (i = 0; i <= n[d]; i++)
-            {
-              ivr->c[idx[d] + i] = 0.0;
-              for (j = i; j <= n[d]; j++)
-                ivr->c[idx[d] + i] += Tright[i*33 + j] * iv->c[idx[d] + j];
-            }
-          ncdiff = 0.0;
-          for (i = 0; i <= n[0]; i++)
-            {
-              temp = ivr->c[i] - ivr->c[idx[d] + i];
-              ncdiff += temp * temp;
-            }
-          for (i = n[0] + 1; i <= n[d]; i++)
+          // Push the remaining intervals back onto the heap.  The slots
+          // of the dropped and split intervals are freed.
+          std::copy_n (bkeep, nkeep, heap + nivals);
+          std::copy_n (bfree, ndrop, heap + nivals + nkeep);
+          for (i = 0; i < nkeep; i++)
+            cquad_sift_up (ivals, heap, nivals++);
+        }
+      else
+        {
+          // Put our finger on the interval with the largest error.
+          iv = &(ivals[heap[0]]);
+          m = (iv->a + iv->b) / 2;
+          h = (iv->b - iv->a) / 2;
+
+#if (DEBUG_QUADCC)
+          printf ("quadcc: processing ival %i (of %i) with [%e,%e] int=%e, err=%e, depth=%i\n",
+                  heap[0], nivals, iv->a, iv->b, iv->igral, iv->err, iv->depth);
+#endif
+
+          // Should we try to increase the degree?
+          if (iv->depth < 3)
             {
-              temp = ivr->c[idx[d] + i];
-              ncdiff += temp * temp;
+              // Get the new (missing) function values.
+              d = ++iv->depth;
+              cquad_eval (interp, fcn, wrap, &iv, &d, 1, neval);
+
+              // Compute the new coefficients and error estimate, and
+              // decide whether to split the interval prematurely.
+              split = cquad_update_degree (iv, d);
             }
-          ncdiff = sqrt (ncdiff);
-          ivr->err = ncdiff * h;
-          // Check for divergence.
-          ivr->ndiv = iv->ndiv + (fabs (iv->c[0]) > 0
-                                  && ivr->c[0] / iv->c[0] > 2);
-          if (ivr->ndiv > ndiv_max && 2*ivr->ndiv > ivr->rdepth)
+          else
             {
-              igral = std::copysign (numeric_limits<double>::Inf (), igral);
-              warning ("quadcc: divergent integral detected");
-              break;
+              // Maximum degree reached, just split.
+              split = 1;
             }
 
-          // Compute the local integral.
-          ivr->igral = h * w * ivr->c[0];
-
-          // Fix-up the heap: we now have one interval on top that we
-          // don't need any more and two new, unsorted ones at the bottom.
+          // Should we drop this interval?
+          if ((m + h*xi[0]) >= (m + h*xi[1])
+              || (m + h*xi[31]) >= (m + h*xi[32])
+              || iv->err < fabs (iv->igral) * DROP_RELTOL)
+            {
+#if (DEBUG_QUADCC)
+              printf ("quadcc: dropping ival %i (of %i) with [%e,%e] int=%e, err=%e, depth=%i\n",
+                      heap[0], nivals, iv->a, iv->b, iv->igral, iv->err, iv->depth);
+#endif
 
-          // Flip the last interval to the top of the heap and sift down.
-          std::swap (heap[nivals - 1], heap[0]);
-          nivals--;
-          // Sift this interval back down the heap.
-          i = 0;
-          while (2*i + 1 < nivals - 1)
+              // Keep this interval's contribution.
+              err_final += iv->err;
+              igral_final += iv->igral;
+              // Swap with the last element on the heap.
+              std::swap (heap[nivals - 1], heap[0]);
+              nivals--;
+              // Fix up the heap.
+              cquad_sift_down (ivals, heap, nivals, 0);
+            }
+          else if (split)
             {
-              j = 2*i + 1;
-              if (j + 1 < nivals - 1
-                  && ivals[heap[j + 1]].err >= ivals[heap[j]].err)
-                j++;
-              if (ivals[heap[j]].err <= ivals[heap[i]].err)
-                break;
-              else
+              // Generate the interval on the left.
+              ivl = &(ivals[heap[nivals++]]);
+              cquad_init_child (ivl, iv, true);
+              d = 0;
+              cquad_eval (interp, fcn, wrap, &ivl, &d, 1, neval);
+              if (! cquad_update_child (ivl, iv, Tleft))
                 {
-                  std::swap (heap[j], heap[i]);
-                  i = j;
+                  igral = std::copysign (numeric_limits<double>::Inf (),
+                                         igral);
+                  warning ("quadcc: divergent integral detected");
+                  break;
                 }
-            }
 
-          // Now grab the last interval and sift it up the heap.
-          i = nivals - 1;
-          while (i > 0)
-            {
-              j = (i - 1) / 2;
-              if (ivals[heap[j]].err < ivals[heap[i]].err)
+              // Generate the interval on the right.
+              ivr = &(ivals[heap[nivals++]]);
+              cquad_init_child (ivr, iv, false);
+              d = 0;
+              cquad_eval (interp, fcn, wrap, &ivr, &d, 1, neval);
+              if (! cquad_update_child (ivr, iv, Tright))
                 {
-                  std::swap (heap[j], heap[i]);
-                  i = j;
+                  igral = std::copysign (numeric_limits<double>::Inf (),
+                                         igral);
+                  warning ("quadcc: divergent integral detected");
+                  break;
                 }
-              else
-                break;
+
+              // Fix-up the heap: we now have one interval on top that we
+              // don't need any more and two new, unsorted ones at the
+              // bottom.
+
+              // Flip the last interval to the top of the heap and sift
+              // it back down.
+              std::swap (heap[nivals - 1], heap[0]);
+              nivals--;
+              cquad_sift_down (ivals, heap, nivals - 1, 0);
+
+              // Now grab the last interval and sift it up the heap.
+              cquad_sift_up (ivals, heap, nivals - 1);
             }
-        }
-      else
-        {
-          // Otherwise, just fix-up the heap.
-          i = 0;
-          while (2*i + 1 < nivals)
+          else
             {
-              j = 2*i + 1;
-              if (j + 1 < nivals
-                  && ivals[heap[j + 1]].err >= ivals[heap[j]].err)
-                j++;
-              if (ivals[heap[j]].err <= ivals[heap[i]].err)
-                break;
-              else
-                {
-                  std::swap (heap[j], heap[i]);
-                  i = j;
-                }
+              // Otherwise, just fix-up the heap.
+              cquad_sift_down (ivals, heap, nivals, 0);
             }
         }
 
@@ -2258,6 +2415,29 @@ Mathematical Software, Vol.@: 37, Issue 3, Article No.@: 3, 2010.
 %! [q, err] = quadcc (f, 1, Inf);
 %! assert (err > 1e-5);
 
+## Test processing of subintervals in batches
+%!assert (quadcc (@sin, -pi, pi, "BatchSize", 16), 0, 1e-10)
+%!assert (quadcc (@(x) 1./sqrt (x), 0, 1, "batchsize", 8), 2, -1e-6)
+%!assert (quadcc (@(x) 1./(sqrt (x).*(x+1)), 0, Inf, [], [], "BatchSize", 4),
+%!        pi, -1e-6)
+%!assert (quadcc (@(x) exp (-x .^ 2), -Inf, Inf, [], [], "BatchSize", 32),
+%!        sqrt (pi), 1e-10)
+%!assert (quadcc (@(x) abs (x - 1), 0, 3, [], 1, "BatchSize", 1000), 2.5,
+%!        1e-10)
+
+%!test
+%! [q, err, npoints] = quadcc ("__nansin", -pi, pi, [0, 1e-6],
+%!                             "BatchSize", 16);
+%! assert (q, 0, -1e-6);
+%! assert (err < 1e-10);
+
+%!test
+%! f = @(x) x .* sin (1./x) .* sqrt (abs (1 - x));
+%! [q1, err1] = quadcc (f, 0, 3, [], 1);
+%! [q2, err2] = quadcc (f, 0, 3, [], 1, "BatchSize", 16);
+%! assert (q2, q1, 1e-6);
+%! assert (class (quadcc (@sin, single (0), 1, "BatchSize", 4)), "single");
+
 ## Test input validation
 %!error quadcc ()
 %!error quadcc (@sin)
@@ -2271,6 +2451,11 @@ Mathematical Software, Vol.@: 37, Issue 3, Article No.@: 3, 2010.
 %!error <absolute tolerance must be .=0> (quadcc (@sin, 0, pi, -1))
 %!error <relative tolerance must be .=0> (quadcc (@sin, 0, pi, [1, -1]))
 %!error <SING.* must be .* real values> (quadcc (@sin, 0, pi, 1e-6, [ i ]))
+%!error <options must occur in pairs> (quadcc (@sin, 0, pi, "BatchSize"))
+%!error <property name must be a string> (quadcc (@sin, 0, pi, "BatchSize", 2, 3, 4))
+%!error <unknown property 'foo'> (quadcc (@sin, 0, pi, "foo", 2))
+%!error <BatchSize must be a positive integer> (quadcc (@sin, 0, pi, "BatchSize", 0))
+%!error <BatchSize must be a positive integer> (quadcc (@sin, 0, pi, "BatchSize", 1.5))
 */
 
 OCTAVE_END_NAMESPACE(octave)
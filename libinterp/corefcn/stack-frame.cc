@@ -27,7 +27,9 @@
 #  include "config.h"
 #endif
 
+#include <array>
 #include <iostream>
+#include <vector>
 
 #include "lo-regexp.h"
 #include "str-vec.h"
@@ -79,6 +81,100 @@ static void display_scope (std::ostream& os, const symbol_scope& scope)
     }
 }
 
+// Function calls create and destroy stack frames in LIFO order, so a
+// short list of recently released memory blocks and value vectors
+// serves nearly all new frames without calling the allocator.  The
+// lists are never destroyed so that frames released during program
+// exit do not refer to them after they are gone.
+
+template <typename T>
+class frame_block_pool
+{
+public:
+
+  static const std::size_t max_free = 64;
+
+  static void * allocate (std::size_t size)
+  {
+    std::vector<void *>& free_list = blocks ();
+
+    if (size == sizeof (T) && ! free_list.empty ())
+      {
+        void *p = free_list.back ();
+        free_list.pop_back ();
+        return p;
+      }
+
+    return ::operator new (size);
+  }
+
+  static void deallocate (void *p, std::size_t size)
+  {
+    std::vector<void *>& free_list = blocks ();
+
+    if (size == sizeof (T) && free_list.size () < max_free)
+      free_list.push_back (p);
+    else
+      ::operator delete (p);
+  }
+
+private:
+
+  static std::vector<void *>& blocks ()
+  {
+    static std::vector<void *> *free_list = new std::vector<void *> ();
+
+    return *free_list;
+  }
+};
+
+template <typename T>
+class frame_vector_pool
+{
+public:
+
+  static const std::size_t max_free = 64;
+
+  // Vectors larger than this are returned to the allocator.
+  static const std::size_t max_capacity = 1024;
+
+  static std::vector<T> acquire (std::size_t n, const T& val)
+  {
+    std::vector<std::vector<T>>& free_list = vectors ();
+
+    if (free_list.empty ())
+      return std::vector<T> (n, val);
+
+    std::vector<T> retval = std::move (free_list.back ());
+    free_list.pop_back ();
+
+    retval.assign (n, val);
+
+    return retval;
+  }
+
+  static void release (std::vector<T>& v)
+  {
+    std::vector<std::vector<T>>& free_list = vectors ();
+
+    v.clear ();
+
+    if (v.capacity () > 0 && v.capacity () <= max_capacity
+        && free_list.size () < max_free)
+      free_list.push_back (std::move (v));
+  }
+
+private:
+
+  static std::vector<std::vector<T>>& vectors ()
+  {
+    static std::vector<std::vector<T>> *free_list
+      = new std::vector<std::vector<T>> ();
+
+    return *free_list;
+  }
+};
+
 class compiled_fcn_stack_frame;
 class script_stack_frame;
 class user_fcn_stack_frame;
@@ -131,6 +227,16 @@ public:
 
   ~compiled_fcn_stack_frame () = default;
 
+  static void * operator new (std::size_t size)
+  {
+    return frame_block_pool<compiled_fcn_stack_frame>::allocate (size);
+  }
+
+  static void operator delete (void *p, std::size_t size)
+  {
+    frame_block_pool<compiled_fcn_stack_frame>::deallocate (p, size);
+  }
+
   bool is_compiled_fcn_frame () const { return true; }
 
   symbol_scope get_scope () const
@@ -368,9 +474,10 @@ public:
                           const std::shared_ptr<stack_frame>& static_link,
                           const std::shared_ptr<stack_frame>& access_link)
     : stack_frame (tw, index, parent_link, static_link, access_link),
-      m_values (num_symbols, octave_value ()),
-      m_flags (num_symbols, LOCAL),
-      m_auto_vars (NUM_AUTO_VARS, octave_value ())
+      m_values (frame_vector_pool<octave_value>::acquire (num_symbols,
+                                                          octave_value ())),
+      m_flags (frame_vector_pool<scope_flags>::acquire (num_symbols, LOCAL)),
+      m_auto_vars ()
   { }
 
   base_value_stack_frame (const base_value_stack_frame& elt) = default;
@@ -382,19 +489,21 @@ public:
   {
     // The C++ standard doesn't guarantee in which order the elements of a
     // std::vector are destroyed.  GNU libstdc++ and LLVM libc++ seem to
-    // destroy them in a different order.  So, erase elements manually
+    // destroy them in a different order.  So, clear elements manually
     // from first to last to be able to guarantee a destructor call order
-    // independent of the used STL, e.g., for classdef objects.
+    // independent of the used STL, e.g., for classdef objects.  The
+    // emptied vectors are kept for reuse by new frames.
 
     // Member dtor order is last to first.  So, m_auto_vars before m_values.
 
-    for (auto auto_vars_iter = m_auto_vars.begin ();
-         auto_vars_iter != m_auto_vars.end ();)
-      auto_vars_iter = m_auto_vars.erase (auto_vars_iter);
+    for (auto& val : m_auto_vars)
+      val = octave_value ();
+
+    for (auto& val : m_values)
+      val = octave_value ();
 
-    for (auto values_iter = m_values.begin ();
-         values_iter != m_values.end ();)
-      values_iter = m_values.erase (values_iter);
+    frame_vector_pool<octave_value>::release (m_values);
+    frame_vector_pool<scope_flags>::release (m_flags);
   }
 
   std::size_t size () const
@@ -463,9 +572,9 @@ protected:
   std::vector<scope_flags> m_flags;
 
   // A fixed list of Automatic variables created for this function.
-  // The elements of this vector correspond to the auto_var_type
+  // The elements of this array correspond to the auto_var_type
   // enum.
-  std::vector<octave_value> m_auto_vars;
+  std::array<octave_value, NUM_AUTO_VARS> m_auto_vars;
 };
 
 // User-defined functions have a symbol_scope object to store the set
@@ -517,6 +626,26 @@ public:
       assign (nm_ov.first, nm_ov.second);
   }
 
+  user_fcn_stack_frame (tree_evaluator& tw, octave_user_function *fcn,
+                        std::size_t index,
+                        const std::shared_ptr<stack_frame>& parent_link,
+                        const std::shared_ptr<stack_frame>& static_link,
+                        const local_vars_list& local_vars,
+                        const std::shared_ptr<stack_frame>& access_link = std::shared_ptr<stack_frame> ())
+    : base_value_stack_frame (tw, get_num_symbols (fcn), index,
+                              parent_link, static_link,
+                              (access_link
+                               ? access_link
+                               : get_access_link (fcn, static_link))),
+      m_fcn (fcn), m_unwind_protect_frame (nullptr)
+  {
+    // Initialize local variable values.  No name lookups are needed
+    // because the symbols were found when LOCAL_VARS was created.
+
+    for (const auto& sym_ov : local_vars)
+      assign (sym_ov.first, sym_ov.second);
+  }
+
   user_fcn_stack_frame (const user_fcn_stack_frame& elt) = default;
 
   user_fcn_stack_frame&
@@ -527,6 +656,16 @@ public:
     delete m_unwind_protect_frame;
   }
 
+  static void * operator new (std::size_t size)
+  {
+    return frame_block_pool<user_fcn_stack_frame>::allocate (size);
+  }
+
+  static void operator delete (void *p, std::size_t size)
+  {
+    frame_block_pool<user_fcn_stack_frame>::deallocate (p, size);
+  }
+
   bool is_user_fcn_frame () const { return true; }
 
   static std::shared_ptr<stack_frame>
@@ -1120,6 +1259,19 @@ stack_frame::create (tree_evaluator& tw,
                                    access_link);
 }
 
+stack_frame *
+stack_frame::create (tree_evaluator& tw,
+                     octave_user_function *fcn, std::size_t index,
+                     const std::shared_ptr<stack_frame>& parent_link,
+                     const std::shared_ptr<stack_frame>& static_link,
+                     const local_vars_list& local_vars,
+                     const std::shared_ptr<stack_frame>& access_link)
+{
+  return new user_fcn_stack_frame (tw, fcn, index,
+                                   parent_link, static_link, local_vars,
+                                   access_link);
+}
+
 stack_frame *
 stack_frame::create (tree_evaluator& tw,
                      const symbol_scope& scope, std::size_t index,
@@ -2619,3 +2771,77 @@ scope_stack_frame::accept (stack_frame_walker& sfw)
 }
 
 OCTAVE_END_NAMESPACE(octave)
+
+/*
+## Frames of released calls are reused by later calls
+%!function r = __recursive_sum__ (n)
+%!  if (n == 0)
+%!    r = 0;
+%!  else
+%!    x = n;
+%!    r = x + __recursive_sum__ (n - 1);
+%!    assert (x, n);
+%!  endif
+%!endfunction
+
+%!function h = __handle_chain__ (n)
+%!  if (n == 0)
+%!    h = @() 0;
+%!  else
+%!    k = n;
+%!    prev = __handle_chain__ (n - 1);
+%!    h = @() k + prev ();
+%!  endif
+%!endfunction
+
+%!function c = __handle_list__ (n)
+%!  c = {};
+%!  if (n > 0)
+%!    v = n * [1, 2];
+%!    c = [__handle_list__(n - 1), {@() v}];
+%!  endif
+%!endfunction
+
+%!function __fail_at_depth__ (n)
+%!  x = ones (1, n);
+%!  if (n == 0)
+%!    error ("Octave:some-id", "depth reached");
+%!  endif
+%!  __fail_at_depth__ (n - 1);
+%!endfunction
+
+%!test
+%! for i = 1:5
+%!   assert (__recursive_sum__ (100), 5050);
+%!   assert (__recursive_sum__ (7), 28);
+%! endfor
+
+%!test
+%! h = __handle_chain__ (100);
+%! g = __handle_chain__ (50);
+%! assert (__recursive_sum__ (100), 5050);
+%! assert (h (), 5050);
+%! assert (g (), 1275);
+%! assert (h (), 5050);
+
+%!test
+%! c = __handle_list__ (60);
+%! d = __handle_list__ (30);
+%! assert (__recursive_sum__ (60), 1830);
+%! for k = 1:60
+%!   assert (c{k} (), k * [1, 2]);
+%! endfor
+%! for k = 1:30
+%!   assert (d{k} (), k * [1, 2]);
+%! endfor
+
+%!test
+%! for i = 1:3
+%!   try
+%!     __fail_at_depth__ (80);
+%!   catch err
+%!     assert (err.message, "depth reached");
+%!   end_try_catch
+%!   assert (__recursive_sum__ (80), 3240);
+%! endfor
+*/
@@ -34,6 +34,8 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 class octave_value;
 class octave_value_list;
@@ -111,6 +113,10 @@ public:
 
   typedef std::map<std::string, octave_value> local_vars_map;
 
+  // Captured variable values bound to the symbols of the scope of an
+  // anonymous function.
+  typedef std::vector<std::pair<symbol_record, octave_value>> local_vars_list;
+
   // Markers indicating the type of a variable.  Values for local
   // variables are stored in the stack frame.  Values for
   // global variables are stored in the tree_evaluator object that
@@ -176,6 +182,15 @@ public:
           const local_vars_map& local_vars,
           const std::shared_ptr<stack_frame>& access_link = std::shared_ptr<stack_frame> ());
 
+  // Anonymous user-defined function with init vars already bound to
+  // symbols in its scope.
+  static stack_frame *
+  create (tree_evaluator& tw, octave_user_function *fcn, std::size_t index,
+          const std::shared_ptr<stack_frame>& parent_link,
+          const std::shared_ptr<stack_frame>& static_link,
+          const local_vars_list& local_vars,
+          const std::shared_ptr<stack_frame>& access_link = std::shared_ptr<stack_frame> ());
+
   // Scope.
   static stack_frame *
   create (tree_evaluator& tw, const symbol_scope& scope, std::size_t index,
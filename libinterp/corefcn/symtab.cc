@@ -52,7 +52,7 @@ OCTAVE_BEGIN_NAMESPACE(octave)
 
 symbol_table::symbol_table (interpreter& interp)
   : m_interpreter (interp), m_fcn_table (), m_class_precedence_table (),
-    m_parent_map ()
+    m_parent_map (), m_lookup_epoch (1)
 {
   install_builtins ();
 }
@@ -289,6 +289,48 @@ symbol_table::find_function (const std::string& name,
   return fcn_table_find (name, args, search_scope);
 }
 
+octave_value
+symbol_table::find_function (const std::string& name,
+                             const octave_value_list& args,
+                             fcn_lookup_cache& cache)
+{
+  symbol_scope scope = current_scope ();
+
+  std::string dispatch_type = get_dispatch_type (args);
+
+  std::shared_ptr<symbol_scope_rep> scope_rep = scope.get_rep ();
+
+  // Compare scopes by owner so that an expired scope never matches a
+  // new one allocated at the same address.
+
+  if (cache.m_epoch == m_lookup_epoch
+      && ! cache.m_scope.owner_before (scope_rep)
+      && ! scope_rep.owner_before (cache.m_scope)
+      && cache.m_dispatch_type == dispatch_type)
+    return cache.m_fcn;
+
+  octave_value fcn = find_function (name, args, scope);
+
+  // Only built-in functions are cached.  User code could contain the
+  // cache itself and would never be released, and holding on to
+  // dynamically loaded functions would keep them from being unloaded.
+
+  octave_function *f = (fcn.is_function () ? fcn.function_value (true)
+                        : nullptr);
+
+  if (f && f->is_builtin_function ())
+    {
+      cache.m_epoch = m_lookup_epoch;
+      cache.m_scope = scope_rep;
+      cache.m_dispatch_type = dispatch_type;
+      cache.m_fcn = fcn;
+    }
+  else
+    cache.clear ();
+
+  return fcn;
+}
+
 octave_value
 symbol_table::find_user_function (const std::string& name)
 {
@@ -339,6 +381,8 @@ void
 symbol_table::install_cmdline_function (const std::string& name,
                                         const octave_value& fcn)
 {
+  invalidate_lookups ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -365,6 +409,8 @@ symbol_table::install_local_function (const std::string& name,
                                       const octave_value& fcn,
                                       const std::string& file_name)
 {
+  invalidate_lookups ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -387,6 +433,8 @@ void
 symbol_table::install_user_function (const std::string& name,
                                      const octave_value& fcn)
 {
+  invalidate_lookups ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -411,6 +459,8 @@ void
 symbol_table::install_built_in_function (const std::string& name,
     const octave_value& fcn)
 {
+  invalidate_lookups ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -436,6 +486,8 @@ symbol_table::install_built_in_function (const std::string& name,
 void
 symbol_table::clear_functions (bool force)
 {
+  invalidate_lookups ();
+
   auto p = m_fcn_table.begin ();
 
   while (p != m_fcn_table.end ())
@@ -445,12 +497,16 @@ symbol_table::clear_functions (bool force)
 void
 symbol_table::clear_function (const std::string& name)
 {
+  invalidate_lookups ();
+
   clear_user_function (name);
 }
 
 void
 symbol_table::clear_function_pattern (const std::string& pat)
 {
+  invalidate_lookups ();
+
   symbol_match pattern (pat);
 
   auto p = m_fcn_table.begin ();
@@ -467,6 +523,8 @@ symbol_table::clear_function_pattern (const std::string& pat)
 void
 symbol_table::clear_function_regexp (const std::string& pat)
 {
+  invalidate_lookups ();
+
   regexp pattern (pat);
 
   auto p = m_fcn_table.begin ();
@@ -483,6 +541,8 @@ symbol_table::clear_function_regexp (const std::string& pat)
 void
 symbol_table::clear_user_function (const std::string& name)
 {
+  invalidate_lookups ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -500,6 +560,8 @@ symbol_table::clear_user_function (const std::string& name)
 void
 symbol_table::clear_dld_function (const std::string& name)
 {
+  invalidate_lookups ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -514,6 +576,8 @@ symbol_table::clear_dld_function (const std::string& name)
 void
 symbol_table::clear_mex_functions ()
 {
+  invalidate_lookups ();
+
   auto p = m_fcn_table.begin ();
 
   while (p != m_fcn_table.end ())
@@ -528,6 +592,8 @@ bool
 symbol_table::set_class_relationship (const std::string& sup_class,
                                       const std::string& inf_class)
 {
+  invalidate_lookups ();
+
   if (is_superiorto (inf_class, sup_class))
     return false;
 
@@ -569,6 +635,8 @@ void
 symbol_table::alias_built_in_function (const std::string& alias,
                                        const std::string& name)
 {
+  invalidate_lookups ();
+
   octave_value fcn = find_built_in_function (name);
 
   if (fcn.is_defined ())
@@ -587,6 +655,8 @@ void
 symbol_table::install_built_in_dispatch (const std::string& name,
     const std::string& klass)
 {
+  invalidate_lookups ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -690,6 +760,8 @@ void
 symbol_table::add_to_parent_map (const std::string& classname,
                                  const std::list<std::string>& parent_list)
 {
+  invalidate_lookups ();
+
   m_parent_map[classname] = parent_list;
 }
 
@@ -721,6 +793,8 @@ symbol_table::parent_classes (const std::string& dispatch_type)
 void
 symbol_table::cleanup ()
 {
+  invalidate_lookups ();
+
   clear_functions ();
 
   m_fcn_table.clear ();
@@ -731,6 +805,8 @@ symbol_table::cleanup ()
 fcn_info *
 symbol_table::get_fcn_info (const std::string& name)
 {
+  invalidate_lookups ();
+
   auto p = m_fcn_table.find (name);
   return p != m_fcn_table.end () ? &p->second : nullptr;
 }
@@ -879,4 +955,21 @@ updated to use some other function.
 %! assert (! strcmp (which ("bar"), ""));
 */
 
+/*
+## Cached lookups of built-in functions must see new definitions
+%!test
+%! unwind_protect
+%!   r = zeros (1, 2);
+%!   for i = 1:2
+%!     r(i) = columns ([1, 2, 3]);
+%!     if (i == 1)
+%!       eval ("function c = columns (x), c = -1; endfunction");
+%!     endif
+%!   endfor
+%!   assert (r, [3, -1]);
+%! unwind_protect_cleanup
+%!   clear -f columns;
+%! end_unwind_protect
+*/
+
 OCTAVE_END_NAMESPACE(octave)
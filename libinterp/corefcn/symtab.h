@@ -31,6 +31,7 @@
 #include <deque>
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -50,6 +51,38 @@ OCTAVE_BEGIN_NAMESPACE(octave)
 
 class interpreter;
 
+// The result of a function lookup at one call site.  It is valid as
+// long as the lookup epoch of the symbol table, the current scope, and
+// the dispatch type of the arguments are the same as when it was
+// stored.
+
+class fcn_lookup_cache
+{
+public:
+
+  fcn_lookup_cache ()
+    : m_epoch (0), m_scope (), m_dispatch_type (), m_fcn ()
+  { }
+
+  OCTAVE_DEFAULT_COPY_MOVE (fcn_lookup_cache)
+
+  ~fcn_lookup_cache () = default;
+
+  void clear () { *this = fcn_lookup_cache (); }
+
+private:
+
+  friend class symbol_table;
+
+  std::size_t m_epoch;
+
+  std::weak_ptr<symbol_scope_rep> m_scope;
+
+  std::string m_dispatch_type;
+
+  octave_value m_fcn;
+};
+
 class OCTINTERP_API symbol_table
 {
 public:
@@ -112,6 +145,13 @@ public:
                  const octave_value_list& args,
                  const symbol_scope& search_scope = symbol_scope::invalid ());
 
+  // Like find_function (NAME, ARGS), but reuse the result stored in
+  // CACHE if it is still valid.
+
+  octave_value
+  find_function (const std::string& name, const octave_value_list& args,
+                 fcn_lookup_cache& cache);
+
   octave_value find_user_function (const std::string& name);
 
   octave_value find_cmdline_function (const std::string& name);
@@ -181,6 +221,13 @@ public:
 
   fcn_info * get_fcn_info (const std::string& name);
 
+  // Invalidate all cached function lookups.  This must be called for
+  // any change that could alter the result of a lookup, such as
+  // changes to the load path or the function table, or new files
+  // becoming visible at the prompt or after changing directories.
+
+  void invalidate_lookups () { m_lookup_epoch++; }
+
 private:
 
   interpreter& m_interpreter;
@@ -218,6 +265,9 @@ private:
   typedef std::map<std::string, std::list<std::string>>::iterator
       parent_map_iterator;
 
+  // Incremented by invalidate_lookups.
+  std::size_t m_lookup_epoch;
+
   octave_value dump_fcn_table_map () const;
 
   // This function is generated automatically by mk-builtins.pl.
@@ -29,7 +29,11 @@
 
 #include <cmath>
 
+#include <algorithm>
+#include <vector>
+
 #include "lo-ieee.h"
+#include "oct-parallel.h"
 
 #include "defun.h"
 #include "error.h"
@@ -49,15 +53,154 @@ min (double a, double b, double c)
   return (a < b) ? (a < c ? a : c) : (b < c ? b : c);
 }
 
-#define REF(x,k,i) x(static_cast<octave_idx_type> (elem((k), (i))) - 1)
+// A uniform grid over the bounding boxes of the triangles.  Each cell
+// lists, in ascending order, the triangles whose bounding box overlaps
+// it, so that only a few triangles are tested for each point.  The
+// grid has about as many cells as there are triangles.
+
+class triangle_grid
+{
+public:
+
+  triangle_grid (const ColumnVector& minx, const ColumnVector& maxx,
+                 const ColumnVector& miny, const ColumnVector& maxy)
+    : m_xmin (0), m_ymin (0), m_xmax (0), m_ymax (0), m_dx (1), m_dy (1),
+      m_nx (1), m_ny (1), m_start (), m_elem ()
+  {
+    octave_idx_type nelem = minx.numel ();
+
+    // Triangles with NaN coordinates never contain a point.
+    std::vector<octave_idx_type> valid;
+    valid.reserve (nelem);
+
+    for (octave_idx_type k = 0; k < nelem; k++)
+      {
+        if (minx(k) <= maxx(k) && miny(k) <= maxy(k))
+          {
+            if (valid.empty ())
+              {
+                m_xmin = minx(k);
+                m_xmax = maxx(k);
+                m_ymin = miny(k);
+                m_ymax = maxy(k);
+              }
+            else
+              {
+                m_xmin = std::min (m_xmin, minx(k));
+                m_xmax = std::max (m_xmax, maxx(k));
+                m_ymin = std::min (m_ymin, miny(k));
+                m_ymax = std::max (m_ymax, maxy(k));
+              }
+
+            valid.push_back (k);
+          }
+      }
+
+    octave_idx_type nvalid = valid.size ();
+
+    if (nvalid == 0)
+      {
+        // No point is inside the grid.
+        m_xmin = m_ymin = 1;
+        m_xmax = m_ymax = 0;
+        m_start.assign (2, 0);
+        return;
+      }
+
+    // Choose square cells if possible.
+    double w = m_xmax - m_xmin;
+    double h = m_ymax - m_ymin;
+    double cell = std::sqrt (w * h / nvalid);
+
+    if (cell > 0)
+      {
+        m_nx = std::max (1.0, std::min (std::ceil (w / cell), double (nvalid)));
+        m_ny = std::max (1.0, std::min (std::ceil (h / cell), double (nvalid)));
+      }
+    else if (w > 0)
+      m_nx = nvalid;
+    else if (h > 0)
+      m_ny = nvalid;
+
+    if (w > 0)
+      m_dx = w / m_nx;
+    if (h > 0)
+      m_dy = h / m_ny;
+
+    // Count the triangles of each cell, then fill the cells.
+
+    m_start.assign (m_nx * m_ny + 1, 0);
+
+    for (octave_idx_type k : valid)
+      {
+        for (octave_idx_type cy = cell_y (miny(k)); cy <= cell_y (maxy(k)); cy++)
+          for (octave_idx_type cx = cell_x (minx(k)); cx <= cell_x (maxx(k)); cx++)
+            m_start[cy * m_nx + cx + 1]++;
+      }
+
+    for (octave_idx_type c = 0; c < m_nx * m_ny; c++)
+      m_start[c+1] += m_start[c];
+
+    m_elem.resize (m_start.back ());
+
+    std::vector<octave_idx_type> pos (m_start.begin (), m_start.end () - 1);
+
+    for (octave_idx_type k : valid)
+      {
+        for (octave_idx_type cy = cell_y (miny(k)); cy <= cell_y (maxy(k)); cy++)
+          for (octave_idx_type cx = cell_x (minx(k)); cx <= cell_x (maxx(k)); cx++)
+            m_elem[pos[cy * m_nx + cx]++] = k;
+      }
+  }
+
+  OCTAVE_DISABLE_COPY_MOVE (triangle_grid)
+
+  ~triangle_grid () = default;
+
+  // The triangles that may contain the point (XT, YT).  BEGIN == END if
+  // the point is outside the grid.
+
+  void candidates (double xt, double yt, const octave_idx_type *& begin,
+                   const octave_idx_type *& end) const
+  {
+    begin = end = m_elem.data ();
 
-// for large data set the algorithm is very slow
-// one should presort (how?) either the elements of the points of evaluation
-// to cut down the time needed to decide which triangle contains the
-// given point
+    if (! (xt >= m_xmin && xt <= m_xmax && yt >= m_ymin && yt <= m_ymax))
+      return;
 
-// e.g., build up a neighbouring triangle structure and use a simplex-like
-// method to traverse it
+    octave_idx_type c = cell_y (yt) * m_nx + cell_x (xt);
+
+    begin = m_elem.data () + m_start[c];
+    end = m_elem.data () + m_start[c+1];
+  }
+
+private:
+
+  octave_idx_type cell_x (double xt) const
+  {
+    octave_idx_type cx = (xt - m_xmin) / m_dx;
+    return std::max (static_cast<octave_idx_type> (0),
+                     std::min (cx, m_nx - 1));
+  }
+
+  octave_idx_type cell_y (double yt) const
+  {
+    octave_idx_type cy = (yt - m_ymin) / m_dy;
+    return std::max (static_cast<octave_idx_type> (0),
+                     std::min (cy, m_ny - 1));
+  }
+
+  double m_xmin, m_ymin, m_xmax, m_ymax;
+  double m_dx, m_dy;
+  octave_idx_type m_nx, m_ny;
+
+  // The triangles of cell C are m_elem[m_start[C]] to
+  // m_elem[m_start[C+1]-1].
+  std::vector<octave_idx_type> m_start;
+  std::vector<octave_idx_type> m_elem;
+};
+
+#define REF(x,k,i) x(static_cast<octave_idx_type> (elem((k), (i))) - 1)
 
 DEFUN (tsearch, args, ,
        doc: /* -*- texinfo -*-
@@ -66,7 +209,8 @@ Search for the enclosing Delaunay convex hull.
 
 For @code{@var{t} = delaunay (@var{x}, @var{y})}, finds the index in @var{t}
 containing the points @code{(@var{xi}, @var{yi})}.  For points outside the
-convex hull, @var{idx} is NaN.
+convex hull, @var{idx} is NaN.  If a point is on the boundary of several
+triangles, the smallest index is returned.
 @seealso{delaunay, delaunayn}
 @end deftypefn */)
 {
@@ -83,6 +227,20 @@ convex hull, @var{idx} is NaN.
 
   const octave_idx_type nelem = elem.rows ();
 
+  if (xi.numel () != yi.numel ())
+    error ("tsearch: XI and YI must have the same number of elements");
+
+  if (nelem > 0 && elem.columns () != 3)
+    error ("tsearch: T must have 3 columns");
+
+  for (octave_idx_type k = 0; k < elem.numel (); k++)
+    {
+      double v = elem(k);
+
+      if (! (v >= 1 && v <= x.numel () && v <= y.numel ()))
+        error ("tsearch: T must contain indices of X and Y");
+    }
+
   ColumnVector minx (nelem);
   ColumnVector maxx (nelem);
   ColumnVector miny (nelem);
@@ -95,70 +253,61 @@ convex hull, @var{idx} is NaN.
       maxy(k) = max (REF (y, k, 0), REF (y, k, 1), REF (y, k, 2)) + eps;
     }
 
+  const triangle_grid grid (minx, maxx, miny, maxy);
+
   const octave_idx_type np = xi.numel ();
   ColumnVector values (np);
+  double *pvalues = values.rwdata ();
 
-  double x0 = 0.0, y0 = 0.0;
-  double a11 = 0.0, a12 = 0.0, a21 = 0.0, a22 = 0.0, det = 0.0;
-  double xt = 0.0, yt = 0.0;
-  double dx1 = 0.0, dx2 = 0.0, c1 = 0.0, c2 = 0.0;
+  // Check if point (XT, YT) is inside triangle K.
+  auto inside = [&] (octave_idx_type k, double xt, double yt) -> bool
+  {
+    if (! (xt >= minx(k) && xt <= maxx(k) && yt >= miny(k) && yt <= maxy(k)))
+      return false;
 
-  octave_idx_type k = nelem;   // k is more than just an index variable.
+    double x0  = REF (x, k, 0);
+    double y0  = REF (y, k, 0);
+    double a11 = REF (x, k, 1) - x0;
+    double a12 = REF (y, k, 1) - y0;
+    double a21 = REF (x, k, 2) - x0;
+    double a22 = REF (y, k, 2) - y0;
+    double det = a11 * a22 - a21 * a12;
 
-  for (octave_idx_type kp = 0; kp < np; kp++)   // for each point
-    {
-      xt = xi (kp);
-      yt = yi (kp);
-
-      // Check if point (xt,yt) is in the triangle that was last examined.
-      // This is for inputs where points are in contiguous order,
-      // like when the points are sampled from a continuous path.
-      if (k < nelem)  // This check will be false for the very first point.
-        {
-          // If we are here, then x0, y0, det all exist from before.
-          dx1 = xt - x0;
-          dx2 = yt - y0;
-          c1 = (a22 * dx1 - a21 * dx2) / det;
-          c2 = (-a12 * dx1 + a11 * dx2) / det;
-          if (c1 >= -eps && c2 >= -eps && (c1 + c2) <= 1 + eps)
-            {
-              values (kp) = k+1;
-              continue;
-            }
-        }
-
-      // The point is not in the same triangle, so go through all triangles.
-      for (k = 0; k < nelem; k++)
-        {
-          if (xt >= minx(k) && xt <= maxx(k) && yt >= miny(k) && yt <= maxy(k))
-            {
-              // Point is inside the triangle's bounding rectangle:
-              // See if it's inside the triangle itself.
-              x0  = REF (x, k, 0);
-              y0  = REF (y, k, 0);
-              a11 = REF (x, k, 1) - x0;
-              a12 = REF (y, k, 1) - y0;
-              a21 = REF (x, k, 2) - x0;
-              a22 = REF (y, k, 2) - y0;
-              det = a11 * a22 - a21 * a12;
-
-              // solve the system
-              dx1 = xt - x0;
-              dx2 = yt - y0;
-              c1 = (a22 * dx1 - a21 * dx2) / det;
-              c2 = (-a12 * dx1 + a11 * dx2) / det;
-              if (c1 >= -eps && c2 >= -eps && (c1 + c2) <= 1 + eps)
-                {
-                  values (kp) = k+1;
-                  break;
-                }
-            } //end see if it's inside the triangle itself
-        } //end for each triangle
-
-      if (k == nelem)
-        values (kp) = lo_ieee_nan_value ();
-
-    } //end for each point
+    // solve the system
+    double dx1 = xt - x0;
+    double dx2 = yt - y0;
+    double c1 = (a22 * dx1 - a21 * dx2) / det;
+    double c2 = (-a12 * dx1 + a11 * dx2) / det;
+
+    return (c1 >= -eps && c2 >= -eps && (c1 + c2) <= 1 + eps);
+  };
+
+  // The points are independent, so they are located in parallel.
+  // Only the triangles of the grid cell of each point are tested.
+
+  parallel_for (np, 1024, [&] (octave_idx_type lo, octave_idx_type hi)
+  {
+    for (octave_idx_type kp = lo; kp < hi; kp++)
+      {
+        double xt = xi.xelem (kp);
+        double yt = yi.xelem (kp);
+
+        const octave_idx_type *begin;
+        const octave_idx_type *end;
+        grid.candidates (xt, yt, begin, end);
+
+        pvalues[kp] = lo_ieee_nan_value ();
+
+        for (const octave_idx_type *pk = begin; pk != end; pk++)
+          {
+            if (inside (*pk, xt, yt))
+              {
+                pvalues[kp] = *pk + 1;
+                break;
+              }
+          }
+      }
+  });
 
   return ovl (values);
 }
@@ -174,7 +323,25 @@ convex hull, @var{idx} is NaN.
 %!assert (tsearch (x,y,tri,-1/3, -1/3), 1)
 %!assert (tsearch (x,y,tri, 1, 1), NaN)
 
+
+%!test
+%! [xx, yy] = meshgrid (0:10);
+%! x = xx(:);
+%! y = yy(:);
+%! ## Two triangles for each square of the mesh.
+%! [i, j] = ndgrid (1:10, 1:10);
+%! p = sub2ind ([11, 11], i(:), j(:));
+%! tri = [p, p+1, p+12; p, p+12, p+11];
+%! xi = 10 * rand (1000, 1);
+%! yi = 10 * rand (1000, 1);
+%! sq = sub2ind ([10, 10], floor (yi) + 1, floor (xi) + 1);
+%! below = (yi - floor (yi)) < (xi - floor (xi));
+%! assert (tsearch (x, y, tri, xi, yi), sq + 100 * below);
+%! assert (tsearch (x, y, tri, [-1; 5; NaN; 10], [5; 11; 5; 10]),
+%!         [NaN; NaN; NaN; 100]);
+
 %!error tsearch ()
+%!error <T must contain indices of X and Y> tsearch (x, y, [1, 2, 4], 0, 0)
 */
 
 OCTAVE_END_NAMESPACE(octave)
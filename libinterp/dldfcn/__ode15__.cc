@@ -27,6 +27,13 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <string>
+
+#include "boolSparse.h"
 #include "dColVector.h"
 #include "dMatrix.h"
 #include "dSparse.h"
@@ -81,6 +88,11 @@
 #    include <sunlinsol/sunlinsol_klu.h>
 #  endif
 
+#  if defined (HAVE_SUNDIALS_SUNLINSOL_SPILS)
+#    include <sunlinsol/sunlinsol_spgmr.h>
+#    include <sunlinsol/sunlinsol_spbcgs.h>
+#  endif
+
 #endif
 
 OCTAVE_BEGIN_NAMESPACE(octave)
@@ -168,6 +180,12 @@ public:
   SparseMatrix (*DAEJacCellSparse) (SparseMatrix *dfdy,
                                     SparseMatrix *dfdyp, realtype cj);
 
+  typedef
+  ColumnVector (*DAEPrecFuncIDA) (const ColumnVector& x,
+                                  const ColumnVector& xdot, realtype t,
+                                  const ColumnVector& r, realtype cj,
+                                  const octave_value& idap);
+
   //Default
   IDA ()
     : m_t0 (0.0), m_y0 (), m_yp0 (), m_havejac (false), m_havejacfcn (false),
@@ -175,7 +193,11 @@ public:
       m_ida_jac (), m_dfdy (nullptr), m_dfdyp (nullptr), m_spdfdy (nullptr),
       m_spdfdyp (nullptr), m_fcn (nullptr), m_jacfcn (nullptr),
       m_jacspfcn (nullptr), m_jacdcell (nullptr), m_jacspcell (nullptr),
-      m_sunJacMatrix (nullptr), m_sunLinearSolver (nullptr)
+      m_sunJacMatrix (nullptr), m_sunLinearSolver (nullptr),
+      m_havejacpattern (false), m_jacpattern (), m_color_ptr (),
+      m_color_cols (), m_krylov (false), m_krylov_method (),
+      m_ida_prec (), m_precfcn (nullptr), m_num_fd_res (0),
+      m_lin_solve (nullptr), m_num_lin_solves (0)
   { }
 
 
@@ -186,13 +208,20 @@ public:
       m_ida_jac (), m_dfdy (nullptr), m_dfdyp (nullptr), m_spdfdy (nullptr),
       m_spdfdyp (nullptr), m_fcn (daefun), m_jacfcn (nullptr),
       m_jacspfcn (nullptr), m_jacdcell (nullptr), m_jacspcell (nullptr),
-      m_sunJacMatrix (nullptr), m_sunLinearSolver (nullptr)
+      m_sunJacMatrix (nullptr), m_sunLinearSolver (nullptr),
+      m_havejacpattern (false), m_jacpattern (), m_color_ptr (),
+      m_color_cols (), m_krylov (false), m_krylov_method (),
+      m_ida_prec (), m_precfcn (nullptr), m_num_fd_res (0),
+      m_lin_solve (nullptr), m_num_lin_solves (0)
   { }
 
   OCTAVE_DISABLE_COPY_MOVE (IDA)
 
   ~IDA ()
   {
+    if (m_lin_solve)
+      direct_solvers ().erase (m_sunLinearSolver);
+
     IDAFree (&m_mem);
     SUNLinSolFree (m_sunLinearSolver);
     SUNMatDestroy (m_sunJacMatrix);
@@ -252,6 +281,21 @@ public:
     return *this;
   }
 
+  IDA&
+  set_jacobian_pattern (const SparseBoolMatrix& pattern);
+
+  IDA&
+  set_linear_solver (const std::string& method, const octave_value& prec,
+                     DAEPrecFuncIDA p)
+  {
+    m_krylov = true;
+    m_krylov_method = method;
+    m_ida_prec = prec;
+    m_precfcn = (prec.is_defined () ? p : nullptr);
+
+    return *this;
+  }
+
   void set_userdata ();
 
   void initialize ();
@@ -310,6 +354,61 @@ public:
                   N_Vector& yy, N_Vector& yyp, SUNMatrix& Jac);
 #  endif
 
+  static int
+  jacpattern (realtype t, realtype cj, N_Vector yy, N_Vector yyp,
+              N_Vector rr, SUNMatrix JJ, void *user_data, N_Vector,
+              N_Vector, N_Vector)
+  {
+    IDA *self = static_cast <IDA *> (user_data);
+    self->jacpattern_impl (t, cj, yy, yyp, rr, JJ);
+    return 0;
+  }
+
+  void
+  jacpattern_impl (realtype t, realtype cj, N_Vector& yy, N_Vector& yyp,
+                   N_Vector& rr, SUNMatrix& JJ);
+
+#  if defined (HAVE_SUNDIALS_SUNLINSOL_SPILS)
+  static int
+  precsolve (realtype t, N_Vector yy, N_Vector yyp, N_Vector,
+             N_Vector rvec, N_Vector zvec, realtype cj, realtype,
+             void *user_data)
+  {
+    IDA *self = static_cast <IDA *> (user_data);
+    self->precsolve_impl (t, yy, yyp, rvec, zvec, cj);
+    return 0;
+  }
+
+  void
+  precsolve_impl (realtype t, N_Vector& yy, N_Vector& yyp,
+                  N_Vector& rvec, N_Vector& zvec, realtype cj);
+#  endif
+
+  // IDA counts the iterations of iterative linear solvers, but not the
+  // linear systems solved by direct solvers.  Those are counted by
+  // replacing the solve operation of the solver with count_lin_solve,
+  // which finds the IDA object of the solver in direct_solvers.
+
+  typedef int (*lin_solve_fcn) (SUNLinearSolver, SUNMatrix, N_Vector,
+                                N_Vector, realtype);
+
+  void count_lin_solves ();
+
+  static int
+  count_lin_solve (SUNLinearSolver S, SUNMatrix A, N_Vector x, N_Vector b,
+                   realtype tol)
+  {
+    IDA *self = direct_solvers ()[S];
+    self->m_num_lin_solves++;
+    return (*self->m_lin_solve) (S, A, x, b, tol);
+  }
+
+  static std::map<SUNLinearSolver, IDA *>& direct_solvers ()
+  {
+    static std::map<SUNLinearSolver, IDA *> solvers;
+    return solvers;
+  }
+
   void set_maxstep (realtype maxstep);
 
   void set_initialstep (realtype initialstep);
@@ -380,6 +479,29 @@ private:
 #  endif
   SUNMatrix m_sunJacMatrix;
   SUNLinearSolver m_sunLinearSolver;
+
+  // Sparsity pattern of the Jacobian for finite differences, and its
+  // columns grouped so that the columns of group K, which are
+  // M_COLOR_COLS(M_COLOR_PTR(K):M_COLOR_PTR(K+1)-1), have no nonzero
+  // elements in the same row.
+  bool m_havejacpattern;
+  SparseBoolMatrix m_jacpattern;
+  Array<octave_idx_type> m_color_ptr;
+  Array<octave_idx_type> m_color_cols;
+
+  // Iterative linear solver and user preconditioner.
+  bool m_krylov;
+  std::string m_krylov_method;
+  octave_value m_ida_prec;
+  DAEPrecFuncIDA m_precfcn;
+
+  // Number of residual evaluations for finite difference Jacobians.
+  long int m_num_fd_res;
+
+  // Solve operation of a direct linear solver, and the number of linear
+  // systems it has solved.
+  lin_solve_fcn m_lin_solve;
+  long int m_num_lin_solves;
 };
 
 int
@@ -419,7 +541,40 @@ IDA::set_up (const ColumnVector& y)
   N_Vector yy = ColToNVec (y, m_num);
   octave::unwind_action act ([&yy] () { N_VDestroy_Serial (yy); });
 
-  if (m_havejacsparse)
+  if (m_krylov)
+    {
+#  if defined (HAVE_SUNDIALS_SUNLINSOL_SPILS)
+      // IDA only supports left preconditioning.
+#    if defined (HAVE_SUNDIALS_SUNCONTEXT)
+      int prectype = (m_precfcn ? SUN_PREC_LEFT : SUN_PREC_NONE);
+#    else
+      int prectype = (m_precfcn ? PREC_LEFT : PREC_NONE);
+#    endif
+
+      // A maximum Krylov subspace dimension of 0 selects the default.
+      if (m_krylov_method == "gmres")
+        m_sunLinearSolver = SUNLinSol_SPGMR (yy, prectype, 0
+                                             OCTAVE_SUNCONTEXT);
+      else
+        m_sunLinearSolver = SUNLinSol_SPBCGS (yy, prectype, 0
+                                              OCTAVE_SUNCONTEXT);
+      if (! m_sunLinearSolver)
+        error ("Unable to create iterative linear solver");
+
+      if (IDASetLinearSolver (m_mem, m_sunLinearSolver, nullptr))
+        error ("Unable to set iterative linear solver");
+
+      if (m_precfcn
+          && IDASetPreconditioner (m_mem, nullptr, IDA::precsolve) != 0)
+        error ("Unable to set preconditioner");
+
+#  else
+      error ("SUNDIALS SUNLINSOL SPGMR and SPBCGS were unavailable when "
+             "Octave was built");
+
+#  endif
+    }
+  else if (m_havejacsparse)
     {
 #  if defined (HAVE_SUNDIALS_SUNLINSOL_KLU)
 #    if defined (HAVE_SUNSPARSEMATRIX_REALLOCATE)
@@ -456,6 +611,28 @@ IDA::set_up (const ColumnVector& y)
 #  endif
 
     }
+#  if defined (HAVE_SUNDIALS_SUNLINSOL_KLU)
+  else if (m_havejacpattern)
+    {
+      // The structure of the Jacobian is fixed by the pattern.
+      m_sunJacMatrix = SUNSparseMatrix (m_num, m_num,
+                                        to_f77_int (m_jacpattern.nnz ()),
+                                        CSC_MAT OCTAVE_SUNCONTEXT);
+      if (! m_sunJacMatrix)
+        error ("Unable to create sparse Jacobian for Sundials");
+
+      m_sunLinearSolver = SUNLinSol_KLU (yy, m_sunJacMatrix
+                                         OCTAVE_SUNCONTEXT);
+      if (! m_sunLinearSolver)
+        error ("Unable to create KLU sparse solver");
+
+      if (IDASetLinearSolver (m_mem, m_sunLinearSolver, m_sunJacMatrix))
+        error ("Unable to set sparse linear solver");
+
+      if (IDASetJacFn (m_mem, IDA::jacpattern) != 0)
+        error ("Unable to set sparse Jacobian function");
+    }
+#  endif
   else
     {
       m_sunJacMatrix = SUNDenseMatrix (m_num, m_num OCTAVE_SUNCONTEXT);
@@ -472,7 +649,22 @@ IDA::set_up (const ColumnVector& y)
 
       if (m_havejac && IDASetJacFn (m_mem, IDA::jacdense) != 0)
         error ("Unable to set dense Jacobian function");
+      else if (m_havejacpattern
+               && IDASetJacFn (m_mem, IDA::jacpattern) != 0)
+        error ("Unable to set dense Jacobian function");
     }
+
+  if (! m_krylov)
+    count_lin_solves ();
+}
+
+void
+IDA::count_lin_solves ()
+{
+  m_lin_solve = m_sunLinearSolver->ops->solve;
+  m_sunLinearSolver->ops->solve = IDA::count_lin_solve;
+
+  direct_solvers ()[m_sunLinearSolver] = this;
 }
 
 void
@@ -546,6 +738,197 @@ IDA::jacsparse_impl (realtype t, realtype cj, N_Vector& yy, N_Vector& yyp,
 }
 #  endif
 
+IDA&
+IDA::set_jacobian_pattern (const SparseBoolMatrix& pattern)
+{
+  octave_idx_type n = m_y0.numel ();
+
+  if (pattern.rows () != n || pattern.cols () != n)
+    error ("__ode15__: JPattern must be a square matrix of the size of Y0");
+
+  m_jacpattern = pattern;
+  m_havejacpattern = true;
+
+  // Assign the columns to groups by greedy coloring of the column
+  // intersection graph: a column gets the first group that contains no
+  // column with a nonzero element in one of its rows.  For the banded
+  // and block structured Jacobians of discretized PDEs, the number of
+  // groups is bounded by the stencil size and not by N.
+
+  SparseBoolMatrix pattern_t = pattern.transpose ();
+
+  Array<octave_idx_type> color (dim_vector (n, 1), -1);
+  Array<octave_idx_type> blocked_for (dim_vector (n, 1), -1);
+  octave_idx_type num_colors = 0;
+
+  for (octave_idx_type j = 0; j < n; j++)
+    {
+      for (octave_idx_type k = pattern.cidx (j); k < pattern.cidx (j+1); k++)
+        {
+          octave_idx_type i = pattern.ridx (k);
+
+          for (octave_idx_type l = pattern_t.cidx (i);
+               l < pattern_t.cidx (i+1); l++)
+            {
+              octave_idx_type c = color(pattern_t.ridx (l));
+
+              if (c >= 0)
+                blocked_for(c) = j;
+            }
+        }
+
+      octave_idx_type c = 0;
+      while (c < num_colors && blocked_for(c) == j)
+        c++;
+
+      color(j) = c;
+
+      if (c == num_colors)
+        num_colors++;
+    }
+
+  m_color_ptr = Array<octave_idx_type> (dim_vector (num_colors + 1, 1), 0);
+  m_color_cols = Array<octave_idx_type> (dim_vector (n, 1));
+
+  for (octave_idx_type j = 0; j < n; j++)
+    m_color_ptr(color(j) + 1)++;
+
+  for (octave_idx_type c = 0; c < num_colors; c++)
+    m_color_ptr(c + 1) += m_color_ptr(c);
+
+  Array<octave_idx_type> next = m_color_ptr;
+
+  for (octave_idx_type j = 0; j < n; j++)
+    m_color_cols(next(color(j))++) = j;
+
+  return *this;
+}
+
+void
+IDA::jacpattern_impl (realtype t, realtype cj, N_Vector& yy, N_Vector& yyp,
+                      N_Vector& rr, SUNMatrix& JJ)
+{
+  ColumnVector y = NVecToCol (yy, m_num);
+
+  ColumnVector yp = NVecToCol (yyp, m_num);
+
+  ColumnVector res = NVecToCol (rr, m_num);
+
+  // The increments are chosen like those of the difference quotient
+  // Jacobian of IDA.  Perturbing Y by D and YP by CJ*D approximates the
+  // iteration matrix dF/dy + CJ*dF/dyp.
+
+  realtype hh = 0.0;
+  if (IDAGetCurrentStep (m_mem, &hh) != 0)
+    error ("IDA failed to return the current step size");
+
+  N_Vector ewt = N_VClone (yy);
+  octave::unwind_action act ([&ewt] () { N_VDestroy (ewt); });
+
+  if (IDAGetErrWeights (m_mem, ewt) != 0)
+    error ("IDA failed to return the error weights");
+
+  ColumnVector wt = NVecToCol (ewt, m_num);
+
+  const double srur = std::sqrt (std::numeric_limits<double>::epsilon ());
+
+  double *jdata = nullptr;
+  bool sparse_jac = false;
+
+#  if defined (HAVE_SUNDIALS_SUNLINSOL_KLU)
+  if (SUNMatGetID (JJ) == SUNMATRIX_SPARSE)
+    {
+      sparse_jac = true;
+
+      sunindextype *colptrs = SUNSparseMatrix_IndexPointers (JJ);
+      sunindextype *rowvals = SUNSparseMatrix_IndexValues (JJ);
+
+      for (octave_f77_int_type j = 0; j < m_num + 1; j++)
+        colptrs[j] = to_f77_int (m_jacpattern.cidx (j));
+
+      for (octave_f77_int_type k = 0; k < to_f77_int (m_jacpattern.nnz ());
+           k++)
+        rowvals[k] = to_f77_int (m_jacpattern.ridx (k));
+
+      jdata = SUNSparseMatrix_Data (JJ);
+    }
+#  endif
+
+  if (! sparse_jac)
+    {
+      SUNMatZero (JJ);
+      jdata = SUNDenseMatrix_Data (JJ);
+    }
+
+  ColumnVector inc (m_num);
+
+  octave_idx_type num_colors = m_color_ptr.numel () - 1;
+
+  for (octave_idx_type c = 0; c < num_colors; c++)
+    {
+      ColumnVector ypert = y;
+      ColumnVector yppert = yp;
+
+      for (octave_idx_type l = m_color_ptr(c); l < m_color_ptr(c+1); l++)
+        {
+          octave_idx_type j = m_color_cols(l);
+
+          double d = srur * std::max ({std::abs (y(j)),
+                                       std::abs (hh * yp(j)),
+                                       1.0 / wt(j)});
+          if (hh * yp(j) < 0.0)
+            d = -d;
+          d = (y(j) + d) - y(j);
+
+          inc(j) = d;
+          ypert(j) += d;
+          yppert(j) += cj * d;
+        }
+
+      ColumnVector rpert = (*m_fcn) (ypert, yppert, t, m_ida_fcn);
+
+      m_num_fd_res++;
+
+      for (octave_idx_type l = m_color_ptr(c); l < m_color_ptr(c+1); l++)
+        {
+          octave_idx_type j = m_color_cols(l);
+
+          for (octave_idx_type k = m_jacpattern.cidx (j);
+               k < m_jacpattern.cidx (j+1); k++)
+            {
+              octave_idx_type i = m_jacpattern.ridx (k);
+
+              double val = (rpert(i) - res(i)) / inc(j);
+
+              if (sparse_jac)
+                jdata[k] = val;
+              else
+                jdata[i + j * m_num] = val;
+            }
+        }
+    }
+}
+
+#  if defined (HAVE_SUNDIALS_SUNLINSOL_SPILS)
+void
+IDA::precsolve_impl (realtype t, N_Vector& yy, N_Vector& yyp,
+                     N_Vector& rvec, N_Vector& zvec, realtype cj)
+{
+  ColumnVector y = NVecToCol (yy, m_num);
+
+  ColumnVector yp = NVecToCol (yyp, m_num);
+
+  ColumnVector r = NVecToCol (rvec, m_num);
+
+  ColumnVector z = (*m_precfcn) (y, yp, t, r, cj, m_ida_prec);
+
+  realtype *puntz = nv_data_s (zvec);
+
+  for (octave_idx_type i = 0; i < m_num; i++)
+    puntz[i] = z(i);
+}
+#  endif
+
 ColumnVector
 IDA::NVecToCol (N_Vector& v, octave_f77_int_type n)
 {
@@ -1063,12 +1446,67 @@ IDA::print_stat ()
   if (IDAGetNumResEvals (m_mem, &nrevals) != 0)
     error ("IDA failed to return the number of residual evaluations");
 
+  long int nsetups = 0, nniters = 0;
+
+  if (IDAGetNumLinSolvSetups (m_mem, &nsetups) != 0)
+    error ("IDA failed to return the number of linear solver setups");
+
+  if (IDAGetNumNonlinSolvIters (m_mem, &nniters) != 0)
+    error ("IDA failed to return the number of nonlinear iterations");
+
+  long int nlinrevals = 0;
+
+#  if defined (HAVE_IDAGETNUMJACEVALS)
+  long int njevals = 0;
+
+  if (IDAGetNumJacEvals (m_mem, &njevals) != 0)
+    error ("IDA failed to return the number of Jacobian evaluations");
+
+  if (IDAGetNumLinResEvals (m_mem, &nlinrevals) != 0)
+    error ("IDA failed to return the number of residual evaluations");
+#  endif
+
+  // Include the evaluations for finite difference Jacobians.
+  nrevals += nlinrevals + m_num_fd_res;
+
   octave_stdout << nsteps << " successful steps\n";
   octave_stdout << netfails << " failed attempts\n";
   octave_stdout << nrevals << " function evaluations\n";
-  // octave_stdout << " partial derivatives\n";
-  // octave_stdout << " LU decompositions\n";
-  // octave_stdout << " solutions of linear systems\n";
+
+  if (m_krylov)
+    {
+#  if defined (HAVE_SUNDIALS_SUNLINSOL_SPILS)
+      long int nliters = 0, npsolves = 0, nlcfails = 0;
+
+      if (IDAGetNumLinIters (m_mem, &nliters) != 0)
+        error ("IDA failed to return the number of linear iterations");
+
+      if (IDAGetNumPrecSolves (m_mem, &npsolves) != 0)
+        error ("IDA failed to return the number of preconditioner solves");
+
+      if (IDAGetNumLinConvFails (m_mem, &nlcfails) != 0)
+        error ("IDA failed to return the number of linear convergence failures");
+
+      octave_stdout << nniters << " nonlinear iterations\n";
+      octave_stdout << nliters << " linear iterations\n";
+      octave_stdout << nlcfails << " linear convergence failures\n";
+      octave_stdout << npsolves << " preconditioner solves\n";
+#  endif
+    }
+  else
+    {
+#  if defined (HAVE_IDAGETNUMJACEVALS)
+      octave_stdout << njevals << " partial derivatives\n";
+#  endif
+      octave_stdout << nsetups << " LU decompositions\n";
+      octave_stdout << m_num_lin_solves << " solutions of linear systems\n";
+
+      // Each LU decomposition is reused for all following Newton
+      // iterations until IDA decides that it is out of date.
+      if (nsetups > 0)
+        octave_stdout << static_cast<double> (nsteps) / nsetups
+                      << " steps per LU decomposition\n";
+    }
 }
 
 static ColumnVector
@@ -1091,6 +1529,35 @@ ida_user_function (const ColumnVector& x, const ColumnVector& xdot,
   return tmp(0).vector_value ();
 }
 
+static ColumnVector
+ida_user_prec (const ColumnVector& x, const ColumnVector& xdot,
+               double t, const ColumnVector& r, double cj,
+               const octave_value& ida_pc)
+{
+  octave_value_list tmp;
+
+  try
+    {
+      interpreter& interp = __get_interpreter__ ();
+
+      tmp = interp.feval (ida_pc, ovl (t, x, xdot, r, cj), 1);
+    }
+  catch (execution_exception& ee)
+    {
+      err_user_supplied_eval (ee, "__ode15__");
+    }
+
+  if (tmp.empty () || ! tmp(0).is_defined ())
+    err_user_supplied_eval ("__ode15__");
+
+  ColumnVector z = tmp(0).vector_value ();
+
+  if (z.numel () != r.numel ())
+    error ("__ode15__: preconditioner must return a vector of the same length as Y0");
+
+  return z;
+}
+
 static Matrix
 ida_dense_jac (const ColumnVector& x, const ColumnVector& xdot,
                double t, double cj, const octave_value& ida_jc)
@@ -1202,6 +1669,24 @@ do_ode15 (const octave_value& ida_fcn,
         }
     }
 
+  // Sparsity pattern for finite difference Jacobian
+  if (! havejac && options.getfield ("havejacpattern").bool_value ())
+    dae.set_jacobian_pattern (options.getfield ("JPattern")
+                              .sparse_bool_matrix_value ());
+
+  // Iterative linear solver
+  std::string linsolver = options.getfield ("LinearSolver").string_value ();
+
+  if (linsolver != "direct")
+    {
+      octave_value ida_prec = options.getfield ("Preconditioner");
+
+      if (! ida_prec.is_function_handle ())
+        ida_prec = octave_value ();
+
+      dae.set_linear_solver (linsolver, ida_prec, ida_user_prec);
+    }
+
   // Initialize IDA
   dae.initialize ();
 
@@ -54,23 +54,33 @@
 #include <cstdio>
 #include <cstring>
 
+#include <algorithm>
 #include <functional>
 #include <list>
+#include <map>
+#include <memory>
+#include <set>
 #include <stdexcept>
+#include <utility>
 #include <string>
+#include <vector>
 
 #include "Array.h"
 #include "dir-ops.h"
 #include "file-ops.h"
 #include "file-stat.h"
 #include "glob-match.h"
+#include "lo-mappers.h"
 #include "lo-sysdep.h"
 #include "oct-env.h"
+#include "oct-parallel.h"
+#include "oct-string.h"
 #include "str-vec.h"
 
 #include "Cell.h"
 #include "defun-dld.h"
 #include "defun-int.h"
+#include "error.h"
 #include "errwarn.h"
 #include "ov.h"
 #include "ovl.h"
@@ -134,15 +144,25 @@ public:
 
   static const constexpr char *extension = ".bz2";
 
+  static const int default_level = 9;
+
+  // Files up to this size are compressed as a single block.
+  static std::size_t block_size (int level)
+  {
+    return level * 100000;
+  }
+
   static void zip (const std::string& source_path,
-                   const std::string& dest_path)
+                   const std::string& dest_path, int level, bool parallel)
   {
-    bz2::zipper z (source_path, dest_path);
-    z.deflate ();
+    bz2::zipper z (source_path, dest_path, level);
+    z.deflate (parallel);
     z.close ();
   }
 
-private:
+  // The input is split into blocks of the bzip2 block size that are
+  // compressed independently, possibly in parallel, as complete bzip2
+  // streams.  bzip2 decompresses concatenated streams as one file.
 
   class zipper
   {
@@ -150,48 +170,87 @@ private:
 
     zipper () = delete;
 
-    zipper (const std::string& source_path, const std::string& dest_path)
-      : m_status (BZ_OK), m_source (source_path, "rb"),
-        m_dest (dest_path, "wb"),
-        m_bz (BZ2_bzWriteOpen (&m_status, m_dest.m_fp, 9, 0, 30))
-    {
-      if (m_status != BZ_OK)
-        throw std::runtime_error ("failed to open bzip2 stream");
-    }
+    zipper (const std::string& source_path, const std::string& dest_path,
+            int level)
+      : m_source (source_path, "rb"), m_dest (dest_path, "wb"),
+        m_level (level), m_dest_empty (true)
+    { }
 
     OCTAVE_DISABLE_COPY_MOVE (zipper)
 
-    ~zipper ()
-    {
-      if (m_bz != nullptr)
-        BZ2_bzWriteClose (&m_status, m_bz, 1, nullptr, nullptr);
-    }
+    ~zipper () = default;
 
-    void deflate ()
+    void deflate (bool parallel)
     {
-      const std::size_t buf_len = 8192;
-      char buf[buf_len];
-      std::size_t n_read;
-      while ((n_read = std::fread (buf, sizeof (buf[0]), buf_len, m_source.m_fp)) != 0)
+      const std::size_t block_len = block_size (m_level);
+
+      // Number of blocks read and compressed at a time.
+      const std::size_t n_round = (parallel ? 16 : 1);
+
+      std::vector<char> buf_in (n_round * block_len);
+
+      // See the bzip2 documentation for the size of the output buffer.
+      const std::size_t out_len = block_len + block_len / 100 + 600;
+
+      std::vector<char> buf_out (n_round * out_len);
+      std::vector<unsigned int> n_out (n_round);
+      std::vector<int> status (n_round);
+
+      bool done = false;
+
+      while (! done)
         {
+          std::size_t n_read = std::fread (buf_in.data (), 1, buf_in.size (),
+                                           m_source.m_fp);
+
           if (std::ferror (m_source.m_fp))
             throw std::runtime_error ("failed to read from source file");
-          BZ2_bzWrite (&m_status, m_bz, buf, n_read);
-          if (m_status == BZ_IO_ERROR)
-            throw std::runtime_error ("failed to write or compress");
+
+          done = (n_read < buf_in.size ());
+
+          octave_idx_type n_blocks = (n_read + block_len - 1) / block_len;
+
+          // An empty file is compressed to an empty stream.
+          if (n_blocks == 0 && m_dest_empty)
+            n_blocks = 1;
+
+          auto compress_blocks = [&] (octave_idx_type lo, octave_idx_type hi)
+          {
+            for (octave_idx_type i = lo; i < hi; i++)
+              {
+                std::size_t beg = i * block_len;
+                std::size_t len = std::min (block_len, n_read - beg);
+
+                n_out[i] = out_len;
+                status[i]
+                  = BZ2_bzBuffToBuffCompress (&buf_out[i * out_len], &n_out[i],
+                                              &buf_in[beg], len,
+                                              m_level, 0, 30);
+              }
+          };
+
+          if (parallel)
+            parallel_for (n_blocks, 1, compress_blocks);
+          else
+            compress_blocks (0, n_blocks);
+
+          for (octave_idx_type i = 0; i < n_blocks; i++)
+            {
+              if (status[i] != BZ_OK)
+                throw std::runtime_error ("failed to compress");
+
+              std::fwrite (&buf_out[i * out_len], 1, n_out[i], m_dest.m_fp);
+
+              if (std::ferror (m_dest.m_fp))
+                throw std::runtime_error ("failed to write file");
+
+              m_dest_empty = false;
+            }
         }
-      if (std::ferror (m_source.m_fp))
-        throw std::runtime_error ("failed to read from source file");
     }
 
     void close ()
     {
-      int abandon = (m_status == BZ_IO_ERROR) ? 1 : 0;
-      BZ2_bzWriteClose (&m_status, m_bz, abandon, nullptr, nullptr);
-      if (m_status != BZ_OK)
-        throw std::runtime_error ("failed to close bzip2 stream");
-      m_bz = nullptr;
-
       // We have no error handling for failing to close source, let
       // the destructor close it.
       m_dest.close ();
@@ -199,10 +258,10 @@ private:
 
   private:
 
-    int m_status;
     CFile m_source;
     CFile m_dest;
-    BZFILE *m_bz;
+    int m_level;
+    bool m_dest_empty;
   };
 };
 
@@ -243,11 +302,19 @@ public:
 
   static const constexpr char *extension = ".gz";
 
+  static const int default_level = 8;
+
+  // Files up to this size are compressed as a single block.
+  static std::size_t block_size (int)
+  {
+    return 256 * 1024;
+  }
+
   static void zip (const std::string& source_path,
-                   const std::string& dest_path)
+                   const std::string& dest_path, int level, bool parallel)
   {
-    gz::zipper z (source_path, dest_path);
-    z.deflate ();
+    gz::zipper z (source_path, dest_path, level);
+    z.deflate (parallel);
     z.close ();
   }
 
@@ -357,97 +424,194 @@ private:
     uchar_array m_basename;
   };
 
+  // One block of input compressed as raw deflate data.
+
+  class deflate_block
+  {
+  public:
+
+    deflate_block ()
+      : m_out (), m_out_len (0), m_crc (0), m_ok (false)
+    { }
+
+    OCTAVE_DEFAULT_COPY_MOVE (deflate_block)
+
+    ~deflate_block () = default;
+
+    // Make room for the compressed data of up to LEN bytes of input.
+    // This is done before blocks are compressed in parallel so that no
+    // memory is allocated by the threads.
+    void reserve (std::size_t len)
+    {
+      // Room for the data and the marker written by the sync flush.
+      m_out.resize (compressBound (len) + 16);
+    }
+
+    // Compress LEN bytes at DATA using the DICT_LEN bytes at DICT, the
+    // input that precedes DATA, as dictionary.  The last block ends
+    // the deflate stream.  All other blocks end with a sync flush, so
+    // they are byte-aligned and can be concatenated.
+    void compress (unsigned char *data, std::size_t len,
+                   unsigned char *dict, std::size_t dict_len,
+                   int level, bool last)
+    {
+      m_ok = false;
+      m_out_len = 0;
+      m_crc = crc32 (crc32 (0L, Z_NULL, 0), data, len);
+
+      z_stream strm;
+      strm.zalloc = Z_NULL;
+      strm.zfree = Z_NULL;
+      strm.opaque = Z_NULL;
+
+      // Negative window bits select raw deflate data without header
+      // and trailer.
+      if (deflateInit2 (&strm, level, Z_DEFLATED, -15, 8,
+                        Z_DEFAULT_STRATEGY) != Z_OK)
+        return;
+
+      if (dict_len == 0 || deflateSetDictionary (&strm, dict, dict_len) == Z_OK)
+        {
+          strm.next_in = data;
+          strm.avail_in = len;
+          strm.next_out = m_out.data ();
+          strm.avail_out = m_out.size ();
+
+          int status = ::deflate (&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+
+          m_ok = (last ? status == Z_STREAM_END
+                  : status == Z_OK && strm.avail_in == 0
+                    && strm.avail_out > 0);
+
+          m_out_len = m_out.size () - strm.avail_out;
+        }
+
+      deflateEnd (&strm);
+    }
+
+    std::vector<unsigned char> m_out;
+    std::size_t m_out_len;
+    uLong m_crc;
+    bool m_ok;
+  };
+
+public:
+
+  // The input is split into blocks that are compressed independently,
+  // possibly in parallel, and concatenated to a single deflate stream
+  // in a gzip wrapper.  Each block is compressed with the last 32 KiB
+  // of the input that precedes it as dictionary, so the compression
+  // ratio is nearly the same as that of a single stream.
+
   class zipper
   {
   public:
 
     zipper () = delete;
 
-    zipper (const std::string& source_path, const std::string& dest_path)
+    zipper (const std::string& source_path, const std::string& dest_path,
+            int level)
       : m_source (source_path, "rb"), m_dest (dest_path, "wb"),
-        m_header (source_path), m_strm (new z_stream)
-    {
-      m_strm->zalloc = Z_NULL;
-      m_strm->zfree = Z_NULL;
-      m_strm->opaque = Z_NULL;
-    }
+        m_header (source_path), m_level (level)
+    { }
 
     OCTAVE_DISABLE_COPY_MOVE (zipper)
 
-    ~zipper ()
-    {
-      if (m_strm)
-        deflateEnd (m_strm);
-      delete m_strm;
-    }
+    ~zipper () = default;
 
-    void deflate ()
+    void deflate (bool parallel)
     {
-      // int deflateInit2 (z_streamp m_strm,
-      //                   int  level,      // compression level (default is 8)
-      //                   int  method,
-      //                   int  windowBits, // 15 (default) + 16 (gzip format)
-      //                   int  memLevel,   // memory usage (default is 8)
-      //                   int  strategy);
-      int status = deflateInit2 (m_strm, 8, Z_DEFLATED, 31, 8,
-                                 Z_DEFAULT_STRATEGY);
-      if (status != Z_OK)
-        throw std::runtime_error ("failed to open zlib stream");
-
-      deflateSetHeader (m_strm, &m_header);
-
-      const std::size_t buf_len = 8192;
-      unsigned char buf_in[buf_len];
-      unsigned char buf_out[buf_len];
-
-      int flush;
-
-      do
+      write_header ();
+
+      const std::size_t block_len = block_size (m_level);
+      const std::size_t dict_size = 32768;
+
+      // Number of blocks read and compressed at a time.
+      const std::size_t n_round = (parallel ? 64 : 1);
+
+      std::vector<unsigned char> buf_in (n_round * block_len);
+      std::vector<unsigned char> dict;
+
+      std::vector<deflate_block> blocks (n_round);
+      for (auto& blk : blocks)
+        blk.reserve (block_len);
+
+      uLong crc = crc32 (0L, Z_NULL, 0);
+      uLong total_len = 0;
+
+      bool done = false;
+
+      while (! done)
         {
-          m_strm->avail_in = std::fread (buf_in, sizeof (buf_in[0]),
-                                         buf_len, m_source.m_fp);
+          std::size_t n_read = std::fread (buf_in.data (), 1, buf_in.size (),
+                                           m_source.m_fp);
 
           if (std::ferror (m_source.m_fp))
             throw std::runtime_error ("failed to read source file");
 
-          m_strm->next_in = buf_in;
-          flush = (std::feof (m_source.m_fp) ? Z_FINISH : Z_NO_FLUSH);
+          done = (n_read < buf_in.size ());
+
+          octave_idx_type n_blocks = (n_read + block_len - 1) / block_len;
 
-          // If deflate returns Z_OK and with zero avail_out, it must be
-          // called again after making room in the output buffer because
-          // there might be more output pending.
-          do
+          // The final block may be empty.
+          if (done && n_read % block_len == 0)
+            n_blocks++;
+
+          auto compress_blocks = [&] (octave_idx_type lo, octave_idx_type hi)
+          {
+            for (octave_idx_type i = lo; i < hi; i++)
+              {
+                std::size_t beg = std::min (i * block_len, n_read);
+                std::size_t len = std::min (block_len, n_read - beg);
+
+                bool last = (done && i == n_blocks - 1);
+
+                if (i == 0)
+                  blocks[i].compress (&buf_in[beg], len, dict.data (),
+                                      dict.size (), m_level, last);
+                else
+                  blocks[i].compress (&buf_in[beg], len,
+                                      &buf_in[beg - dict_size], dict_size,
+                                      m_level, last);
+              }
+          };
+
+          if (parallel)
+            parallel_for (n_blocks, 1, compress_blocks);
+          else
+            compress_blocks (0, n_blocks);
+
+          for (octave_idx_type i = 0; i < n_blocks; i++)
             {
-              m_strm->avail_out = buf_len;
-              m_strm->next_out = buf_out;
-              status = ::deflate (m_strm, flush);
-              if (status == Z_STREAM_ERROR)
+              const deflate_block& blk = blocks[i];
+
+              if (! blk.m_ok)
                 throw std::runtime_error ("failed to deflate");
 
-              std::fwrite (buf_out, sizeof (buf_out[0]),
-                           buf_len - m_strm->avail_out, m_dest.m_fp);
+              std::fwrite (blk.m_out.data (), 1, blk.m_out_len, m_dest.m_fp);
+
               if (std::ferror (m_dest.m_fp))
                 throw std::runtime_error ("failed to write file");
-            }
-          while (m_strm->avail_out == 0);
 
-          if (m_strm->avail_in != 0)
-            throw std::runtime_error ("failed to write file");
+              std::size_t beg = std::min (i * block_len, n_read);
+              std::size_t len = std::min (block_len, n_read - beg);
+
+              crc = crc32_combine (crc, blk.m_crc, len);
+              total_len += len;
+            }
 
+          if (! done)
+            dict.assign (buf_in.end () - dict_size, buf_in.end ());
         }
-      while (flush != Z_FINISH);
 
-      if (status != Z_STREAM_END)
-        throw std::runtime_error ("failed to write file");
+      // The trailer holds the CRC-32 and the length of the input
+      // modulo 2^32.
+      write_le32 (crc);
+      write_le32 (total_len);
     }
 
     void close ()
     {
-      if (deflateEnd (m_strm) != Z_OK)
-        throw std::runtime_error ("failed to close zlib stream");
-      delete m_strm;
-      m_strm = nullptr;
-
       // We have no error handling for failing to close source, let
       // the destructor close it.
       m_dest.close ();
@@ -455,25 +619,132 @@ private:
 
   private:
 
+    void write_le32 (uLong val)
+    {
+      unsigned char buf[4];
+
+      for (int i = 0; i < 4; i++)
+        buf[i] = (val >> (8 * i)) & 0xFF;
+
+      std::fwrite (buf, 1, 4, m_dest.m_fp);
+
+      if (std::ferror (m_dest.m_fp))
+        throw std::runtime_error ("failed to write file");
+    }
+
+    // Write the header defined in RFC 1952 with the same fields that
+    // deflateSetHeader would write.
+    void write_header ()
+    {
+      // ID1, ID2, compression method (deflate), and flags (file name).
+      const unsigned char id[4] = {0x1f, 0x8b, 8, 0x08};
+
+      std::fwrite (id, 1, 4, m_dest.m_fp);
+
+      write_le32 (m_header.time);
+
+      // Extra flags: 2 for maximum compression, 4 for fastest.
+      const unsigned char xfl_os[2]
+        = {static_cast<unsigned char> (m_level == 9 ? 2
+                                       : (m_level == 1 ? 4 : 0)),
+           static_cast<unsigned char> (m_header.os)};
+
+      std::fwrite (xfl_os, 1, 2, m_dest.m_fp);
+
+      const char *name = reinterpret_cast<const char *> (m_header.name);
+
+      std::fwrite (name, 1, std::strlen (name) + 1, m_dest.m_fp);
+
+      if (std::ferror (m_dest.m_fp))
+        throw std::runtime_error ("failed to write file");
+    }
+
     CFile m_source;
     CFile m_dest;
     gzip_header m_header;
-    z_stream *m_strm;
+    int m_level;
   };
 };
 
 #endif
 
 
+// Compress one file.  On failure, remove the destination file, which
+// may not have been created in the first place.  Note that it is
+// possible for the file to exist before the call to X::zip and that
+// X::zip has not clobbered it yet, but we remove it anyway.
+
+template<typename X>
+static bool
+zip_file (const std::string& source_path, const std::string& dest_path,
+          int level, bool parallel)
+{
+  try
+    {
+      X::zip (source_path, dest_path, level, parallel);
+    }
+  catch (const interrupt_exception&)
+    {
+      throw;  // interrupts are special, just re-throw.
+    }
+  catch (...)
+    {
+      sys::unlink (dest_path);
+      return false;
+    }
+
+  return true;
+}
+
+// Return a name for the file at PATH that is the same for all the ways
+// of writing PATH.  If PATH does not exist yet, as for most destination
+// files, canonicalize its directory and append the file name, so that
+// "a.gz" and "./a.gz" still give the same name.
+
+static std::string
+file_key (const std::string& path)
+{
+  std::string msg;
+  std::string retval = sys::canonicalize_file_name (path, msg);
+
+  if (! retval.empty ())
+    return retval;
+
+  std::size_t pos = path.find_last_of (sys::file_ops::dir_sep_chars ());
+
+  std::string dir;
+  std::string base;
+
+  if (pos == std::string::npos)
+    {
+      dir = ".";
+      base = path;
+    }
+  else
+    {
+      dir = path.substr (0, pos == 0 ? 1 : pos);
+      base = path.substr (pos+1);
+    }
+
+  std::string canon_dir = sys::canonicalize_file_name (dir, msg);
+
+  return canon_dir.empty () ? path : sys::file_ops::concat (canon_dir, base);
+}
+
 template<typename X>
 string_vector
 xzip (const Array<std::string>& source_patterns,
-      const std::function<std::string(const std::string&)>& mk_dest_path)
+      const std::function<std::string(const std::string&)>& mk_dest_path,
+      int level)
 {
-  std::list<std::string> dest_paths;
+  // Files to compress, with their destination paths and sizes.
+  std::vector<std::string> source_paths;
+  std::vector<std::string> dest_paths;
+  std::vector<std::size_t> sizes;
 
   std::function<void(const std::string&)> walk;
-  walk = [&walk, &mk_dest_path, &dest_paths] (const std::string& path) -> void
+  walk = [&walk, &mk_dest_path, &source_paths, &dest_paths, &sizes]
+         (const std::string& path) -> void
   {
     const sys::file_stat fs (path);
     // is_dir and is_reg will return false if failed to stat.
@@ -495,26 +766,9 @@ xzip (const Array<std::string>& source_patterns,
       }
     else if (fs.is_reg ())
       {
-        const std::string dest_path = mk_dest_path (path);
-        try
-          {
-            X::zip (path, dest_path);
-          }
-        catch (const interrupt_exception&)
-          {
-            throw;  // interrupts are special, just re-throw.
-          }
-        catch (...)
-          {
-            // Error "handling" is not including filename on the output list.
-            // Also, remove created file which may not have been created
-            // in the first place.  Note that it is possible for the file
-            // to exist before the call to X::zip and that X::zip has not
-            // clobber it yet, but we remove it anyway.
-            sys::unlink (dest_path);
-            return;
-          }
-        dest_paths.push_front (dest_path);
+        source_paths.push_back (path);
+        dest_paths.push_back (mk_dest_path (path));
+        sizes.push_back (fs.size ());
       }
     // Skip all other file types and errors.
     return;
@@ -527,13 +781,168 @@ xzip (const Array<std::string>& source_patterns,
       for (octave_idx_type j = 0; j < filepaths.numel (); j++)
         walk (filepaths(j));
     }
-  return string_vector (dest_paths);
+
+  // Files that fit in one block are compressed concurrently, one file
+  // per thread.  They are opened, and their headers are built, on this
+  // thread.  All other files are compressed one after the other, in the
+  // order given, each split into blocks that are compressed in parallel.
+  //
+  // The same file may be listed more than once, and the destination of
+  // one file may be the source of another, as in gzip ({"a", "a.gz"}).
+  // Repeated entries are compressed only once, but are still listed in
+  // the output as before.  Files that share a destination, or whose
+  // source is another entry's destination, are compressed one after the
+  // other, so the result does not depend on timing.
+
+  octave_idx_type n_files = source_paths.size ();
+
+  std::vector<std::string> source_keys (n_files);
+  std::vector<std::string> dest_keys (n_files);
+
+  for (octave_idx_type i = 0; i < n_files; i++)
+    {
+      source_keys[i] = file_key (source_paths[i]);
+      dest_keys[i] = file_key (dest_paths[i]);
+    }
+
+  // For repeated entries, the index of the first one, otherwise -1.
+  std::vector<octave_idx_type> repeat_of (n_files, -1);
+  std::map<std::pair<std::string, std::string>, octave_idx_type> seen;
+  std::set<std::string> sources;
+  std::map<std::string, octave_idx_type> n_writers;
+
+  for (octave_idx_type i = 0; i < n_files; i++)
+    {
+      auto ins = seen.insert ({{source_keys[i], dest_keys[i]}, i});
+
+      if (! ins.second)
+        repeat_of[i] = ins.first->second;
+      else
+        {
+          sources.insert (source_keys[i]);
+          n_writers[dest_keys[i]]++;
+        }
+    }
+
+  std::vector<octave_idx_type> small_files;
+  std::vector<octave_idx_type> serial_files;
+
+  for (octave_idx_type i = 0; i < n_files; i++)
+    {
+      if (repeat_of[i] >= 0)
+        continue;
+
+      if (sizes[i] <= X::block_size (level)
+          && n_writers[dest_keys[i]] == 1
+          && sources.find (dest_keys[i]) == sources.end ()
+          && n_writers.find (source_keys[i]) == n_writers.end ())
+        small_files.push_back (i);
+      else
+        serial_files.push_back (i);
+    }
+
+  // Error "handling" is not including filename on the output list.
+  std::vector<char> ok (n_files, false);
+
+  // Limit the number of files open at the same time.
+  const std::size_t batch_size = 64;
+
+  for (std::size_t b = 0; b < small_files.size (); b += batch_size)
+    {
+      std::size_t nb = std::min (batch_size, small_files.size () - b);
+
+      std::vector<std::unique_ptr<typename X::zipper>> zippers (nb);
+      std::vector<char> deflated (nb, false);
+
+      for (std::size_t k = 0; k < nb; k++)
+        {
+          octave_idx_type i = small_files[b+k];
+
+          try
+            {
+              zippers[k].reset (new typename X::zipper (source_paths[i],
+                                                        dest_paths[i],
+                                                        level));
+            }
+          catch (const interrupt_exception&)
+            {
+              throw;  // interrupts are special, just re-throw.
+            }
+          catch (...)
+            {
+              sys::unlink (dest_paths[i]);
+            }
+        }
+
+      parallel_for (nb, 1, [&] (octave_idx_type lo, octave_idx_type hi)
+      {
+        for (octave_idx_type k = lo; k < hi; k++)
+          {
+            if (! zippers[k])
+              continue;
+
+            try
+              {
+                zippers[k]->deflate (false);
+                deflated[k] = true;
+              }
+            catch (...)
+              {
+                // Reported as a failure below.
+              }
+          }
+      });
+
+      for (std::size_t k = 0; k < nb; k++)
+        {
+          octave_idx_type i = small_files[b+k];
+
+          if (! zippers[k])
+            continue;
+
+          if (deflated[k])
+            {
+              try
+                {
+                  zippers[k]->close ();
+                  ok[i] = true;
+                }
+              catch (...)
+                {
+                  // Reported as a failure below.
+                }
+            }
+
+          zippers[k].reset ();
+
+          if (! ok[i])
+            sys::unlink (dest_paths[i]);
+        }
+    }
+
+  for (octave_idx_type i : serial_files)
+    ok[i] = zip_file<X> (source_paths[i], dest_paths[i], level,
+                         sizes[i] > X::block_size (level));
+
+  for (octave_idx_type i = 0; i < n_files; i++)
+    if (repeat_of[i] >= 0)
+      ok[i] = ok[repeat_of[i]];
+
+  std::list<std::string> retval;
+
+  for (octave_idx_type i = 0; i < n_files; i++)
+    {
+      if (ok[i])
+        retval.push_front (dest_paths[i]);
+    }
+
+  return string_vector (retval);
 }
 
 
 template<typename X>
 string_vector
-xzip (const Array<std::string>& source_patterns)
+xzip (const Array<std::string>& source_patterns, int level)
 {
   const std::string ext = X::extension;
   const std::function<std::string(const std::string&)> mk_dest_path
@@ -541,12 +950,13 @@ xzip (const Array<std::string>& source_patterns)
   {
     return source_path + ext;
   };
-  return xzip<X> (source_patterns, mk_dest_path);
+  return xzip<X> (source_patterns, mk_dest_path, level);
 }
 
 template<typename X>
 string_vector
-xzip (const Array<std::string>& source_patterns, const std::string& out_dir)
+xzip (const Array<std::string>& source_patterns, const std::string& out_dir,
+      int level)
 {
   const std::string ext = X::extension;
   const std::function<std::string(const std::string&)> mk_dest_path
@@ -564,26 +974,51 @@ xzip (const Array<std::string>& source_patterns, const std::string& out_dir)
   // nothing to do, if the later, then it will be handled later.  Any
   // is to be handled by not listing files in the output.
   sys::mkdir (out_dir, 0777);
-  return xzip<X> (source_patterns, mk_dest_path);
+  return xzip<X> (source_patterns, mk_dest_path, level);
 }
 
 template<typename X>
 static octave_value_list
 xzip (const std::string& fcn_name, const octave_value_list& args)
 {
-  const octave_idx_type nargin = args.length ();
-  if (nargin < 1 || nargin > 2)
+  octave_idx_type nargin = args.length ();
+  if (nargin < 1 || nargin > 4)
     print_usage ();
 
+  int level = X::default_level;
+
+  if (nargin > 2)
+    {
+      const std::string opt
+        = args(nargin-2).xstring_value ("%s: OPTION must be a string",
+                                        fcn_name.c_str ());
+
+      if (! string::strcmpi (opt, "level"))
+        error ("%s: unknown option '%s'", fcn_name.c_str (), opt.c_str ());
+
+      const double dlevel
+        = args(nargin-1).xdouble_value ("%s: LEVEL must be an integer",
+                                        fcn_name.c_str ());
+
+      if (math::x_nint (dlevel) != dlevel)
+        error ("%s: LEVEL must be an integer", fcn_name.c_str ());
+      if (dlevel < 1 || dlevel > 9)
+        error ("%s: LEVEL must be between 1 and 9", fcn_name.c_str ());
+
+      level = static_cast<int> (dlevel);
+
+      nargin -= 2;
+    }
+
   const Array<std::string> source_patterns
     = args(0).xcellstr_value ("%s: FILES must be a character array or cellstr",
                               fcn_name.c_str ());
   if (nargin == 1)
-    return octave_value (Cell (xzip<X> (source_patterns)));
+    return octave_value (Cell (xzip<X> (source_patterns, level)));
   else // nargin == 2
     {
       const std::string out_dir = args(1).string_value ();
-      return octave_value (Cell (xzip<X> (source_patterns, out_dir)));
+      return octave_value (Cell (xzip<X> (source_patterns, out_dir, level)));
     }
 }
 
@@ -591,6 +1026,7 @@ DEFUN_DLD (gzip, args, nargout,
            doc: /* -*- texinfo -*-
 @deftypefn  {} {@var{filelist} =} gzip (@var{files})
 @deftypefnx {} {@var{filelist} =} gzip (@var{files}, @var{dir})
+@deftypefnx {} {@var{filelist} =} gzip (@dots{}, "level", @var{level})
 Compress the list of files and directories specified in @var{files}.
 
 @var{files} is a character array or cell array of strings.  Shell wildcards
@@ -609,6 +1045,14 @@ same name.
 
 If @var{dir} does not exist it is created.
 
+The optional compression @var{level} is an integer from 1 (fastest) to 9
+(best compression).  The default is 8.
+
+Large files are split into blocks that are compressed in parallel, and
+many small files are compressed concurrently, when Octave was built with
+OpenMP support.  The output is a single standard gzip stream that any
+@code{gunzip} can decompress.
+
 The optional output @var{filelist} is a list of the compressed files.
 @seealso{gunzip, unpack, bzip2, zip, tar}
 @end deftypefn */)
@@ -633,12 +1077,18 @@ The optional output @var{filelist} is a list of the compressed files.
 %!error gzip ()
 %!error gzip ("1", "2", "3")
 %!error <FILES must be a character array or cellstr|was unavailable or disabled> gzip (1)
+%!error <unknown option|was unavailable or disabled> gzip ("1", "foo", 1)
+%!error <LEVEL must be between 1 and 9|was unavailable or disabled>
+%! gzip ("1", "level", 0)
+%!error <LEVEL must be an integer|was unavailable or disabled>
+%! gzip ("1", "level", 2.5)
 */
 
 DEFUN_DLD (bzip2, args, nargout,
            doc: /* -*- texinfo -*-
 @deftypefn  {} {@var{filelist} =} bzip2 (@var{files})
 @deftypefnx {} {@var{filelist} =} bzip2 (@var{files}, @var{dir})
+@deftypefnx {} {@var{filelist} =} bzip2 (@dots{}, "level", @var{level})
 Compress the list of files specified in @var{files}.
 
 @var{files} is a character array or cell array of strings.  Shell wildcards
@@ -655,6 +1105,14 @@ same name.
 
 If @var{dir} does not exist it is created.
 
+The optional compression @var{level} is an integer from 1 (fastest) to 9
+(best compression).  The default is 9.
+
+Large files are split into blocks that are compressed in parallel, and
+many small files are compressed concurrently, when Octave was built with
+OpenMP support.  Each block is written as a separate bzip2 stream, which
+standard @code{bunzip2} decompresses as a single file.
+
 The optional output @var{filelist} is a list of the compressed files.
 @seealso{bunzip2, unpack, gzip, zip, tar}
 @end deftypefn */)
@@ -747,6 +1205,25 @@ The optional output @var{filelist} is a list of the compressed files.
 %!endfunction
 %!test run_test_function (@test_large_file)
 
+## Test compression levels with a file that spans several blocks
+%!function test_level (test_dir, z)
+%!  test_file = tempname (test_dir);
+%!  create_file (test_file, repmat (rand (1000, 1), 300, 1));
+%!  md5 = hash ("md5", fileread (test_file));
+%!
+%!  z_file = [test_file z.ext];
+%!  for level = [1, 9]
+%!    z_filelist = z.zip (test_file, "level", level);
+%!    assert (is_same_file (z_filelist, {z_file}))
+%!
+%!    unlink_or_error (test_file);
+%!    uz_filelist = z.unzip (z_file);
+%!    assert (is_same_file (uz_filelist, {test_file}))
+%!    assert (hash ("md5", fileread (test_file)), md5)
+%!  endfor
+%!endfunction
+%!test run_test_function (@test_level)
+
 ## Test that xzipped files are rexzipped (hits bug #43206, #48598)
 %!function test_z_z (test_dir, z)
 %!  ori_file = tempname (test_dir);
@@ -781,6 +1258,42 @@ The optional output @var{filelist} is a list of the compressed files.
 %!endfunction
 %!test <43206> run_test_function (@test_z_z)
 
+## Test repeated files and files that are the output of another entry
+%!function test_overlap (test_dir, z)
+%!  test_file = tempname (test_dir);
+%!  create_file (test_file, rand (100, 1));
+%!  md5 = hash ("md5", fileread (test_file));
+%!
+%!  z_file = [test_file z.ext];
+%!  z_filelist = z.zip ({test_file, test_file});
+%!  assert (is_same_file (z_filelist(:), {z_file; z_file}))
+%!
+%!  ## The same destination, written in two ways, before it exists.
+%!  unlink_or_error (z_file);
+%!  [d, n, e] = fileparts (test_file);
+%!  alt_file = [d filesep() "." filesep() n e];
+%!  z_filelist = z.zip ({test_file, alt_file});
+%!  assert (numel (z_filelist), 2)
+%!  assert (is_same_file (z_filelist(:), {z_file; z_file}))
+%!
+%!  ## The second entry compresses the output of the first.
+%!  z_z_file = [z_file z.ext];
+%!  z_filelist = z.zip ({test_file, z_file});
+%!  assert (is_same_file (sort (z_filelist(:)), sort ({z_file; z_z_file})))
+%!  md5_z = hash ("md5", fileread (z_file));
+%!
+%!  unlink_or_error (z_file);
+%!  uz_filelist = z.unzip (z_z_file);
+%!  assert (is_same_file (uz_filelist, {z_file}))
+%!  assert (hash ("md5", fileread (z_file)), md5_z)
+%!
+%!  unlink_or_error (test_file);
+%!  uz_filelist = z.unzip (z_file);
+%!  assert (is_same_file (uz_filelist, {test_file}))
+%!  assert (hash ("md5", fileread (test_file)), md5)
+%!endfunction
+%!test run_test_function (@test_overlap)
+
 %!function test_xzip_dir (test_dir, z) # bug #43431
 %!  fpaths = fullfile (test_dir, {"test1", "test2", "test3"});
 %!  md5s = cell (1, 3);
@@ -80,9 +80,12 @@ make_fcn_handle (const octave_value& fcn, const std::string& meth_name,
   return retval;
 }
 
+unsigned long cdef_class::cdef_class_rep::s_lookup_epoch = 0;
+
 cdef_class::cdef_class_rep::cdef_class_rep (const std::list<cdef_class>& superclasses)
   : cdef_meta_object_rep (), m_member_count (0), m_handle_class (false),
-    m_meta (false)
+    m_meta (false), m_object_layout (), m_have_object_layout (false),
+    m_lookup_epoch (0)
 {
   put ("SuperClasses", to_ov (superclasses));
   m_implicit_ctor_list = superclasses;
@@ -91,6 +94,16 @@ cdef_class::cdef_class_rep::cdef_class_rep (const std::list<cdef_class>& supercl
 cdef_method
 cdef_class::cdef_class_rep::find_method (const std::string& nm, bool local)
 {
+  if (! local)
+    {
+      validate_lookup_cache ();
+
+      auto p = m_method_cache.find (nm);
+
+      if (p != m_method_cache.end ())
+        return p->second;
+    }
+
   auto it = m_method_map.find (nm);
 
   if (it == m_method_map.end ())
@@ -120,8 +133,13 @@ cdef_class::cdef_class_rep::find_method (const std::string& nm, bool local)
           cdef_method meth = cls.find_method (nm);
 
           if (meth.ok ())
-            return meth;
+            {
+              m_method_cache[nm] = meth;
+              return meth;
+            }
         }
+
+      m_method_cache[nm] = cdef_method ();
     }
 
   return cdef_method ();
@@ -233,6 +251,8 @@ cdef_class::cdef_class_rep::install_method (const cdef_method& meth)
 
   m_member_count++;
 
+  s_lookup_epoch++;
+
   if (meth.is_constructor ())
     {
       // Analyze the constructor code to determine what superclass
@@ -354,6 +374,13 @@ cdef_class::cdef_class_rep::find_methods (std::map<std::string,
 cdef_property
 cdef_class::cdef_class_rep::find_property (const std::string& nm)
 {
+  validate_lookup_cache ();
+
+  auto p = m_property_cache.find (nm);
+
+  if (p != m_property_cache.end ())
+    return p->second;
+
   auto it = m_property_map.find (nm);
 
   if (it != m_property_map.end ())
@@ -375,9 +402,14 @@ cdef_class::cdef_class_rep::find_property (const std::string& nm)
       cdef_property prop = cls.find_property (nm);
 
       if (prop.ok ())
-        return prop;
+        {
+          m_property_cache[nm] = prop;
+          return prop;
+        }
     }
 
+  m_property_cache[nm] = cdef_property ();
+
   return cdef_property ();
 }
 
@@ -387,6 +419,8 @@ cdef_class::cdef_class_rep::install_property (const cdef_property& prop)
   m_property_map[prop.get_name ()] = prop;
 
   m_member_count++;
+
+  s_lookup_epoch++;
 }
 
 Cell
@@ -634,29 +668,59 @@ cdef_class::cdef_class_rep::meta_release ()
 }
 
 void
-cdef_class::cdef_class_rep::initialize_object (cdef_object& obj)
+cdef_class::cdef_class_rep::initialize_object (cdef_object& obj,
+                                               bool init_props)
 {
-  // Populate the object with default property values
+  // Populate the object with default property values.  The first object
+  // of a class is populated one property at a time, and the result is
+  // saved and copied into later objects.  The layout is only saved or
+  // copied if the object is still empty.  That is not the case for the
+  // second and later superclasses of a class with multiple superclasses,
+  // whose properties are added to those of the earlier superclasses.
+
+  validate_lookup_cache ();
+
+  bool save_layout = false;
+
+  if (init_props && obj.property_map ().nfields () == 0)
+    {
+      if (m_have_object_layout)
+        {
+          obj.set_property_map (m_object_layout);
+          init_props = false;
+        }
+      else
+        save_layout = true;
+    }
 
   std::list<cdef_class> super_classes
     = lookup_classes (get ("SuperClasses").cell_value ());
 
   for (auto& cls : super_classes)
-    cls.initialize_object (obj);
+    cls.initialize_object (obj, init_props);
 
-  for (const auto& pname_prop : m_property_map)
+  if (init_props)
     {
-      if (! pname_prop.second.get ("Dependent").bool_value ())
+      for (const auto& pname_prop : m_property_map)
         {
-          octave_value pvalue = pname_prop.second.get ("DefaultValue");
+          if (! pname_prop.second.get ("Dependent").bool_value ())
+            {
+              octave_value pvalue = pname_prop.second.get ("DefaultValue");
 
-          if (pvalue.is_defined ())
-            obj.put (pname_prop.first, pvalue);
-          else
-            obj.put (pname_prop.first, octave_value (Matrix ()));
+              if (pvalue.is_defined ())
+                obj.put (pname_prop.first, pvalue);
+              else
+                obj.put (pname_prop.first, octave_value (Matrix ()));
+            }
         }
     }
 
+  if (save_layout)
+    {
+      m_object_layout = obj.property_map ();
+      m_have_object_layout = true;
+    }
+
   m_count++;
   obj.mark_for_construction (cdef_class (this));
 }
@@ -31,6 +31,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 
 #include "oct-refcount.h"
 
@@ -57,7 +58,8 @@ private:
   public:
     cdef_class_rep ()
       : cdef_meta_object_rep (), m_member_count (0), m_handle_class (false),
-        m_meta (false)
+        m_meta (false), m_object_layout (), m_have_object_layout (false),
+        m_lookup_epoch (0)
     { }
 
     OCTINTERP_API cdef_class_rep (const std::list<cdef_class>& superclasses);
@@ -128,7 +130,8 @@ private:
     OCTINTERP_API cdef_object
     construct_object (const octave_value_list& args);
 
-    OCTINTERP_API void initialize_object (cdef_object& obj);
+    OCTINTERP_API void
+    initialize_object (cdef_object& obj, bool init_props = true);
 
     OCTINTERP_API void
     run_constructor (cdef_object& obj, const octave_value_list& args);
@@ -149,6 +152,8 @@ private:
           m_member_count = 0;
           m_method_map.clear ();
           m_property_map.clear ();
+          clear_lookup_cache ();
+          s_lookup_epoch++;
         }
       else
         delete this;
@@ -182,6 +187,26 @@ private:
       return cdef_class (this);
     }
 
+    // Discard cached lookups if any class has changed since they were
+    // made.
+
+    void validate_lookup_cache ()
+    {
+      if (m_lookup_epoch != s_lookup_epoch)
+        {
+          clear_lookup_cache ();
+          m_lookup_epoch = s_lookup_epoch;
+        }
+    }
+
+    void clear_lookup_cache ()
+    {
+      m_method_cache.clear ();
+      m_property_cache.clear ();
+      m_object_layout = octave_scalar_map ();
+      m_have_object_layout = false;
+    }
+
     // The @-directory were this class is loaded from.
     // (not used yet)
 
@@ -216,6 +241,27 @@ private:
 
     bool m_meta;
 
+    // Results of method and property lookups that include superclasses,
+    // including failed lookups.  They are valid as long as
+    // M_LOOKUP_EPOCH is equal to S_LOOKUP_EPOCH, which changes whenever
+    // a method or property is installed in any class or a class is
+    // destroyed.
+
+    std::unordered_map<std::string, cdef_method> m_method_cache;
+
+    std::unordered_map<std::string, cdef_property> m_property_cache;
+
+    // The default property values of a new object of this class,
+    // including those of superclasses.
+
+    octave_scalar_map m_object_layout;
+
+    bool m_have_object_layout;
+
+    unsigned long m_lookup_epoch;
+
+    static unsigned long s_lookup_epoch;
+
     // Utility iterator typedefs.
 
     typedef std::map<std::string, cdef_method>::iterator method_iterator;
@@ -372,9 +418,9 @@ public:
     return get_rep ()->construct_object (args);
   }
 
-  void initialize_object (cdef_object& obj)
+  void initialize_object (cdef_object& obj, bool init_props = true)
   {
-    get_rep ()->initialize_object (obj);
+    get_rep ()->initialize_object (obj, init_props);
   }
 
   void run_constructor (cdef_object& obj, const octave_value_list& args)
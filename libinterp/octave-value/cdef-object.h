@@ -105,6 +105,16 @@ public:
     err_invalid_object ("get");
   }
 
+  virtual octave_scalar_map property_map () const
+  {
+    err_invalid_object ("property_map");
+  }
+
+  virtual void set_property_map (const octave_scalar_map&)
+  {
+    err_invalid_object ("set_property_map");
+  }
+
   virtual void set_property (octave_idx_type, const std::string&,
                              const octave_value&)
   {
@@ -266,6 +276,16 @@ public:
     return m_rep->get (pname);
   }
 
+  octave_scalar_map property_map () const
+  {
+    return m_rep->property_map ();
+  }
+
+  void set_property_map (const octave_scalar_map& map)
+  {
+    m_rep->set_property_map (map);
+  }
+
   void set_property (octave_idx_type idx, const std::string& pname,
                      const octave_value& pval)
   {
@@ -469,14 +489,20 @@ public:
 
   octave_value get (const std::string& pname) const
   {
-    Cell val = m_map.contents (pname);
+    octave_scalar_map::const_iterator p = m_map.seek (pname);
 
-    if (val.numel () < 1)
+    if (p == m_map.end ())
       error ("get: unknown slot: %s", pname.c_str ());
 
-    return val(0, 0);
+    return m_map.contents (p);
   }
 
+  octave_scalar_map property_map () const { return m_map; }
+
+  // Objects of the same class start from a copy of the same map, so
+  // they share a single table of property names.
+  void set_property_map (const octave_scalar_map& map) { m_map = map; }
+
   void set_property (octave_idx_type idx, const std::string& pname,
                      const octave_value& pval)
   {
@@ -235,9 +235,15 @@ cdef_property::cdef_property_rep::set_value (cdef_object& obj,
 bool
 cdef_property::cdef_property_rep::check_get_access () const
 {
+  octave_value acc = get ("GetAccess");
+
+  // Public access does not depend on the context.
+  if (acc.is_string () && acc.string_value () == "public")
+    return true;
+
   cdef_class cls (to_cdef (get ("DefiningClass")));
 
-  return check_access (cls, get ("GetAccess"), "", get_name (), false);
+  return check_access (cls, acc, "", get_name (), false);
 
   return false;
 }
@@ -245,9 +251,14 @@ cdef_property::cdef_property_rep::check_get_access () const
 bool
 cdef_property::cdef_property_rep::check_set_access () const
 {
+  octave_value acc = get ("SetAccess");
+
+  if (acc.is_string () && acc.string_value () == "public")
+    return true;
+
   cdef_class cls (to_cdef (get ("DefiningClass")));
 
-  return check_access (cls, get ("SetAccess"), "", get_name (), true);
+  return check_access (cls, acc, "", get_name (), true);
 
   return false;
 }
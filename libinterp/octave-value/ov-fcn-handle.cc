@@ -629,12 +629,13 @@ public:
   // load_binary functions.
 
   base_anonymous_fcn_handle (const std::string& name = "")
-    : base_fcn_handle (name)
+    : base_fcn_handle (name), m_bound_fcn (nullptr)
   { }
 
   base_anonymous_fcn_handle (const octave_value& fcn,
                              const stack_frame::local_vars_map& local_vars)
-    : base_fcn_handle (anonymous), m_fcn (fcn), m_local_vars (local_vars)
+    : base_fcn_handle (anonymous), m_fcn (fcn), m_local_vars (local_vars),
+      m_bound_fcn (nullptr)
   { }
 
   base_anonymous_fcn_handle (const base_anonymous_fcn_handle&) = default;
@@ -688,11 +689,21 @@ public:
 
 protected:
 
+  const stack_frame::local_vars_list&
+  bound_local_vars (octave_user_function *fcn);
+
   // The function we are handling.
   octave_value m_fcn;
 
   // List of captured variable values for anonymous fucntions.
   stack_frame::local_vars_map m_local_vars;
+
+  // The captured variable values paired with the symbols of the scope
+  // of M_BOUND_FCN.  Created on the first call so that later calls do
+  // not need to look up the variables by name.
+  stack_frame::local_vars_list m_bound_vars;
+
+  octave_user_function *m_bound_fcn;
 };
 
 class anonymous_fcn_handle : public base_anonymous_fcn_handle
@@ -2118,6 +2129,28 @@ is_equal_to (const class_simple_fcn_handle& fh1,
 
 const std::string base_anonymous_fcn_handle::anonymous ("@<anonymous>");
 
+const stack_frame::local_vars_list&
+base_anonymous_fcn_handle::bound_local_vars (octave_user_function *fcn)
+{
+  if (fcn != m_bound_fcn || m_bound_vars.size () != m_local_vars.size ())
+    {
+      symbol_scope fcn_scope = fcn->scope ();
+
+      stack_frame::local_vars_list bound_vars;
+
+      bound_vars.reserve (m_local_vars.size ());
+
+      for (const auto& nm_val : m_local_vars)
+        bound_vars.emplace_back (fcn_scope.find_symbol (nm_val.first),
+                                 nm_val.second);
+
+      m_bound_vars = bound_vars;
+      m_bound_fcn = fcn;
+    }
+
+  return m_bound_vars;
+}
+
 octave_scalar_map
 base_anonymous_fcn_handle::info ()
 {
@@ -2781,7 +2814,8 @@ anonymous_fcn_handle::call (int nargout, const octave_value_list& args)
 
   octave_user_function *oct_usr_fcn = m_fcn.user_function_value ();
 
-  tw.push_stack_frame (oct_usr_fcn, m_local_vars, m_stack_context);
+  tw.push_stack_frame (oct_usr_fcn, bound_local_vars (oct_usr_fcn),
+                       m_stack_context);
 
   unwind_action act ([&tw] () { tw.pop_stack_frame (); });
 
@@ -2837,7 +2871,7 @@ weak_anonymous_fcn_handle::call (int nargout, const octave_value_list& args)
 
   std::shared_ptr<stack_frame> frames = m_stack_context.lock ();
 
-  tw.push_stack_frame (oct_usr_fcn, m_local_vars, frames);
+  tw.push_stack_frame (oct_usr_fcn, bound_local_vars (oct_usr_fcn), frames);
 
   unwind_action act ([&tw] () { tw.pop_stack_frame (); });
 
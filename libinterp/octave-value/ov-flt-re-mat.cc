@@ -27,6 +27,7 @@
 #  include "config.h"
 #endif
 
+#include <atomic>
 #include <clocale>
 #include <istream>
 #include <limits>
@@ -53,6 +54,7 @@
 #include "mx-base.h"
 #include "quit.h"
 #include "oct-locbuf.h"
+#include "oct-parallel.h"
 
 #include "defun.h"
 #include "errwarn.h"
@@ -783,6 +785,80 @@ do_rc_map (const FloatNDArray& a, FloatComplex (&fcn) (float))
   return rr;
 }
 
+// Versions of the above for mapper functions that are pure functions of
+// their argument, so that large arrays may be split among threads.  The
+// complex->real mappers first compute the real result and only compute
+// a complex result in a second pass if needed.
+
+static const octave_idx_type par_map_grain = 4096;
+
+static octave_value
+do_par_map (const FloatNDArray& a, float (&fcn) (float))
+{
+  FloatNDArray retval (a.dims ());
+
+  const float *src = a.data ();
+  float *dest = retval.rwdata ();
+
+  auto body = [=] (octave_idx_type lo, octave_idx_type hi)
+  {
+    for (octave_idx_type i = lo; i < hi; i++)
+      dest[i] = fcn (src[i]);
+  };
+
+  octave::parallel_for (a.numel (), par_map_grain, body);
+
+  return retval;
+}
+
+static octave_value
+do_par_rc_map (const FloatNDArray& a, FloatComplex (&fcn) (float))
+{
+  octave_idx_type n = a.numel ();
+  FloatNDArray rr (a.dims ());
+
+  const float *src = a.data ();
+  float *pr = rr.rwdata ();
+
+  std::atomic<bool> is_complex (false);
+
+  auto real_body = [=, &is_complex] (octave_idx_type lo, octave_idx_type hi)
+  {
+    if (is_complex.load (std::memory_order_relaxed))
+      return;
+
+    for (octave_idx_type i = lo; i < hi; i++)
+      {
+        FloatComplex tmp = fcn (src[i]);
+        if (tmp.imag () != 0)
+          {
+            is_complex.store (true, std::memory_order_relaxed);
+            return;
+          }
+        pr[i] = tmp.real ();
+      }
+  };
+
+  octave::parallel_for (n, par_map_grain, real_body);
+
+  if (! is_complex)
+    return rr;
+
+  FloatComplexNDArray rc (a.dims ());
+
+  FloatComplex *pc = rc.rwdata ();
+
+  auto complex_body = [=] (octave_idx_type lo, octave_idx_type hi)
+  {
+    for (octave_idx_type i = lo; i < hi; i++)
+      pc[i] = fcn (src[i]);
+  };
+
+  octave::parallel_for (n, par_map_grain, complex_body);
+
+  return new octave_float_complex_matrix (rc);
+}
+
 octave_value
 octave_float_matrix::map (unary_mapper_t umap) const
 {
@@ -813,43 +889,51 @@ octave_float_matrix::map (unary_mapper_t umap) const
     case umap_ ## UMAP:                       \
       return do_rc_map (m_matrix, FCN)
 
-      RC_ARRAY_MAPPER (acos, FloatComplex, octave::math::rc_acos);
-      RC_ARRAY_MAPPER (acosh, FloatComplex, octave::math::rc_acosh);
+#define PAR_ARRAY_MAPPER(UMAP, TYPE, FCN)     \
+    case umap_ ## UMAP:                       \
+      return do_par_map (m_matrix, FCN)
+
+#define PAR_RC_ARRAY_MAPPER(UMAP, TYPE, FCN)  \
+    case umap_ ## UMAP:                       \
+      return do_par_rc_map (m_matrix, FCN)
+
+      PAR_RC_ARRAY_MAPPER (acos, FloatComplex, octave::math::rc_acos);
+      PAR_RC_ARRAY_MAPPER (acosh, FloatComplex, octave::math::rc_acosh);
       ARRAY_MAPPER (angle, float, std::arg);
       ARRAY_MAPPER (arg, float, std::arg);
-      RC_ARRAY_MAPPER (asin, FloatComplex, octave::math::rc_asin);
-      ARRAY_MAPPER (asinh, float, octave::math::asinh);
-      ARRAY_MAPPER (atan, float, ::atanf);
-      RC_ARRAY_MAPPER (atanh, FloatComplex, octave::math::rc_atanh);
-      ARRAY_MAPPER (erf, float, octave::math::erf);
-      ARRAY_MAPPER (erfinv, float, octave::math::erfinv);
-      ARRAY_MAPPER (erfcinv, float, octave::math::erfcinv);
-      ARRAY_MAPPER (erfc, float, octave::math::erfc);
-      ARRAY_MAPPER (erfcx, float, octave::math::erfcx);
-      ARRAY_MAPPER (erfi, float, octave::math::erfi);
-      ARRAY_MAPPER (dawson, float, octave::math::dawson);
-      ARRAY_MAPPER (gamma, float, octave::math::gamma);
+      PAR_RC_ARRAY_MAPPER (asin, FloatComplex, octave::math::rc_asin);
+      PAR_ARRAY_MAPPER (asinh, float, octave::math::asinh);
+      PAR_ARRAY_MAPPER (atan, float, ::atanf);
+      PAR_RC_ARRAY_MAPPER (atanh, FloatComplex, octave::math::rc_atanh);
+      PAR_ARRAY_MAPPER (erf, float, octave::math::erf);
+      PAR_ARRAY_MAPPER (erfinv, float, octave::math::erfinv);
+      PAR_ARRAY_MAPPER (erfcinv, float, octave::math::erfcinv);
+      PAR_ARRAY_MAPPER (erfc, float, octave::math::erfc);
+      PAR_ARRAY_MAPPER (erfcx, float, octave::math::erfcx);
+      PAR_ARRAY_MAPPER (erfi, float, octave::math::erfi);
+      PAR_ARRAY_MAPPER (dawson, float, octave::math::dawson);
+      PAR_ARRAY_MAPPER (gamma, float, octave::math::gamma);
       RC_ARRAY_MAPPER (lgamma, FloatComplex, octave::math::rc_lgamma);
-      ARRAY_MAPPER (cbrt, float, octave::math::cbrt);
+      PAR_ARRAY_MAPPER (cbrt, float, octave::math::cbrt);
       ARRAY_MAPPER (ceil, float, ::ceilf);
-      ARRAY_MAPPER (cos, float, ::cosf);
-      ARRAY_MAPPER (cosh, float, ::coshf);
-      ARRAY_MAPPER (exp, float, ::expf);
-      ARRAY_MAPPER (expm1, float, octave::math::expm1);
+      PAR_ARRAY_MAPPER (cos, float, ::cosf);
+      PAR_ARRAY_MAPPER (cosh, float, ::coshf);
+      PAR_ARRAY_MAPPER (exp, float, ::expf);
+      PAR_ARRAY_MAPPER (expm1, float, octave::math::expm1);
       ARRAY_MAPPER (fix, float, octave::math::fix);
       ARRAY_MAPPER (floor, float, ::floorf);
-      RC_ARRAY_MAPPER (log, FloatComplex, octave::math::rc_log);
-      RC_ARRAY_MAPPER (log2, FloatComplex, octave::math::rc_log2);
-      RC_ARRAY_MAPPER (log10, FloatComplex, octave::math::rc_log10);
-      RC_ARRAY_MAPPER (log1p, FloatComplex, octave::math::rc_log1p);
+      PAR_RC_ARRAY_MAPPER (log, FloatComplex, octave::math::rc_log);
+      PAR_RC_ARRAY_MAPPER (log2, FloatComplex, octave::math::rc_log2);
+      PAR_RC_ARRAY_MAPPER (log10, FloatComplex, octave::math::rc_log10);
+      PAR_RC_ARRAY_MAPPER (log1p, FloatComplex, octave::math::rc_log1p);
       ARRAY_MAPPER (round, float, octave::math::round);
       ARRAY_MAPPER (roundb, float, octave::math::roundb);
       ARRAY_MAPPER (signum, float, octave::math::signum);
-      ARRAY_MAPPER (sin, float, ::sinf);
-      ARRAY_MAPPER (sinh, float, ::sinhf);
-      RC_ARRAY_MAPPER (sqrt, FloatComplex, octave::math::rc_sqrt);
-      ARRAY_MAPPER (tan, float, ::tanf);
-      ARRAY_MAPPER (tanh, float, ::tanhf);
+      PAR_ARRAY_MAPPER (sin, float, ::sinf);
+      PAR_ARRAY_MAPPER (sinh, float, ::sinhf);
+      PAR_RC_ARRAY_MAPPER (sqrt, FloatComplex, octave::math::rc_sqrt);
+      PAR_ARRAY_MAPPER (tan, float, ::tanf);
+      PAR_ARRAY_MAPPER (tanh, float, ::tanhf);
       ARRAY_MAPPER (isna, bool, octave::math::isna);
       ARRAY_MAPPER (xsignbit, float, octave::math::signbit);
 
@@ -879,3 +963,6 @@ octave_float_matrix::map (unary_mapper_t umap) const
       return octave_base_value::map (umap);
     }
 }
+
+#undef PAR_ARRAY_MAPPER
+#undef PAR_RC_ARRAY_MAPPER
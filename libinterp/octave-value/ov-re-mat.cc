@@ -27,6 +27,7 @@
 #  include "config.h"
 #endif
 
+#include <atomic>
 #include <clocale>
 #include <istream>
 #include <limits>
@@ -53,6 +54,7 @@
 #include "mx-base.h"
 #include "quit.h"
 #include "oct-locbuf.h"
+#include "oct-parallel.h"
 
 #include "defun.h"
 #include "errwarn.h"
@@ -910,6 +912,80 @@ do_rc_map (const NDArray& a, Complex (&fcn) (double))
   return rr;
 }
 
+// Versions of the above for mapper functions that are pure functions of
+// their argument, so that large arrays may be split among threads.  The
+// complex->real mappers first compute the real result and only compute
+// a complex result in a second pass if needed.
+
+static const octave_idx_type par_map_grain = 4096;
+
+static octave_value
+do_par_map (const NDArray& a, double (&fcn) (double))
+{
+  NDArray retval (a.dims ());
+
+  const double *src = a.data ();
+  double *dest = retval.rwdata ();
+
+  auto body = [=] (octave_idx_type lo, octave_idx_type hi)
+  {
+    for (octave_idx_type i = lo; i < hi; i++)
+      dest[i] = fcn (src[i]);
+  };
+
+  octave::parallel_for (a.numel (), par_map_grain, body);
+
+  return retval;
+}
+
+static octave_value
+do_par_rc_map (const NDArray& a, Complex (&fcn) (double))
+{
+  octave_idx_type n = a.numel ();
+  NDArray rr (a.dims ());
+
+  const double *src = a.data ();
+  double *pr = rr.rwdata ();
+
+  std::atomic<bool> is_complex (false);
+
+  auto real_body = [=, &is_complex] (octave_idx_type lo, octave_idx_type hi)
+  {
+    if (is_complex.load (std::memory_order_relaxed))
+      return;
+
+    for (octave_idx_type i = lo; i < hi; i++)
+      {
+        Complex tmp = fcn (src[i]);
+        if (tmp.imag () != 0)
+          {
+            is_complex.store (true, std::memory_order_relaxed);
+            return;
+          }
+        pr[i] = tmp.real ();
+      }
+  };
+
+  octave::parallel_for (n, par_map_grain, real_body);
+
+  if (! is_complex)
+    return rr;
+
+  ComplexNDArray rc (a.dims ());
+
+  Complex *pc = rc.rwdata ();
+
+  auto complex_body = [=] (octave_idx_type lo, octave_idx_type hi)
+  {
+    for (octave_idx_type i = lo; i < hi; i++)
+      pc[i] = fcn (src[i]);
+  };
+
+  octave::parallel_for (n, par_map_grain, complex_body);
+
+  return new octave_complex_matrix (rc);
+}
+
 octave_value
 octave_matrix::map (unary_mapper_t umap) const
 {
@@ -940,43 +1016,51 @@ octave_matrix::map (unary_mapper_t umap) const
     case umap_ ## UMAP:                       \
       return do_rc_map (m_matrix, FCN)
 
-      RC_ARRAY_MAPPER (acos, Complex, octave::math::rc_acos);
-      RC_ARRAY_MAPPER (acosh, Complex, octave::math::rc_acosh);
+#define PAR_ARRAY_MAPPER(UMAP, TYPE, FCN)     \
+    case umap_ ## UMAP:                       \
+      return do_par_map (m_matrix, FCN)
+
+#define PAR_RC_ARRAY_MAPPER(UMAP, TYPE, FCN)  \
+    case umap_ ## UMAP:                       \
+      return do_par_rc_map (m_matrix, FCN)
+
+      PAR_RC_ARRAY_MAPPER (acos, Complex, octave::math::rc_acos);
+      PAR_RC_ARRAY_MAPPER (acosh, Complex, octave::math::rc_acosh);
       ARRAY_MAPPER (angle, double, std::arg);
       ARRAY_MAPPER (arg, double, std::arg);
-      RC_ARRAY_MAPPER (asin, Complex, octave::math::rc_asin);
-      ARRAY_MAPPER (asinh, double, octave::math::asinh);
-      ARRAY_MAPPER (atan, double, ::atan);
-      RC_ARRAY_MAPPER (atanh, Complex, octave::math::rc_atanh);
-      ARRAY_MAPPER (erf, double, octave::math::erf);
-      ARRAY_MAPPER (erfinv, double, octave::math::erfinv);
-      ARRAY_MAPPER (erfcinv, double, octave::math::erfcinv);
-      ARRAY_MAPPER (erfc, double, octave::math::erfc);
-      ARRAY_MAPPER (erfcx, double, octave::math::erfcx);
-      ARRAY_MAPPER (erfi, double, octave::math::erfi);
-      ARRAY_MAPPER (dawson, double, octave::math::dawson);
-      ARRAY_MAPPER (gamma, double, octave::math::gamma);
+      PAR_RC_ARRAY_MAPPER (asin, Complex, octave::math::rc_asin);
+      PAR_ARRAY_MAPPER (asinh, double, octave::math::asinh);
+      PAR_ARRAY_MAPPER (atan, double, ::atan);
+      PAR_RC_ARRAY_MAPPER (atanh, Complex, octave::math::rc_atanh);
+      PAR_ARRAY_MAPPER (erf, double, octave::math::erf);
+      PAR_ARRAY_MAPPER (erfinv, double, octave::math::erfinv);
+      PAR_ARRAY_MAPPER (erfcinv, double, octave::math::erfcinv);
+      PAR_ARRAY_MAPPER (erfc, double, octave::math::erfc);
+      PAR_ARRAY_MAPPER (erfcx, double, octave::math::erfcx);
+      PAR_ARRAY_MAPPER (erfi, double, octave::math::erfi);
+      PAR_ARRAY_MAPPER (dawson, double, octave::math::dawson);
+      PAR_ARRAY_MAPPER (gamma, double, octave::math::gamma);
       RC_ARRAY_MAPPER (lgamma, Complex, octave::math::rc_lgamma);
-      ARRAY_MAPPER (cbrt, double, octave::math::cbrt);
+      PAR_ARRAY_MAPPER (cbrt, double, octave::math::cbrt);
       ARRAY_MAPPER (ceil, double, ::ceil);
-      ARRAY_MAPPER (cos, double, ::cos);
-      ARRAY_MAPPER (cosh, double, ::cosh);
-      ARRAY_MAPPER (exp, double, ::exp);
-      ARRAY_MAPPER (expm1, double, octave::math::expm1);
+      PAR_ARRAY_MAPPER (cos, double, ::cos);
+      PAR_ARRAY_MAPPER (cosh, double, ::cosh);
+      PAR_ARRAY_MAPPER (exp, double, ::exp);
+      PAR_ARRAY_MAPPER (expm1, double, octave::math::expm1);
       ARRAY_MAPPER (fix, double, octave::math::fix);
       ARRAY_MAPPER (floor, double, ::floor);
-      RC_ARRAY_MAPPER (log, Complex, octave::math::rc_log);
-      RC_ARRAY_MAPPER (log2, Complex, octave::math::rc_log2);
-      RC_ARRAY_MAPPER (log10, Complex, octave::math::rc_log10);
-      RC_ARRAY_MAPPER (log1p, Complex, octave::math::rc_log1p);
+      PAR_RC_ARRAY_MAPPER (log, Complex, octave::math::rc_log);
+      PAR_RC_ARRAY_MAPPER (log2, Complex, octave::math::rc_log2);
+      PAR_RC_ARRAY_MAPPER (log10, Complex, octave::math::rc_log10);
+      PAR_RC_ARRAY_MAPPER (log1p, Complex, octave::math::rc_log1p);
       ARRAY_MAPPER (round, double, octave::math::round);
       ARRAY_MAPPER (roundb, double, octave::math::roundb);
       ARRAY_MAPPER (signum, double, octave::math::signum);
-      ARRAY_MAPPER (sin, double, ::sin);
-      ARRAY_MAPPER (sinh, double, ::sinh);
-      RC_ARRAY_MAPPER (sqrt, Complex, octave::math::rc_sqrt);
-      ARRAY_MAPPER (tan, double, ::tan);
-      ARRAY_MAPPER (tanh, double, ::tanh);
+      PAR_ARRAY_MAPPER (sin, double, ::sin);
+      PAR_ARRAY_MAPPER (sinh, double, ::sinh);
+      PAR_RC_ARRAY_MAPPER (sqrt, Complex, octave::math::rc_sqrt);
+      PAR_ARRAY_MAPPER (tan, double, ::tan);
+      PAR_ARRAY_MAPPER (tanh, double, ::tanh);
       ARRAY_MAPPER (isna, bool, octave::math::isna);
       ARRAY_MAPPER (xsignbit, double, octave::math::signbit);
 
@@ -1006,3 +1090,6 @@ octave_matrix::map (unary_mapper_t umap) const
       return octave_base_value::map (umap);
     }
 }
+
+#undef PAR_ARRAY_MAPPER
+#undef PAR_RC_ARRAY_MAPPER
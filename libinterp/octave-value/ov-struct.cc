@@ -2057,6 +2057,53 @@ Return the number of fields of the structure @var{s}.
 %!assert (isfield (struct ("a", 1, "b", 2), {"a", "c"}), [true, false])
 */
 
+DEFUN (__getfields__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{vals}, @var{tf}] =} __getfields__ (@var{s}, @var{names})
+Return the values of the fields @var{names} of the scalar structure @var{s}.
+
+@var{names} is a cell array of strings.  @var{vals} is a cell array of the
+same size.  @var{tf} is a logical array which is false where @var{s} has no
+field of that name.  The corresponding elements of @var{vals} are empty.
+@end deftypefn */)
+{
+  if (args.length () != 2)
+    print_usage ();
+
+  octave_scalar_map m
+    = args(0).xscalar_map_value ("__getfields__: S must be a scalar struct");
+
+  Array<std::string> names
+    = args(1).xcellstr_value ("__getfields__: NAMES must be a cell array of strings");
+
+  octave_idx_type n = names.numel ();
+
+  Cell vals (names.dims ());
+  boolNDArray tf (names.dims ());
+
+  for (octave_idx_type i = 0; i < n; i++)
+    {
+      octave_value val = m.getfield (names(i));
+
+      tf(i) = val.is_defined ();
+      if (tf(i))
+        vals(i) = val;
+    }
+
+  return ovl (vals, tf);
+}
+
+/*
+%!test
+%! s = struct ("a", 1, "b", "x");
+%! [v, tf] = __getfields__ (s, {"b"; "c"; "a"});
+%! assert (v, {"x"; []; 1});
+%! assert (tf, [true; false; true]);
+
+%!error <S must be a scalar struct> __getfields__ (struct ("a", {1, 2}), {"a"})
+%!error <NAMES must be a cell array> __getfields__ (struct ("a", 1), "a")
+*/
+
 OCTAVE_NORETURN
 static void
 invalid_cell2struct_fields_error ()
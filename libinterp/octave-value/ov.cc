@@ -1560,11 +1560,12 @@ octave_value::assign (assign_op op, const std::string& type,
       if (! is_defined ())
         error ("in computed assignment A(index) OP= X, A must be defined first");
 
-      octave_value t = subsref (type, idx);
-
       binary_op binop = op_eq_to_binary_op (op);
 
-      t_rhs = octave::binary_op (binop, t, rhs);
+      // The indexed value may share data with this object, so it must
+      // be released before the assignment to avoid a copy.
+
+      t_rhs = octave::binary_op (binop, subsref (type, idx), rhs);
     }
 
   *this = subsasgn (type, idx, t_rhs);
@@ -4015,4 +4016,61 @@ setting is restored when exiting the function.
 %!assert (typeinfo (__test_dr__ (false)), "matrix")
 */
 
+DEFUN (__array_copy_count__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{n} =} __array_copy_count__ ()
+Return the number of times that shared array data has been copied because
+it was about to be modified.
+
+This is a diagnostic for checking that operations such as @code{A += B} on
+arrays that are not shared are done in place.
+@end deftypefn */)
+{
+  if (args.length () != 0)
+    print_usage ();
+
+  return ovl (static_cast<double> (array_copy_count ()));
+}
+
+/*
+%!test
+%! A = rand (100);
+%! B = rand (100);
+%! n = __array_copy_count__ ();
+%! A += B;
+%! A -= 2;
+%! A .*= B;
+%! A = A .* 3;
+%! A = A ./ B;
+%! A(1:50) += 1;
+%! A(:,2) = A(:,2) + 1;
+%! assert (__array_copy_count__ () - n, 0);
+
+%!test
+%! A = rand (100);
+%! B = A;
+%! n = __array_copy_count__ ();
+%! A += 1;
+%! assert (__array_copy_count__ () - n, 0);
+%! A(1) = 1;
+%! A(2) = 2;
+%! C = A;
+%! A(3) = 3;
+%! assert (__array_copy_count__ () - n, 1);
+%! assert (C(3), B(3) + 1);
+
+%!test
+%! x = [1, 2, 3];
+%! y = x;
+%! x = x .* 2;
+%! assert (x, [2, 4, 6]);
+%! assert (y, [1, 2, 3]);
+%! x = x - [1, 1, 1];
+%! assert (x, [1, 3, 5]);
+%! x = x / 2;
+%! assert (x, [0.5, 1.5, 2.5]);
+
+%!error __array_copy_count__ (1)
+*/
+
 OCTAVE_END_NAMESPACE(octave)
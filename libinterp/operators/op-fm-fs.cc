@@ -123,6 +123,8 @@ DEFNDASSIGNOP_OP (assign_add, float_matrix, float_scalar, float_scalar, +=)
 DEFNDASSIGNOP_OP (assign_sub, float_matrix, float_scalar, float_scalar, -=)
 DEFNDASSIGNOP_OP (assign_mul, float_matrix, float_scalar, float_scalar, *=)
 DEFNDASSIGNOP_OP (assign_div, float_matrix, float_scalar, float_scalar, /=)
+DEFNDASSIGNOP_OP (assign_el_mul, float_matrix, float_scalar, float_scalar, *=)
+DEFNDASSIGNOP_OP (assign_el_div, float_matrix, float_scalar, float_scalar, /=)
 
 void
 install_fm_fs_ops (octave::type_info& ti)
@@ -169,6 +171,10 @@ install_fm_fs_ops (octave::type_info& ti)
                        assign_mul);
   INSTALL_ASSIGNOP_TI (ti, op_div_eq, octave_float_matrix, octave_float_scalar,
                        assign_div);
+  INSTALL_ASSIGNOP_TI (ti, op_el_mul_eq, octave_float_matrix,
+                       octave_float_scalar, assign_el_mul);
+  INSTALL_ASSIGNOP_TI (ti, op_el_div_eq, octave_float_matrix,
+                       octave_float_scalar, assign_el_div);
 }
 
 OCTAVE_END_NAMESPACE(octave)
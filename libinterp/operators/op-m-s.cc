@@ -112,6 +112,8 @@ DEFNDASSIGNOP_OP (assign_add, matrix, scalar, scalar, +=)
 DEFNDASSIGNOP_OP (assign_sub, matrix, scalar, scalar, -=)
 DEFNDASSIGNOP_OP (assign_mul, matrix, scalar, scalar, *=)
 DEFNDASSIGNOP_OP (assign_div, matrix, scalar, scalar, /=)
+DEFNDASSIGNOP_OP (assign_el_mul, matrix, scalar, scalar, *=)
+DEFNDASSIGNOP_OP (assign_el_div, matrix, scalar, scalar, /=)
 
 void
 install_m_s_ops (octave::type_info& ti)
@@ -148,6 +150,10 @@ install_m_s_ops (octave::type_info& ti)
   INSTALL_ASSIGNOP_TI (ti, op_sub_eq, octave_matrix, octave_scalar, assign_sub);
   INSTALL_ASSIGNOP_TI (ti, op_mul_eq, octave_matrix, octave_scalar, assign_mul);
   INSTALL_ASSIGNOP_TI (ti, op_div_eq, octave_matrix, octave_scalar, assign_div);
+  INSTALL_ASSIGNOP_TI (ti, op_el_mul_eq, octave_matrix, octave_scalar,
+                       assign_el_mul);
+  INSTALL_ASSIGNOP_TI (ti, op_el_div_eq, octave_matrix, octave_scalar,
+                       assign_el_div);
 }
 
 OCTAVE_END_NAMESPACE(octave)
@@ -35,6 +35,9 @@
 #include "ov.h"
 #include "pt-arg-list.h"
 #include "pt-assign.h"
+#include "pt-binop.h"
+#include "pt-cbinop.h"
+#include "pt-eval.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
@@ -98,7 +101,17 @@ tree_simple_assignment::evaluate (tree_evaluator& tw, int)
           if (ult.numel () != 1)
             err_invalid_structure_assignment ();
 
-          octave_value rhs_val = m_rhs->evaluate (tw);
+          // Evaluate X = X OP Y as X OP= Y so that the operation may be
+          // done in place.
+
+          octave_value::assign_op etype = m_etype;
+
+          tree_expression *rhs_expr = in_place_operand (tw, etype);
+
+          if (! rhs_expr)
+            rhs_expr = m_rhs;
+
+          octave_value rhs_val = rhs_expr->evaluate (tw);
 
           if (rhs_val.is_undefined ())
             error ("value on right hand side of assignment is undefined");
@@ -113,9 +126,9 @@ tree_simple_assignment::evaluate (tree_evaluator& tw, int)
               rhs_val = lst(0);
             }
 
-          ult.assign (m_etype, rhs_val);
+          ult.assign (etype, rhs_val);
 
-          if (m_etype == octave_value::op_asn_eq)
+          if (etype == octave_value::op_asn_eq)
             val = rhs_val;
           else
             val = ult.value ();
@@ -151,6 +164,54 @@ tree_simple_assignment::evaluate (tree_evaluator& tw, int)
   return val;
 }
 
+tree_expression *
+tree_simple_assignment::in_place_operand (tree_evaluator& tw,
+                                          octave_value::assign_op& op) const
+{
+  if (op != octave_value::op_asn_eq || ! m_lhs->is_identifier ()
+      || ! m_rhs->is_binary_expression () || m_rhs->is_boolean_expression ())
+    return nullptr;
+
+  tree_binary_expression *be = dynamic_cast<tree_binary_expression *> (m_rhs);
+
+  if (! be || be->is_braindead ()
+      || dynamic_cast<tree_compound_binary_expression *> (be))
+    return nullptr;
+
+  octave_value::assign_op asn_op;
+
+  switch (be->op_type ())
+    {
+    case octave_value::op_add:
+    case octave_value::op_sub:
+    case octave_value::op_mul:
+    case octave_value::op_div:
+    case octave_value::op_el_mul:
+    case octave_value::op_el_div:
+      asn_op = octave_value::binary_op_to_assign_op (be->op_type ());
+      break;
+
+    default:
+      return nullptr;
+    }
+
+  tree_expression *x = be->lhs ();
+  tree_expression *y = be->rhs ();
+
+  // Y is evaluated before X is used, so neither may have side effects.
+
+  if (! x || ! x->is_identifier () || x->name () != m_lhs->name ()
+      || ! tw.is_variable (x))
+    return nullptr;
+
+  if (! y || ! (y->is_constant () || tw.is_variable (y)))
+    return nullptr;
+
+  op = asn_op;
+
+  return y;
+}
+
 // Multi-valued assignment expressions.
 
 tree_multi_assignment::tree_multi_assignment (tree_argument_list *lst,
@@ -97,6 +97,11 @@ private:
 
   void do_assign (octave_lvalue& ult, const octave_value& rhs_val);
 
+  // If this expression is X = X OP Y for a variable X, set OP to the
+  // corresponding computed assignment operator and return Y.
+  tree_expression * in_place_operand (tree_evaluator& tw,
+                                      octave_value::assign_op& op) const;
+
   // The left hand side of the assignment.
   tree_expression *m_lhs;
 
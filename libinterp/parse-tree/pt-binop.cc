@@ -27,12 +27,23 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "oct-parallel.h"
+
 #include "error.h"
 #include "interpreter.h"
 #include "ov.h"
+#include "ov-re-mat.h"
 #include "profiler.h"
 #include "pt-binop.h"
+#include "pt-cbinop.h"
+#include "pt-const.h"
 #include "pt-eval.h"
+#include "pt-id.h"
+#include "pt-unop.h"
 #include "variables.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
@@ -66,9 +77,460 @@ tree_binary_expression::dup (symbol_scope& scope) const
   return new_be;
 }
 
+// Single pass evaluation of trees of elementwise operations.
+//
+// An expression like a.*x + b.*x - c would normally create three
+// temporary arrays and make four passes over memory.  If all operands
+// are variables or constants, the tree is compiled once to a small
+// postfix program.  When all operand values are full real double arrays
+// of the same size or double scalars, the program is run over short
+// blocks of elements that stay in cache, writing directly to the result.
+// Otherwise, the expression is evaluated as usual.  Because operands
+// are only variables and constants, evaluating them first has no side
+// effects and the result is the same as with the usual evaluation.
+
+class fused_elementwise_kernel
+{
+public:
+
+  // Return a kernel for the tree rooted at EXPR, or nullptr if the
+  // tree is not made of at least two elementwise operations on
+  // variables and constants.
+
+  static fused_elementwise_kernel * create (tree_binary_expression& expr);
+
+  OCTAVE_DISABLE_COPY_MOVE (fused_elementwise_kernel)
+
+  ~fused_elementwise_kernel () = default;
+
+  // Return false without evaluating anything if the operand values are
+  // not suitable for fused evaluation.
+
+  bool evaluate (tree_evaluator& tw, tree_binary_expression& expr,
+                 octave_value& retval) const;
+
+private:
+
+  fused_elementwise_kernel ()
+    : m_code (), m_leaves (), m_operands ()
+  { }
+
+  enum opcode { op_push, op_neg, op_add, op_sub, op_mul, op_div };
+
+  struct instruction
+  {
+    opcode op;
+
+    // Leaf index for op_push.  For op_mul and op_div, true if the
+    // operator is matrix multiplication or right division, which are
+    // only elementwise if the rhs (or for op_mul, either) is a scalar.
+    int arg;
+  };
+
+  // Array operands point to their data.  Scalar operands have a null
+  // data pointer.
+
+  struct operand
+  {
+    const double *data;
+    double scalar;
+  };
+
+  // Limits on the size of the operand stack, the number of operands, and
+  // the number of elements done per pass through the program.
+
+  static const int max_depth = 8;
+  static const std::size_t max_leaves = 32;
+  static const octave_idx_type block_len = 256;
+
+  bool compile (tree_expression *expr, int depth);
+
+  void run (const operand *leaves, octave_idx_type len, double *buf,
+            double *dest) const;
+
+  std::vector<instruction> m_code;
+
+  std::vector<tree_expression *> m_leaves;
+
+  // Binary expressions in the tree.
+  std::vector<tree_binary_expression *> m_operands;
+};
+
+fused_elementwise_kernel *
+fused_elementwise_kernel::create (tree_binary_expression& expr)
+{
+  fused_elementwise_kernel *kernel = new fused_elementwise_kernel ();
+
+  // Need at least two operators to save a temporary.
+  if (! kernel->compile (&expr, 0) || kernel->m_code.size () < 4)
+    {
+      delete kernel;
+      return nullptr;
+    }
+
+  // The root of the tree is last.
+  kernel->m_operands.pop_back ();
+
+  for (auto *be : kernel->m_operands)
+    be->m_fusion = tree_binary_expression::fusion_operand;
+
+  return kernel;
+}
+
+bool
+fused_elementwise_kernel::compile (tree_expression *expr, int depth)
+{
+  if (! expr || depth >= max_depth)
+    return false;
+
+  if (expr->is_identifier () || expr->is_constant ())
+    {
+      if (m_leaves.size () >= max_leaves)
+        return false;
+
+      m_code.push_back ({op_push, static_cast<int> (m_leaves.size ())});
+      m_leaves.push_back (expr);
+      return true;
+    }
+
+  if (expr->is_unary_expression ())
+    {
+      tree_prefix_expression *pe
+        = dynamic_cast<tree_prefix_expression *> (expr);
+
+      if (! pe || pe->op_type () != octave_value::op_uminus
+          || ! compile (pe->operand (), depth))
+        return false;
+
+      m_code.push_back ({op_neg, 0});
+      return true;
+    }
+
+  if (! expr->is_binary_expression () || expr->is_boolean_expression ())
+    return false;
+
+  tree_binary_expression *be = dynamic_cast<tree_binary_expression *> (expr);
+
+  if (! be || be->is_braindead ()
+      || dynamic_cast<tree_compound_binary_expression *> (be))
+    return false;
+
+  instruction ins;
+
+  switch (be->op_type ())
+    {
+    case octave_value::op_add:
+      ins = {op_add, 0};
+      break;
+
+    case octave_value::op_sub:
+      ins = {op_sub, 0};
+      break;
+
+    case octave_value::op_el_mul:
+      ins = {op_mul, 0};
+      break;
+
+    case octave_value::op_mul:
+      ins = {op_mul, 1};
+      break;
+
+    case octave_value::op_el_div:
+      ins = {op_div, 0};
+      break;
+
+    case octave_value::op_div:
+      ins = {op_div, 1};
+      break;
+
+    default:
+      return false;
+    }
+
+  if (! compile (be->lhs (), depth) || ! compile (be->rhs (), depth + 1))
+    return false;
+
+  m_code.push_back (ins);
+
+  m_operands.push_back (be);
+
+  return true;
+}
+
+template <typename OP>
+static inline void
+apply_elementwise (const double *x, double xs, const double *y, double ys,
+                   double *r, octave_idx_type n, OP op)
+{
+  if (! x)
+    for (octave_idx_type i = 0; i < n; i++)
+      r[i] = op (xs, y[i]);
+  else if (! y)
+    for (octave_idx_type i = 0; i < n; i++)
+      r[i] = op (x[i], ys);
+  else
+    for (octave_idx_type i = 0; i < n; i++)
+      r[i] = op (x[i], y[i]);
+}
+
+void
+fused_elementwise_kernel::run (const operand *leaves, octave_idx_type len,
+                               double *buf, double *dest) const
+{
+  operand stack[max_depth];
+  int top = 0;
+
+  for (const auto& ins : m_code)
+    {
+      if (ins.op == op_push)
+        {
+          stack[top++] = leaves[ins.arg];
+          continue;
+        }
+
+      if (ins.op == op_neg)
+        {
+          operand& x = stack[top-1];
+
+          if (x.data)
+            {
+              double *r = buf + (top-1) * block_len;
+              for (octave_idx_type i = 0; i < len; i++)
+                r[i] = -x.data[i];
+              x.data = r;
+            }
+          else
+            x.scalar = -x.scalar;
+
+          continue;
+        }
+
+      operand& x = stack[top-2];
+      const operand& y = stack[top-1];
+
+      top--;
+
+      if (! x.data && ! y.data)
+        {
+          switch (ins.op)
+            {
+            case op_add: x.scalar = x.scalar + y.scalar; break;
+            case op_sub: x.scalar = x.scalar - y.scalar; break;
+            case op_mul: x.scalar = x.scalar * y.scalar; break;
+            case op_div: x.scalar = x.scalar / y.scalar; break;
+            default: break;
+            }
+
+          continue;
+        }
+
+      double *r = (&ins == &m_code.back () ? dest : buf + (top-1) * block_len);
+
+      switch (ins.op)
+        {
+        case op_add:
+          apply_elementwise (x.data, x.scalar, y.data, y.scalar, r, len,
+                             std::plus<double> ());
+          break;
+
+        case op_sub:
+          apply_elementwise (x.data, x.scalar, y.data, y.scalar, r, len,
+                             std::minus<double> ());
+          break;
+
+        case op_mul:
+          apply_elementwise (x.data, x.scalar, y.data, y.scalar, r, len,
+                             std::multiplies<double> ());
+          break;
+
+        case op_div:
+          apply_elementwise (x.data, x.scalar, y.data, y.scalar, r, len,
+                             std::divides<double> ());
+          break;
+
+        default:
+          break;
+        }
+
+      x.data = r;
+    }
+
+  if (stack[0].data != dest)
+    std::copy_n (stack[0].data, len, dest);
+}
+
+bool
+fused_elementwise_kernel::evaluate (tree_evaluator& tw,
+                                    tree_binary_expression& expr,
+                                    octave_value& retval) const
+{
+  std::size_t nleaves = m_leaves.size ();
+
+  std::vector<NDArray> arrays (nleaves);
+  std::vector<operand> leaves (nleaves);
+
+  dim_vector dv;
+  bool have_array = false;
+
+  for (std::size_t i = 0; i < nleaves; i++)
+    {
+      tree_expression *leaf = m_leaves[i];
+
+      octave_value val;
+
+      if (leaf->is_identifier ())
+        {
+          tree_identifier *id = dynamic_cast<tree_identifier *> (leaf);
+
+          // Not a variable, so possibly a function call.
+          val = tw.varval (id->symbol ());
+          if (val.is_undefined ())
+            return false;
+        }
+      else
+        val = leaf->evaluate (tw);
+
+      leaves[i] = {nullptr, 0.0};
+
+      if (val.is_double_type () && val.is_real_scalar ())
+        leaves[i].scalar = val.scalar_value ();
+      else if (val.type_id () == octave_matrix::static_type_id ())
+        {
+          arrays[i] = val.array_value ();
+
+          if (arrays[i].numel () == 1)
+            leaves[i].scalar = arrays[i].xelem (0);
+          else
+            {
+              // Let the usual operators handle broadcasting and errors.
+              if (! have_array)
+                {
+                  dv = arrays[i].dims ();
+                  have_array = true;
+                }
+              else if (arrays[i].dims () != dv)
+                return false;
+
+              leaves[i].data = arrays[i].data ();
+            }
+        }
+      else
+        return false;
+    }
+
+  if (! have_array)
+    return false;
+
+  // Matrix multiplication and right division are only elementwise if
+  // one operand (the rhs for division) is a scalar.
+
+  bool is_scalar[max_depth];
+  int top = 0;
+
+  for (const auto& ins : m_code)
+    {
+      if (ins.op == op_push)
+        is_scalar[top++] = ! leaves[ins.arg].data;
+      else if (ins.op != op_neg)
+        {
+          bool xs = is_scalar[top-2];
+          bool ys = is_scalar[top-1];
+
+          if (ins.arg && ! ys && (ins.op == op_div || ! xs))
+            return false;
+
+          top--;
+          is_scalar[top-1] = xs && ys;
+        }
+    }
+
+  profiler::enter<tree_binary_expression>
+  block (tw.get_profiler (), expr);
+
+  NDArray result (dv);
+
+  const operand *pleaves = leaves.data ();
+  double *dest = result.rwdata ();
+
+  auto body = [=] (octave_idx_type lo, octave_idx_type hi)
+  {
+    double buf[max_depth * block_len];
+    operand blk_leaves[max_leaves];
+
+    for (octave_idx_type k = lo; k < hi; k += block_len)
+      {
+        octave_idx_type len = std::min (block_len, hi - k);
+
+        for (std::size_t i = 0; i < nleaves; i++)
+          {
+            blk_leaves[i] = pleaves[i];
+            if (blk_leaves[i].data)
+              blk_leaves[i].data += k;
+          }
+
+        run (blk_leaves, len, buf, dest + k);
+      }
+  };
+
+  parallel_for (result.numel (), 16 * block_len, body);
+
+  retval = result;
+
+  return true;
+}
+
+bool
+tree_binary_expression::maybe_evaluate_fused (tree_evaluator& tw,
+                                              octave_value& retval)
+{
+  if (m_fusion == fusion_unknown)
+    {
+      m_kernel.reset (fused_elementwise_kernel::create (*this));
+
+      m_fusion = (m_kernel ? fusion_root : fusion_none);
+    }
+
+  if (m_fusion != fusion_root)
+    return false;
+
+  if (m_fusion_skip > 0)
+    {
+      m_fusion_skip--;
+      return false;
+    }
+
+  if (m_kernel->evaluate (tw, *this, retval))
+    {
+      m_fusion_failures = 0;
+      return true;
+    }
+
+  // The operand values were not suitable, for example because they are
+  // scalars or not double.  They are often unsuitable next time as well,
+  // so wait before checking again, but keep trying because a loop may
+  // start with scalars and continue with arrays.
+
+  static const unsigned int max_fusion_failures = 6;
+
+  if (m_fusion_failures < max_fusion_failures)
+    m_fusion_failures++;
+
+  m_fusion_skip = (1u << m_fusion_failures) - 1;
+
+  return false;
+}
+
 octave_value
 tree_binary_expression::evaluate (tree_evaluator& tw, int)
 {
+  if (m_fusion == fusion_unknown || m_fusion == fusion_root)
+    {
+      octave_value retval;
+
+      if (maybe_evaluate_fused (tw, retval))
+        return retval;
+    }
+
   if (m_lhs)
     {
       // Evaluate with unknown number of output arguments
@@ -245,3 +707,72 @@ tree_boolean_expression::evaluate (tree_evaluator& tw, int)
 }
 
 OCTAVE_END_NAMESPACE(octave)
+
+/*
+## Fused evaluation of elementwise expressions
+%!function y = fused_loop (a, b, c, x)
+%!  y = zeros (size (x));
+%!  for i = 1:numel (x)
+%!    y(i) = a(i) * x(i) + b * x(i) - x(i) / c;
+%!  endfor
+%!endfunction
+
+%!test
+%! a = rand (300, 400);
+%! x = randn (300, 400);
+%! b = 3;
+%! c = 7;
+%! y = a.*x + b*x - x/c;
+%! assert (y, fused_loop (a, b, c, x), -2*eps);
+%! assert (size (y), [300, 400]);
+
+%!test
+%! x = reshape (1:24, 2, 3, 4);
+%! assert (-x.*2 + 1 - x./4, -2*x + 1 - x/4);
+%! assert (-x.*2 + 1 - x./4, reshape (1 - (9/4)*(1:24), 2, 3, 4));
+
+## Scalar operands and broadcasting use the usual evaluation
+%!assert (2 .* 3 + 4, 10)
+%!test
+%! x = [1, 2, 3];
+%! assert (x .* [1; 2] + 1, [2, 3, 4; 3, 5, 7]);
+
+## Matrix operators are only elementwise with scalar operands
+%!test
+%! a = [1, 2; 3, 4];
+%! assert (a * a + a, [8, 12; 18, 26]);
+%! assert (a / a + a, a + eye (2), eps);
+%! assert (2 ./ a + a, [3, 3; 11/3, 4.5]);
+
+## Mixed types use the usual evaluation
+%!test
+%! x = single ([1, 2, 3]);
+%! y = x .* 2 + 1;
+%! assert (class (y), "single");
+%! assert (y, single ([3, 5, 7]));
+%! x = int8 ([1, 2, 3]);
+%! assert (x .* 2 + 1, int8 ([3, 5, 7]));
+%! x = [1, 2, 3] + i;
+%! assert (x .* 2 + 1, [3, 5, 7] + 2i);
+
+## Same expression, values with different types
+%!test
+%! f = @(x) x .* 2 + x - 1;
+%! assert (f ([1, 2, 3]), [2, 5, 8]);
+%! assert (f (int16 ([1, 2, 3])), int16 ([2, 5, 8]));
+%! assert (f ([1, 2, 3]), [2, 5, 8]);
+
+## Operands that start as scalars and later become arrays
+%!test
+%! f = @(x) x .* 2 + x - 1;
+%! for n = [1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 50, 50, 50, 50, 50]
+%!   x = (1:n)';
+%!   assert (f (x), 3*x - 1);
+%!   assert (f (single (x)), single (3*x - 1));
+%! endfor
+
+%!error <operator \+: nonconformant arguments>
+%! x = ones (2, 3);
+%! y = ones (3, 2);
+%! z = x .* 2 + y;
+*/
@@ -28,6 +28,7 @@
 
 #include "octave-config.h"
 
+#include <memory>
 #include <string>
 
 class octave_value;
@@ -40,6 +41,7 @@ class octave_value_list;
 OCTAVE_BEGIN_NAMESPACE(octave)
 
 class symbol_scope;
+class fused_elementwise_kernel;
 
 // Binary expressions.
 
@@ -51,7 +53,8 @@ public:
                           octave_value::binary_op t
                           = octave_value::unknown_binary_op)
     : tree_expression (l, c), m_lhs (nullptr), m_rhs (nullptr), m_etype (t),
-      m_preserve_operands (false)
+      m_preserve_operands (false), m_fusion (fusion_unknown),
+      m_fusion_failures (0), m_fusion_skip (0), m_kernel ()
   { }
 
   tree_binary_expression (tree_expression *a, tree_expression *b,
@@ -59,7 +62,8 @@ public:
                           octave_value::binary_op t
                           = octave_value::unknown_binary_op)
     : tree_expression (l, c), m_lhs (a), m_rhs (b), m_etype (t),
-      m_preserve_operands (false)
+      m_preserve_operands (false), m_fusion (fusion_unknown),
+      m_fusion_failures (0), m_fusion_skip (0), m_kernel ()
   { }
 
   OCTAVE_DISABLE_COPY_MOVE (tree_binary_expression)
@@ -116,11 +120,40 @@ protected:
 
 private:
 
+  friend class fused_elementwise_kernel;
+
+  bool maybe_evaluate_fused (tree_evaluator& tw, octave_value& retval);
+
   // The type of the expression.
   octave_value::binary_op m_etype;
 
   // If TRUE, don't delete m_lhs and m_rhs in destructor;
   bool m_preserve_operands;
+
+  // Trees of elementwise operations on full real double arrays may be
+  // evaluated in a single pass without temporaries.  The kernel is
+  // built on first evaluation of the outermost expression of such a
+  // tree.  Inner expressions are marked so that they don't try again.
+  // If the operand values are not suitable, the expression is evaluated
+  // as usual and the kernel is not tried again for a number of
+  // evaluations that doubles with each consecutive failure.
+
+  enum fusion_state
+  {
+    fusion_unknown,
+    fusion_none,
+    fusion_root,
+    fusion_operand
+  };
+
+  fusion_state m_fusion;
+
+  // Number of consecutive evaluations for which the kernel could not be
+  // used, and number of evaluations left before it is tried again.
+  unsigned int m_fusion_failures;
+  unsigned int m_fusion_skip;
+
+  std::shared_ptr<fused_elementwise_kernel> m_kernel;
 };
 
 class tree_braindead_shortcircuit_binary_expression
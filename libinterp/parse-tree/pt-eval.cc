@@ -601,6 +601,8 @@ tree_evaluator::parse_and_execute (const std::string& input,
 
   Vlast_prompt_time.stamp ();
 
+  m_interpreter.get_symbol_table ().invalidate_lookups ();
+
   bool eof = false;
 
   event_manager& evmgr = m_interpreter.get_event_manager ();
@@ -2493,6 +2495,14 @@ tree_evaluator::push_stack_frame (octave_user_function *fcn,
   m_call_stack.push (fcn, local_vars, closure_frames);
 }
 
+void
+tree_evaluator::push_stack_frame (octave_user_function *fcn,
+                                  const stack_frame::local_vars_list& local_vars,
+                                  const std::shared_ptr<stack_frame>& closure_frames)
+{
+  m_call_stack.push (fcn, local_vars, closure_frames);
+}
+
 void
 tree_evaluator::push_stack_frame (octave_user_script *script)
 {
@@ -4704,6 +4714,10 @@ tree_evaluator::add_autoload (const std::string& fcn,
                               const std::string& nm)
 {
   m_autoload_map[fcn] = check_autoload_file (nm);
+
+  symbol_table& symtab = m_interpreter.get_symbol_table ();
+
+  symtab.invalidate_lookups ();
 }
 
 void
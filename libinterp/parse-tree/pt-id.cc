@@ -102,7 +102,7 @@ tree_identifier::evaluate_n (tree_evaluator& tw, int nargout)
 
       symbol_table& symtab = interp.get_symbol_table ();
 
-      val = symtab.find_function (m_sym.name ());
+      val = symtab.find_function (m_sym.name (), ovl (), m_fcn_cache);
     }
 
   if (val.is_defined ())
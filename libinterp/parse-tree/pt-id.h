@@ -40,6 +40,7 @@ class octave_function;
 #include "pt-exp.h"
 #include "pt-walk.h"
 #include "symscope.h"
+#include "symtab.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
@@ -54,11 +55,11 @@ class tree_identifier : public tree_expression
 public:
 
   tree_identifier (int l = -1, int c = -1)
-    : tree_expression (l, c), m_sym () { }
+    : tree_expression (l, c), m_sym (), m_fcn_cache () { }
 
   tree_identifier (const symbol_record& s,
                    int l = -1, int c = -1)
-    : tree_expression (l, c), m_sym (s) { }
+    : tree_expression (l, c), m_sym (s), m_fcn_cache () { }
 
   OCTAVE_DISABLE_COPY_MOVE (tree_identifier)
 
@@ -109,6 +110,9 @@ protected:
 
   // The symbol record that this identifier references.
   symbol_record m_sym;
+
+  // The function found the last time this identifier was evaluated.
+  fcn_lookup_cache m_fcn_cache;
 };
 
 class tree_black_hole : public tree_identifier
@@ -48,13 +48,15 @@ OCTAVE_BEGIN_NAMESPACE(octave)
 
 tree_index_expression::tree_index_expression (int l, int c)
   : tree_expression (l, c), m_expr (nullptr), m_args (0), m_type (),
-    m_arg_nm (), m_dyn_field (), m_word_list_cmd (false) { }
+    m_arg_nm (), m_dyn_field (), m_word_list_cmd (false),
+    m_fcn_cache () { }
 
 tree_index_expression::tree_index_expression (tree_expression *e,
     tree_argument_list *lst,
     int l, int c, char t)
   : tree_expression (l, c), m_expr (e), m_args (0), m_type (),
-    m_arg_nm (), m_dyn_field (), m_word_list_cmd (false)
+    m_arg_nm (), m_dyn_field (), m_word_list_cmd (false),
+    m_fcn_cache ()
 {
   append (lst, t);
 }
@@ -63,7 +65,8 @@ tree_index_expression::tree_index_expression (tree_expression *e,
     const std::string& n,
     int l, int c)
   : tree_expression (l, c), m_expr (e), m_args (0), m_type (),
-    m_arg_nm (), m_dyn_field (), m_word_list_cmd (false)
+    m_arg_nm (), m_dyn_field (), m_word_list_cmd (false),
+    m_fcn_cache ()
 {
   append (n);
 }
@@ -72,7 +75,8 @@ tree_index_expression::tree_index_expression (tree_expression *e,
     tree_expression *df,
     int l, int c)
   : tree_expression (l, c), m_expr (e), m_args (0), m_type (),
-    m_arg_nm (), m_dyn_field (), m_word_list_cmd (false)
+    m_arg_nm (), m_dyn_field (), m_word_list_cmd (false),
+    m_fcn_cache ()
 {
   append (df);
 }
@@ -413,7 +417,7 @@ tree_index_expression::evaluate_n (tree_evaluator& tw, int nargout)
 
           symbol_table& symtab = interp.get_symbol_table ();
 
-          octave_value val = symtab.find_function (nm, first_args);
+          octave_value val = symtab.find_function (nm, first_args, m_fcn_cache);
 
           octave_function *fcn = nullptr;
 
@@ -38,6 +38,7 @@ class octave_value_list;
 
 #include "pt-exp.h"
 #include "pt-walk.h"
+#include "symtab.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
@@ -139,6 +140,9 @@ private:
   // TRUE if this expression was parsed as a word list command.
   bool m_word_list_cmd;
 
+  // The function found the last time this expression was evaluated.
+  fcn_lookup_cache m_fcn_cache;
+
   tree_index_expression (int l, int c);
 
   octave_map make_arg_struct () const;
@@ -27,6 +27,8 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+
 #include "oct-locbuf.h"
 #include "quit.h"
 
@@ -580,11 +582,29 @@ tm_const::generic_concat () const
 // char_array_concat function can create the array externally.
 // Otherwise, we would need a specialization of this function for
 // character arrays just to handle string_fill_char.
+//
+// When the result is a 2-D array, every element is written directly
+// into its final position in RESULT.  Scalars are converted to the
+// element type of the result without creating an intermediate array
+// and other values are copied column by column.  Only N-d results use
+// the general (and much slower) indexed assignment.
 
 template <typename TYPE>
 void
 tm_const::array_concat_internal (TYPE& result) const
 {
+  typedef typename TYPE::element_type ELT_T;
+
+  bool direct = (result.ndims () == 2);
+
+  // Character and cell arrays have no scalar value extractor.
+  bool extract_scalars
+    = ! (equal_types<ELT_T, char>::value
+         || equal_types<ELT_T, octave_value>::value);
+
+  octave_idx_type nr = result.rows ();
+  ELT_T *dest = result.rwdata ();
+
   octave_idx_type r = 0;
   octave_idx_type c = 0;
 
@@ -598,15 +618,37 @@ tm_const::array_concat_internal (TYPE& result) const
         {
           octave_quit ();
 
+          if (direct && extract_scalars && elt.numel () == 1
+              && ! elt.issparse ())
+            {
+              dest[c*nr + r] = octave_value_extract<ELT_T> (elt);
+
+              c++;
+
+              continue;
+            }
+
           TYPE ra = octave_value_extract<TYPE> (elt);
 
           // Skip empty arrays to allow looser rules.
 
           if (! ra.isempty ())
             {
-              result.insert (ra, r, c);
+              octave_idx_type ra_nr = ra.rows ();
+              octave_idx_type ra_nc = ra.columns ();
+
+              if (direct && ra.ndims () == 2)
+                {
+                  const ELT_T *src = ra.data ();
 
-              c += ra.columns ();
+                  for (octave_idx_type j = 0; j < ra_nc; j++)
+                    std::copy_n (src + j*ra_nr, ra_nr,
+                                 dest + (c+j)*nr + r);
+                }
+              else
+                result.insert (ra, r, c);
+
+              c += ra_nc;
             }
         }
 
@@ -619,30 +661,14 @@ template <typename TYPE>
 TYPE
 tm_const::array_concat () const
 {
-  typedef typename TYPE::element_type ELT_T;
-
   if (m_dv.any_zero ())
     return TYPE (m_dv);
 
-  if (m_tm_rows.size () == 1)
+  if (m_tm_rows.size () == 1 && m_dv.ndims () > 2)
     {
       // If possible, forward the operation to liboctave.
-      // Single row.
+      // Single row of N-d arrays.
       const tm_row_const& row = m_tm_rows.front ();
-      if (! (equal_types<ELT_T, char>::value
-             || equal_types<ELT_T, octave_value>::value)
-          && row.all_1x1_p ())
-        {
-          // Optimize all scalars case.
-          TYPE result (m_dv);
-          panic_unless (static_cast<std::size_t> (result.numel ())
-                        == row.length ());
-          octave_idx_type i = 0;
-          for (const auto& elt : row)
-            result(i++) = octave_value_extract<ELT_T> (elt);
-
-          return result;
-        }
 
       octave_idx_type ncols = row.length ();
       octave_idx_type i = 0;
@@ -925,6 +951,22 @@ OCTAVE_END_NAMESPACE(octave)
 %!assert (class (["a", true]), "char")
 %!assert (class (["a", "a"]), "char")
 
+## Elements are written directly into the result
+%!test
+%! a = reshape (1:6, 2, 3);
+%! assert ([a, [7; 8]; 9, 10, 11, 12], [1, 3, 5, 7; 2, 4, 6, 8; 9:12]);
+%! assert ([a; single(9), int8(10), 11], int8 ([1, 3, 5; 2, 4, 6; 9, 10, 11]));
+%! assert ([1, 2i; true, single(4)], single ([1, 2i; 1, 4]));
+%! assert ([int8(100), 200; -300, 1.5], int8 ([100, 127; -128, 2]));
+%! assert ([{1}, 2; "a", {[]}], {1, 2; "a", []});
+%! assert (["abc"; "de"], ["abc"; "de "]);
+%! assert ([zeros(1, 0), 1; [2; 3]], [1; 2; 3]);
+
+%!test
+%! x = ones (2, 2, 2);
+%! assert ([x, x; x, x], ones (4, 4, 2));
+%! assert ([x, 2*x], cat (2, x, 2*x));
+
 %!assert (class ([cell(1), struct("foo", "bar")]), "cell")
 %!error [struct("foo", "bar"), cell(1)]
 
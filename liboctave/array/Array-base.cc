@@ -32,6 +32,7 @@
 // this file.
 
 #include <ostream>
+#include <type_traits>
 
 #include "Array-util.h"
 #include "Array.h"
@@ -363,47 +364,123 @@ public:
   ~rec_permute_helper () { delete [] m_dim; }
 
   template <typename T>
-  void permute (const T *src, T *dest) const { do_permute (src, dest, m_top); }
+  void permute (const T *src, T *dest) const
+  {
+#if defined (HAVE_OPENMP)
+    // Split the outer dimensions among threads.  Each outer index
+    // writes a disjoint, contiguous part of DEST.  The lowest levels
+    // (including a block transpose, which is threaded by itself) are
+    // left to do_permute.
+
+    int min_lev = (m_use_blk ? 2 : 1);
+
+    if (m_top >= min_lev && use_threads<T> (numel ()))
+      {
+        // Collapse outer levels until there is enough work to share.
+        int lev = m_top;
+        octave_idx_type nouter = m_dim[lev];
+        while (lev > min_lev && nouter < 64)
+          nouter *= m_dim[--lev];
+
+        octave_idx_type ninner = numel () / nouter;
+
+#  pragma omp parallel for
+        for (octave_idx_type k = 0; k < nouter; k++)
+          {
+            octave_idx_type off = 0;
+            octave_idx_type kk = k;
+            for (int i = lev; i <= m_top; i++)
+              {
+                off += (kk % m_dim[i]) * m_stride[i];
+                kk /= m_dim[i];
+              }
+
+            do_permute (src + off, dest + k * ninner, lev-1);
+          }
+
+        return;
+      }
+#endif
+
+    do_permute (src, dest, m_top);
+  }
 
-  // Helper method for fast blocked transpose.
+  // Helper method for fast blocked transpose.  Source blocks are
+  // transposed through a small square buffer that fits in L1 cache.
+  // Independent rows of blocks are distributed among threads.
   template <typename T>
   static T *
   blk_trans (const T *src, T *dest, octave_idx_type nr, octave_idx_type nc)
   {
-    static const octave_idx_type m = 8;
-    OCTAVE_LOCAL_BUFFER (T, blk, m*m);
-    for (octave_idx_type kr = 0; kr < nr; kr += m)
-      for (octave_idx_type kc = 0; kc < nc; kc += m)
+    static const octave_idx_type m = blk_size<T> ();
+
+    octave_idx_type nbr = (nr + m - 1) / m;
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel if (use_threads<T> (nr*nc))
+#endif
+    {
+      OCTAVE_LOCAL_BUFFER (T, blk, m*m);
+
+#if defined (HAVE_OPENMP)
+#  pragma omp for
+#endif
+      for (octave_idx_type br = 0; br < nbr; br++)
         {
+          octave_idx_type kr = br * m;
           octave_idx_type lr = std::min (m, nr - kr);
-          octave_idx_type lc = std::min (m, nc - kc);
-          if (lr == m && lc == m)
-            {
-              const T *ss = src + kc * nr + kr;
-              for (octave_idx_type j = 0; j < m; j++)
-                for (octave_idx_type i = 0; i < m; i++)
-                  blk[j*m+i] = ss[j*nr + i];
-              T *dd = dest + kr * nc + kc;
-              for (octave_idx_type j = 0; j < m; j++)
-                for (octave_idx_type i = 0; i < m; i++)
-                  dd[j*nc+i] = blk[i*m+j];
-            }
-          else
+
+          for (octave_idx_type kc = 0; kc < nc; kc += m)
             {
-              const T *ss = src + kc * nr + kr;
-              for (octave_idx_type j = 0; j < lc; j++)
-                for (octave_idx_type i = 0; i < lr; i++)
-                  blk[j*m+i] = ss[j*nr + i];
-              T *dd = dest + kr * nc + kc;
-              for (octave_idx_type j = 0; j < lr; j++)
-                for (octave_idx_type i = 0; i < lc; i++)
-                  dd[j*nc+i] = blk[i*m+j];
+              octave_idx_type lc = std::min (m, nc - kc);
+              if (lr == m && lc == m)
+                {
+                  const T *ss = src + kc * nr + kr;
+                  for (octave_idx_type j = 0; j < m; j++)
+                    for (octave_idx_type i = 0; i < m; i++)
+                      blk[j*m+i] = ss[j*nr + i];
+                  T *dd = dest + kr * nc + kc;
+                  for (octave_idx_type j = 0; j < m; j++)
+                    for (octave_idx_type i = 0; i < m; i++)
+                      dd[j*nc+i] = blk[i*m+j];
+                }
+              else
+                {
+                  const T *ss = src + kc * nr + kr;
+                  for (octave_idx_type j = 0; j < lc; j++)
+                    for (octave_idx_type i = 0; i < lr; i++)
+                      blk[j*m+i] = ss[j*nr + i];
+                  T *dd = dest + kr * nc + kc;
+                  for (octave_idx_type j = 0; j < lr; j++)
+                    for (octave_idx_type i = 0; i < lc; i++)
+                      dd[j*nc+i] = blk[i*m+j];
+                }
             }
         }
+    }
 
     return dest + nr*nc;
   }
 
+  // Side length of the square blocks used by blk_trans.  Each column
+  // of a block spans at least one 64-byte cache line, so small types
+  // (bool, char, int8, ...) use larger blocks.
+  template <typename T>
+  static constexpr octave_idx_type
+  blk_size ()
+  {
+    return sizeof (T) >= 8 ? 8 : 64 / sizeof (T);
+  }
+
+  // Only use multiple threads for large arrays of types that can be
+  // copied without side effects.
+  template <typename T>
+  static bool
+  use_threads (octave_idx_type n)
+  {
+    return std::is_trivially_copyable<T>::value && n >= 262144;
+  }
+
 private:
 
   // Recursive N-D generalized transpose
@@ -440,6 +517,14 @@ private:
     return dest;
   }
 
+  octave_idx_type numel () const
+  {
+    octave_idx_type n = 1;
+    for (int i = 0; i <= m_top; i++)
+      n *= m_dim[i];
+    return n;
+  }
+
   //--------
 
   // STRIDE occupies the last half of the space allocated for dim to
@@ -220,6 +220,8 @@ public:
       {
         ArrayRep *r = new ArrayRep (m_slice_data, m_slice_len);
 
+        octave::note_array_copy ();
+
         if (--m_rep->m_count == 0)
           delete m_rep;
 
@@ -1500,9 +1500,10 @@ Sparse<T, Alloc>::index (const octave::idx_vector& idx, bool resize_ok) const
           else
             retval = Sparse (1, 1);
         }
-      else if (idx.is_cont_range (nel, lb, ub))
+      else if (idx_dims.isvector () && idx.is_cont_range (nel, lb, ub))
         {
-          // Special-case a contiguous range.
+          // Special-case a contiguous range.  A matrix-shaped index is
+          // handled below, since the result takes its shape.
           // Look-up indices first.
           octave_idx_type li = lblookup (ridx (), nz, lb);
           octave_idx_type ui = lblookup (ridx (), nz, ub);
@@ -1590,7 +1591,7 @@ Sparse<T, Alloc>::index (const octave::idx_vector& idx, bool resize_ok) const
       octave_idx_type lb, ub;
       if (idx.is_scalar ())
         retval = Sparse<T, Alloc> (1, 1, elem (0, idx(0)));
-      else if (idx.is_cont_range (nel, lb, ub))
+      else if (idx_dims.isvector () && idx.is_cont_range (nel, lb, ub))
         {
           // Special-case a contiguous range.
           octave_idx_type lbi = cidx (lb);
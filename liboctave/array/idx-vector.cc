@@ -27,6 +27,7 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstdlib>
 
@@ -782,6 +783,27 @@ idx_vector::maybe_reduce (octave_idx_type n, const idx_vector& j,
       return true;
     }
 
+  // Contiguous vector and mask indices reduce like the equivalent
+  // ranges.  This allows indexing with them to produce shallow slices.
+  octave_idx_type l, u;
+
+  if ((j.idx_class () == class_vector || j.idx_class () == class_mask)
+      && j.length (nj) > 0 && j.is_cont_range (nj, l, u))
+    return maybe_reduce (n, idx_vector (l, u), nj);
+
+  if ((m_rep->idx_class () == class_vector
+       || m_rep->idx_class () == class_mask)
+      && is_cont_range (n, l, u))
+    {
+      idx_vector tmp (l, u);
+
+      if (! tmp.maybe_reduce (n, j, nj))
+        return false;
+
+      *this = tmp;
+      return true;
+    }
+
   // Possibly skip singleton dims.
   if (n == 1 && m_rep->is_colon_equiv (n))
     {
@@ -974,16 +996,53 @@ idx_vector::is_cont_range (octave_idx_type n, octave_idx_type& l,
 
     case class_mask:
       {
+        // A mask is contiguous if its true elements form a single run.
         idx_mask_rep *r = dynamic_cast<idx_mask_rep *> (m_rep);
         octave_idx_type m_ext = r->extent (0);
         octave_idx_type m_len = r->length (0);
-        if (m_ext == m_len)
+        if (m_len > 0)
+          {
+            const bool *data = r->get_data ();
+            octave_idx_type k = m_ext - m_len;
+            if (std::all_of (data + k, data + m_ext,
+                             [] (bool b) { return b; }))
+              {
+                l = k;
+                u = m_ext;
+                res = true;
+              }
+          }
+        else if (m_ext == 0)
           {
             l = 0;
-            u = m_len;
+            u = 0;
             res = true;
           }
       }
+      break;
+
+    case class_vector:
+      {
+        // Vectors of consecutive increasing indices are contiguous.
+        idx_vector_rep *r = dynamic_cast<idx_vector_rep *> (m_rep);
+        octave_idx_type m_ext = r->extent (0);
+        octave_idx_type m_len = r->length (0);
+        const octave_idx_type *data = r->get_data ();
+        if (m_len > 0 && data[0] == m_ext - m_len)
+          {
+            octave_idx_type k = 1;
+            while (k < m_len && data[k] == data[0] + k)
+              k++;
+
+            if (k == m_len)
+              {
+                l = data[0];
+                u = m_ext;
+                res = true;
+              }
+          }
+      }
+      break;
 
     default:
       break;
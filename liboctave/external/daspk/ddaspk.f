@@ -1628,6 +1628,16 @@ C-----------------------------------------------------------------------
 C
 200   CONTINUE
 C
+C     Recompute the saved values NONNEG, LID, and LENID from INFO,
+C     since another problem may have been solved since the last call.
+C
+      NONNEG = 0
+      IF (INFO(10) .EQ. 2 .OR. INFO(10) .EQ. 3) NONNEG = 1
+      LID = LICNS
+      IF (INFO(10) .EQ. 1 .OR. INFO(10) .EQ. 3) LID = LICNS + NEQ
+      LENID = 0
+      IF (INFO(11) .EQ. 1 .OR. INFO(16) .EQ. 1) LENID = NEQ
+C
 C     Save counters for use later.
 C
       IWORK(LNSTL)=IWORK(LNST)
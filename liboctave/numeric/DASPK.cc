@@ -35,6 +35,7 @@
 #include "f77-fcn.h"
 #include "lo-error.h"
 #include "quit.h"
+#include "unwind-prot.h"
 
 typedef F77_INT (*daspk_fcn_ptr) (const double&, const double *, const double *,
                                   const double&, double *, F77_INT&, double *,
@@ -144,6 +145,17 @@ DASPK::do_integrate (double tout)
 
   ColumnVector retval;
 
+  // Make the user functions of this object current.  They are
+  // restored when this function returns, so that the user functions
+  // may integrate other DASPK objects.
+
+  octave::unwind_protect_var<DAEFunc::DAERHSFunc>
+    restore_fcn (user_fcn, DAEFunc::function ());
+  octave::unwind_protect_var<DAEFunc::DAEJacFunc>
+    restore_jac (user_jac, DAEFunc::jacobian_function ());
+  octave::unwind_protect_var<F77_INT>
+    restore_nn (nn, octave::to_f77_int (size ()));
+
   if (! m_initialized || m_restart || DAEFunc::m_reset
       || DASPK_options::m_reset)
     {
@@ -158,8 +170,6 @@ DASPK::do_integrate (double tout)
 
       F77_INT n = octave::to_f77_int (size ());
 
-      nn = n;
-
       m_info(0) = 0;
 
       if (m_stop_time_set)
@@ -172,9 +182,6 @@ DASPK::do_integrate (double tout)
 
       // DAEFunc
 
-      user_fcn = DAEFunc::function ();
-      user_jac = DAEFunc::jacobian_function ();
-
       if (user_fcn)
         {
           octave_idx_type ires = 0;
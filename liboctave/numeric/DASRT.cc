@@ -34,6 +34,7 @@
 #include "f77-fcn.h"
 #include "lo-error.h"
 #include "quit.h"
+#include "unwind-prot.h"
 
 typedef F77_INT (*dasrt_fcn_ptr) (const double&, const double *, const double *,
                                   double *, F77_INT&, double *, F77_INT *);
@@ -142,6 +143,19 @@ DASRT::integrate (double tout)
   // call, or if anything about the problem has changed, we should
   // start completely fresh.
 
+  // Make the user functions of this object current.  They are
+  // restored when this function returns, so that the user functions
+  // may integrate other DASRT objects.
+
+  octave::unwind_protect_var<DAEFunc::DAERHSFunc>
+    restore_fsub (user_fsub, DAEFunc::function ());
+  octave::unwind_protect_var<DAEFunc::DAEJacFunc>
+    restore_jsub (user_jsub, DAEFunc::jacobian_function ());
+  octave::unwind_protect_var<DAERTFunc::DAERTConstrFunc>
+    restore_csub (user_csub, DAERTFunc::constraint_function ());
+  octave::unwind_protect_var<F77_INT>
+    restore_nn (nn, octave::to_f77_int (size ()));
+
   if (! m_initialized || m_restart
       || DAEFunc::m_reset || DAERTFunc::m_reset || DASRT_options::m_reset)
     {
@@ -156,12 +170,8 @@ DASRT::integrate (double tout)
 
       F77_INT n = octave::to_f77_int (size ());
 
-      nn = n;
-
       // DAERTFunc
 
-      user_csub = DAERTFunc::constraint_function ();
-
       if (user_csub)
         {
           ColumnVector tmp = (*user_csub) (m_x, m_t);
@@ -207,9 +217,6 @@ DASRT::integrate (double tout)
 
       // DAEFunc
 
-      user_fsub = DAEFunc::function ();
-      user_jsub = DAEFunc::jacobian_function ();
-
       if (user_fsub)
         {
           octave_idx_type ires = 0;
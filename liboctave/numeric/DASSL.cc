@@ -35,6 +35,7 @@
 #include "f77-fcn.h"
 #include "lo-error.h"
 #include "quit.h"
+#include "unwind-prot.h"
 
 typedef F77_INT (*dassl_fcn_ptr) (const double&, const double *,
                                   const double *, double *, F77_INT&,
@@ -125,6 +126,17 @@ DASSL::do_integrate (double tout)
 {
   ColumnVector retval;
 
+  // Make the user functions of this object current.  They are
+  // restored when this function returns, so that the user functions
+  // may integrate other DASSL objects.
+
+  octave::unwind_protect_var<DAEFunc::DAERHSFunc>
+    restore_fcn (user_fcn, DAEFunc::function ());
+  octave::unwind_protect_var<DAEFunc::DAEJacFunc>
+    restore_jac (user_jac, DAEFunc::jacobian_function ());
+  octave::unwind_protect_var<F77_INT>
+    restore_nn (nn, octave::to_f77_int (size ()));
+
   if (! m_initialized || m_restart || DAEFunc::m_reset
       || DASSL_options::m_reset)
     {
@@ -142,8 +154,6 @@ DASSL::do_integrate (double tout)
       m_liw = 21 + n;
       m_lrw = 40 + 9*n + n*n;
 
-      nn = n;
-
       m_iwork.resize (dim_vector (m_liw, 1));
       m_rwork.resize (dim_vector (m_lrw, 1));
 
@@ -161,9 +171,6 @@ DASSL::do_integrate (double tout)
 
       // DAEFunc
 
-      user_fcn = DAEFunc::function ();
-      user_jac = DAEFunc::jacobian_function ();
-
       if (user_fcn)
         {
           octave_idx_type ires = 0;
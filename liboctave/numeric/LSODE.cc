@@ -28,12 +28,15 @@
 #endif
 
 #include <cinttypes>
+#include <cstddef>
+#include <cstring>
 #include <sstream>
 
 #include "LSODE.h"
 #include "f77-fcn.h"
 #include "lo-error.h"
 #include "quit.h"
+#include "unwind-prot.h"
 
 typedef F77_INT (*lsode_fcn_ptr) (const F77_INT&, const double&, double *,
                                   double *, F77_INT&);
@@ -50,12 +53,75 @@ extern "C"
                              F77_INT&, F77_INT&, F77_INT&, F77_DBLE *,
                              F77_INT&, F77_INT *, F77_INT&, lsode_jac_ptr,
                              F77_INT&);
+
+  // The COMMON block /DLS001/ that holds the internal state of DLSODE
+  // between calls (see Part 3 of the documentation in dlsode.f).
+
+  extern struct
+  {
+    F77_DBLE rowns[209];
+    F77_DBLE ccmax, el0, h, hmin, hmxi, hu, rc, tn, uround;
+    F77_INT iownd[6], iowns[6];
+    F77_INT icf, ierpj, iersl, jcur, jstart, kflag, l, lyh, lewt, lacor,
+      lsavf, lwm, liwm, meth, miter, maxord, maxcor, msbp, mxncf, n, nq,
+      nst, nfe, nje, nqu;
+  } F77_FUNC (dls001, DLS001);
 }
 
+// Size of the COMMON block, which may be smaller than the structure
+// because of padding at its end, and the number of doubles needed to
+// store a copy of it.
+static const std::size_t lsode_common_size
+  = offsetof (decltype (F77_FUNC (dls001, DLS001)), nqu) + sizeof (F77_INT);
+static const octave_idx_type lsode_common_len
+  = (lsode_common_size + sizeof (double) - 1) / sizeof (double);
+
 static ODEFunc::ODERHSFunc user_fcn;
 static ODEFunc::ODEJacFunc user_jac;
 static ColumnVector *tmp_x;
 static bool user_jac_ignore_ml_mu;
+static F77_INT nn = 0;
+
+// Make the state of DLSODE saved in COMMON current for the duration of
+// a call to DLSODE, and save it back afterwards.  The state that was
+// current before is restored, also if the user function throws.  This
+// allows the user function to integrate another LSODE object.
+
+class lsode_common_guard
+{
+public:
+
+  lsode_common_guard (Array<double>& common)
+    : m_common (common), m_outer_common (dim_vector (lsode_common_len, 1))
+  {
+    std::memcpy (m_outer_common.rwdata (), &F77_FUNC (dls001, DLS001),
+                 lsode_common_size);
+
+    // There is no saved state before the first call.
+    if (m_common.numel () == lsode_common_len)
+      std::memcpy (&F77_FUNC (dls001, DLS001), m_common.data (),
+                   lsode_common_size);
+    else
+      m_common.resize (dim_vector (lsode_common_len, 1));
+  }
+
+  OCTAVE_DISABLE_COPY_MOVE (lsode_common_guard)
+
+  ~lsode_common_guard ()
+  {
+    std::memcpy (m_common.rwdata (), &F77_FUNC (dls001, DLS001),
+                 lsode_common_size);
+
+    std::memcpy (&F77_FUNC (dls001, DLS001), m_outer_common.data (),
+                 lsode_common_size);
+  }
+
+private:
+
+  Array<double>& m_common;
+
+  Array<double> m_outer_common;
+};
 
 static F77_INT
 lsode_f (const F77_INT& neq, const double& time, double *, double *deriv,
@@ -112,7 +178,25 @@ LSODE::do_integrate (double tout)
 {
   ColumnVector retval;
 
-  static F77_INT nn = 0;
+  // Make the state and the user functions of this object current.
+  // They are restored when this function returns, so that the user
+  // functions may integrate other LSODE objects.
+
+  lsode_common_guard restore_common (m_common);
+
+  // NOTE: this won't work if LSODE passes copies of the state vector.
+  //       In that case we have to create a temporary vector object
+  //       and copy.
+
+  octave::unwind_protect_var<ColumnVector *> restore_x (tmp_x, &m_x);
+  octave::unwind_protect_var<ODEFunc::ODERHSFunc>
+    restore_fcn (user_fcn, function ());
+  octave::unwind_protect_var<ODEFunc::ODEJacFunc>
+    restore_jac (user_jac, jacobian_function ());
+  octave::unwind_protect_var<bool>
+    restore_ignore_ml_mu (user_jac_ignore_ml_mu);
+  octave::unwind_protect_var<F77_INT>
+    restore_nn (nn, octave::to_f77_int (size ()));
 
   if (! m_initialized || m_restart || ODEFunc::m_reset
       || LSODE_options::m_reset)
@@ -125,12 +209,8 @@ LSODE::do_integrate (double tout)
 
       F77_INT n = octave::to_f77_int (size ());
 
-      nn = n;
-
       octave_idx_type max_maxord = 0;
 
-      user_jac_ignore_ml_mu = true;
-
       m_iwork = Array<octave_f77_int_type> (dim_vector (2, 1));
 
       m_iwork(0) = lower_jacobian_subdiagonals ();  // 'ML' in dlsode.f
@@ -144,10 +224,7 @@ LSODE::do_integrate (double tout)
           if (m_jac)
             {
               if (jacobian_type () == "banded")
-                {
-                  m_method_flag = 24;
-                  user_jac_ignore_ml_mu = false;
-                }
+                m_method_flag = 24;
               else
                 m_method_flag = 21;
             }
@@ -226,15 +303,6 @@ LSODE::do_integrate (double tout)
 
       // ODEFunc
 
-      // NOTE: this won't work if LSODE passes copies of the state vector.
-      //       In that case we have to create a temporary vector object
-      //       and copy.
-
-      tmp_x = &m_x;
-
-      user_fcn = function ();
-      user_jac = jacobian_function ();
-
       ColumnVector m_xdot = (*user_fcn) (m_x, m_t);
 
       if (m_x.numel () != m_xdot.numel ())
@@ -301,6 +369,8 @@ LSODE::do_integrate (double tout)
       LSODE_options::m_reset = false;
     }
 
+  user_jac_ignore_ml_mu = (m_method_flag != 24);
+
   double *px = m_x.rwdata ();
 
   double *pabs_tol = m_abs_tol.rwdata ();
@@ -40,12 +40,13 @@ public:
   LSODE ()
     : ODE (), LSODE_options (), m_initialized (false), m_method_flag (0),
       m_itask (0), m_iopt (0), m_itol (0), m_liw (0), m_lrw (0),
-      m_iwork (), m_rwork (), m_rel_tol (0.0), m_abs_tol () { }
+      m_iwork (), m_rwork (), m_rel_tol (0.0), m_abs_tol (), m_common () { }
 
   LSODE (const ColumnVector& s, double tm, const ODEFunc& f)
     : ODE (s, tm, f), LSODE_options (), m_initialized (false),
       m_method_flag (0), m_itask (0), m_iopt (0), m_itol (0), m_liw (0),
-      m_lrw (0), m_iwork (), m_rwork (), m_rel_tol (0.0), m_abs_tol () { }
+      m_lrw (0), m_iwork (), m_rwork (), m_rel_tol (0.0), m_abs_tol (),
+      m_common () { }
 
   OCTAVE_DEFAULT_COPY_MOVE_DELETE (LSODE)
 
@@ -75,6 +76,11 @@ private:
   double m_rel_tol;
 
   Array<double> m_abs_tol;
+
+  // Copy of the internal state that DLSODE keeps in a COMMON block
+  // between calls, so that several LSODE objects may be integrated
+  // alternately or recursively.
+  Array<double> m_common;
 };
 
 #endif
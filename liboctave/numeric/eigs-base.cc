@@ -27,9 +27,19 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <cmath>
-
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <ostream>
+#include <utility>
+#include <vector>
+
+#if defined (HAVE_OMP_H)
+#  include <omp.h>
+#endif
 
 #include "Array.h"
 #include "CSparse.h"
@@ -42,9 +52,11 @@
 #include "lo-blas-proto.h"
 #include "lo-error.h"
 #include "lo-ieee.h"
+#include "lo-mappers.h"
 #include "lu.h"
 #include "mx-ops.h"
 #include "oct-locbuf.h"
+#include "oct-parallel.h"
 #include "oct-rand.h"
 #include "sparse-chol.h"
 #include "sparse-lu.h"
@@ -343,6 +355,319 @@ vector_product (const ComplexMatrix& m, const Complex *x, Complex *y)
   return true;
 }
 
+// Products with A are most of the work for large sparse problems.  The
+// compressed-column product above scatters into Y, so it cannot be
+// split among threads.  For large matrices, keep the transpose instead
+// and compute each element of Y as the dot product of one of its
+// columns with X.  The terms are added in the same order as in the
+// scatter, so the result does not depend on the number of threads.
+// Without threads, the transpose would only cost time and memory, so it
+// is not formed.
+
+static bool
+eigs_have_threads ()
+{
+#if defined (HAVE_OPENMP) && defined (HAVE_OMP_H)
+  return omp_get_max_threads () > 1;
+#else
+  return false;
+#endif
+}
+
+template <typename M>
+class eigs_matvec
+{
+public:
+
+  eigs_matvec (const M& m, bool /* repeated */) : m_m (m) { }
+
+  template <typename T>
+  bool operator () (const T *x, T *y) const
+  {
+    return vector_product (m_m, x, y);
+  }
+
+private:
+
+  const M& m_m;
+};
+
+template <typename SM>
+class eigs_sparse_matvec
+{
+public:
+
+  typedef typename SM::element_type T;
+
+  // Smallest number of nonzero elements for which the transpose is kept.
+  static const octave_idx_type min_nnz = 65536;
+
+  eigs_sparse_matvec (const SM& m, bool repeated)
+    : m_m (m), m_mt (),
+      m_use_rows (repeated && m.nnz () >= min_nnz && eigs_have_threads ())
+  {
+    if (m_use_rows)
+      m_mt = m.transpose ();
+  }
+
+  bool operator () (const T *x, T *y) const
+  {
+    if (! m_use_rows)
+      return vector_product (m_m, x, y);
+
+    octave_idx_type nr = m_mt.cols ();
+
+    // Aim for a few thousand nonzero elements per chunk.
+    double nz_per_row = static_cast<double> (m_mt.nnz ()) / nr;
+    octave_idx_type grain
+      = std::max (static_cast<octave_idx_type> (4096 / nz_per_row),
+                  static_cast<octave_idx_type> (1));
+
+    const octave_idx_type *cidx = m_mt.cidx ();
+    const octave_idx_type *ridx = m_mt.ridx ();
+    const T *data = m_mt.data ();
+
+    octave::parallel_for (nr, grain,
+                          [=] (octave_idx_type lo, octave_idx_type hi)
+    {
+      for (octave_idx_type i = lo; i < hi; i++)
+        {
+          T tmp = 0.;
+          for (octave_idx_type k = cidx[i]; k < cidx[i+1]; k++)
+            tmp += data[k] * x[ridx[k]];
+          y[i] = tmp;
+        }
+    });
+
+    return true;
+  }
+
+private:
+
+  const SM& m_m;
+
+  // Transpose of M, if it is used.
+  SM m_mt;
+
+  bool m_use_rows;
+};
+
+template <>
+class eigs_matvec<SparseMatrix> : public eigs_sparse_matvec<SparseMatrix>
+{
+public:
+
+  eigs_matvec (const SparseMatrix& m, bool repeated)
+    : eigs_sparse_matvec<SparseMatrix> (m, repeated)
+  { }
+};
+
+template <>
+class eigs_matvec<SparseComplexMatrix>
+  : public eigs_sparse_matvec<SparseComplexMatrix>
+{
+public:
+
+  eigs_matvec (const SparseComplexMatrix& m, bool repeated)
+    : eigs_sparse_matvec<SparseComplexMatrix> (m, repeated)
+  { }
+};
+
+// Pool of ARPACK work arrays.  Programs often call eigs repeatedly for
+// problems of the same size, for example while following eigenvalues
+// along a parameter, so the arrays of a finished call are kept and
+// handed to the next call instead of being allocated again.  Each array
+// is owned by one call at a time, so nested calls from user-supplied
+// functions, and calls from other threads, never share storage.
+//
+// At most MAX_ARRAYS arrays of at most MAX_BYTES bytes in total are
+// kept for each element type.  When an array is returned to a full
+// pool, the arrays that were returned longest ago are freed to make
+// room for it.  Arrays larger than MAX_BYTES are never kept, so the
+// pool only helps problems of moderate size: the basis of N*NCV
+// elements exceeds 16 MiB for real problems with N*NCV above about two
+// million (for example, N = 200000 and NCV = 20), and is then allocated
+// by every call.
+// For such problems the products with A usually dominate the cost of
+// the allocation.  eigs_free_workspaces frees all kept arrays.
+
+template <typename T>
+class eigs_workspace
+{
+public:
+
+  static const std::size_t max_arrays = 8;
+  static const std::size_t max_bytes = 16 << 20;
+
+  eigs_workspace (octave_idx_type n)
+    : m_size (n), m_data ()
+  {
+    pool_type& pool = get_pool ();
+
+    {
+      std::lock_guard<std::mutex> lock (pool.mutex);
+
+      // Take the smallest cached array that is large enough.
+      auto best = pool.free.end ();
+      for (auto it = pool.free.begin (); it != pool.free.end (); it++)
+        if (it->first >= n
+            && (best == pool.free.end () || it->first < best->first))
+          best = it;
+
+      if (best != pool.free.end ())
+        {
+          m_size = best->first;
+          m_data = std::move (best->second);
+          pool.free.erase (best);
+          pool.bytes -= m_size * sizeof (T);
+        }
+    }
+
+    if (! m_data)
+      m_data.reset (new T [n]);
+  }
+
+  OCTAVE_DISABLE_COPY_MOVE (eigs_workspace)
+
+  ~eigs_workspace ()
+  {
+    std::size_t nbytes = m_size * sizeof (T);
+
+    if (nbytes > max_bytes)
+      return;
+
+    pool_type& pool = get_pool ();
+
+    // Arrays that are evicted are freed after the lock is released.
+    array_list evicted;
+
+    {
+      std::lock_guard<std::mutex> lock (pool.mutex);
+
+      // The oldest arrays are at the front.
+      auto keep = pool.free.begin ();
+      while (keep != pool.free.end ()
+             && (pool.free.end () - keep >= static_cast<std::ptrdiff_t> (max_arrays)
+                 || pool.bytes + nbytes > max_bytes))
+        {
+          pool.bytes -= keep->first * sizeof (T);
+          keep++;
+        }
+
+      evicted.assign (std::make_move_iterator (pool.free.begin ()),
+                      std::make_move_iterator (keep));
+      pool.free.erase (pool.free.begin (), keep);
+
+      pool.free.emplace_back (m_size, std::move (m_data));
+      pool.bytes += nbytes;
+    }
+  }
+
+  T * data () { return m_data.get (); }
+
+  // Free all kept arrays.
+
+  static void clear ()
+  {
+    pool_type& pool = get_pool ();
+
+    array_list evicted;
+
+    {
+      std::lock_guard<std::mutex> lock (pool.mutex);
+
+      evicted.swap (pool.free);
+      pool.bytes = 0;
+    }
+  }
+
+private:
+
+  typedef std::vector<std::pair<octave_idx_type, std::unique_ptr<T[]>>>
+    array_list;
+
+  struct pool_type
+  {
+    std::mutex mutex;
+    array_list free;
+    std::size_t bytes = 0;
+  };
+
+  static pool_type& get_pool ()
+  {
+    static pool_type pool;
+    return pool;
+  }
+
+  octave_idx_type m_size;
+
+  std::unique_ptr<T[]> m_data;
+};
+
+void
+eigs_free_workspaces ()
+{
+  eigs_workspace<double>::clear ();
+  eigs_workspace<Complex>::clear ();
+}
+
+// Combine the columns of V0 into a single starting vector.  ARPACK
+// takes just one, so a basis of a previously computed invariant
+// subspace is summed after scaling each column to unit length.  This
+// keeps the starting vector in the span of V0 without letting any one
+// column dominate.
+
+template <typename CV, typename M>
+static CV
+starting_vector (const M& v0)
+{
+  octave_idx_type nr = v0.rows ();
+  octave_idx_type nc = v0.cols ();
+
+  if (nr == 1 || nc == 1)
+    return CV (v0.as_column ());
+
+  CV retval (nr, 0.);
+
+  for (octave_idx_type j = 0; j < nc; j++)
+    {
+      double nrm = 0.;
+      for (octave_idx_type i = 0; i < nr; i++)
+        nrm += std::norm (v0(i, j));
+
+      if (nrm == 0 || ! octave::math::isfinite (nrm))
+        continue;
+
+      nrm = std::sqrt (nrm);
+      for (octave_idx_type i = 0; i < nr; i++)
+        retval(i) += v0(i, j) / nrm;
+    }
+
+  // ARPACK fails with a zero starting vector.  This happens if no
+  // column is nonzero and finite, or if the columns cancel.
+  double nrm = 0.;
+  for (octave_idx_type i = 0; i < nr; i++)
+    nrm += std::norm (retval(i));
+
+  if (nrm == 0 || ! octave::math::isfinite (nrm))
+    (*current_liboctave_error_handler)
+      ("eigs: the columns of opts.v0 must add up to a nonzero, finite vector");
+
+  return retval;
+}
+
+ColumnVector
+eigs_starting_vector (const Matrix& v0)
+{
+  return starting_vector<ColumnVector> (v0);
+}
+
+ComplexColumnVector
+eigs_starting_vector (const ComplexMatrix& v0)
+{
+  return starting_vector<ComplexColumnVector> (v0);
+}
+
 static bool
 make_cholb (Matrix& b, Matrix& bt, ColumnVector& permB)
 {
@@ -816,7 +1141,7 @@ EigsRealSymmetricMatrix (const M& m, const std::string typ,
       octave::rand::distribution (rand_dist);
     }
   else if (m.cols () != resid.numel ())
-    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1");
+    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1 or n-by-j");
 
   if (n < 3)
     (*current_liboctave_error_handler) ("eigs: n must be at least 3");
@@ -914,10 +1239,14 @@ EigsRealSymmetricMatrix (const M& m, const std::string typ,
   int iter = 0;
   F77_INT lwork = p * (p + 8);
 
-  OCTAVE_LOCAL_BUFFER (double, v, n * p);
-  OCTAVE_LOCAL_BUFFER (double, workl, lwork);
-  OCTAVE_LOCAL_BUFFER (double, workd, 3 * n);
+  eigs_workspace<double> v_ws (n * p);
+  double *v = v_ws.data ();
+  eigs_workspace<double> workl_ws (lwork);
+  double *workl = workl_ws.data ();
+  eigs_workspace<double> workd_ws (3 * n);
+  double *workd = workd_ws.data ();
   double *presid = resid.rwdata ();
+  eigs_matvec<M> matvec (m, ! have_b);
 
   do
     {
@@ -974,8 +1303,7 @@ EigsRealSymmetricMatrix (const M& m, const std::string typ,
               for (F77_INT i = 0; i < n; i++)
                 workd[i+iptr(1)-1] = mtmp(i, 0);
             }
-          else if (! vector_product (m, workd + iptr(0) - 1,
-                                     workd + iptr(1) - 1))
+          else if (! matvec (workd + iptr(0) - 1, workd + iptr(1) - 1))
             break;
         }
       else
@@ -1111,7 +1439,7 @@ EigsRealSymmetricMatrixShift (const M& m, double sigma,
       octave::rand::distribution (rand_dist);
     }
   else if (m.cols () != resid.numel ())
-    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1");
+    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1 or n-by-j");
 
   if (n < 3)
     (*current_liboctave_error_handler) ("eigs: n must be at least 3");
@@ -1190,9 +1518,12 @@ EigsRealSymmetricMatrixShift (const M& m, double sigma,
 
   F77_INT lwork = p * (p + 8);
 
-  OCTAVE_LOCAL_BUFFER (double, v, n * p);
-  OCTAVE_LOCAL_BUFFER (double, workl, lwork);
-  OCTAVE_LOCAL_BUFFER (double, workd, 3 * n);
+  eigs_workspace<double> v_ws (n * p);
+  double *v = v_ws.data ();
+  eigs_workspace<double> workl_ws (lwork);
+  double *workl = workl_ws.data ();
+  eigs_workspace<double> workd_ws (3 * n);
+  double *workd = workd_ws.data ();
   double *presid = resid.rwdata ();
 
   do
@@ -1408,7 +1739,7 @@ EigsRealSymmetricFunc (EigsFunc fcn, octave_idx_type n_arg,
       octave::rand::distribution (rand_dist);
     }
   else if (n != resid.numel ())
-    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1");
+    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1 or n-by-j");
 
   if (n < 3)
     (*current_liboctave_error_handler) ("eigs: n must be at least 3");
@@ -1534,9 +1865,12 @@ EigsRealSymmetricFunc (EigsFunc fcn, octave_idx_type n_arg,
   int iter = 0;
   F77_INT lwork = p * (p + 8);
 
-  OCTAVE_LOCAL_BUFFER (double, v, n * p);
-  OCTAVE_LOCAL_BUFFER (double, workl, lwork);
-  OCTAVE_LOCAL_BUFFER (double, workd, 3 * n);
+  eigs_workspace<double> v_ws (n * p);
+  double *v = v_ws.data ();
+  eigs_workspace<double> workl_ws (lwork);
+  double *workl = workl_ws.data ();
+  eigs_workspace<double> workd_ws (3 * n);
+  double *workd = workd_ws.data ();
   double *presid = resid.rwdata ();
 
   do
@@ -1793,7 +2127,7 @@ EigsRealNonSymmetricMatrix (const M& m, const std::string typ,
       octave::rand::distribution (rand_dist);
     }
   else if (m.cols () != resid.numel ())
-    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1");
+    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1 or n-by-j");
 
   if (n < 3)
     (*current_liboctave_error_handler) ("eigs: n must be at least 3");
@@ -1891,10 +2225,14 @@ EigsRealNonSymmetricMatrix (const M& m, const std::string typ,
   int iter = 0;
   F77_INT lwork = 3 * p * (p + 2);
 
-  OCTAVE_LOCAL_BUFFER (double, v, n * (p + 1));
-  OCTAVE_LOCAL_BUFFER (double, workl, lwork + 1);
-  OCTAVE_LOCAL_BUFFER (double, workd, 3 * n + 1);
+  eigs_workspace<double> v_ws (n * (p + 1));
+  double *v = v_ws.data ();
+  eigs_workspace<double> workl_ws (lwork + 1);
+  double *workl = workl_ws.data ();
+  eigs_workspace<double> workd_ws (3 * n + 1);
+  double *workd = workd_ws.data ();
   double *presid = resid.rwdata ();
+  eigs_matvec<M> matvec (m, ! have_b);
 
   do
     {
@@ -1955,8 +2293,7 @@ EigsRealNonSymmetricMatrix (const M& m, const std::string typ,
               for (F77_INT i = 0; i < n; i++)
                 workd[i+iptr(1)-1] = mtmp(i, 0);
             }
-          else if (! vector_product (m, workd + iptr(0) - 1,
-                                     workd + iptr(1) - 1))
+          else if (! matvec (workd + iptr(0) - 1, workd + iptr(1) - 1))
             break;
         }
       else
@@ -2148,7 +2485,7 @@ EigsRealNonSymmetricMatrixShift (const M& m, double sigmar,
       octave::rand::distribution (rand_dist);
     }
   else if (m.cols () != resid.numel ())
-    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1");
+    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1 or n-by-j");
 
   if (n < 3)
     (*current_liboctave_error_handler) ("eigs: n must be at least 3");
@@ -2227,9 +2564,12 @@ EigsRealNonSymmetricMatrixShift (const M& m, double sigmar,
 
   F77_INT lwork = 3 * p * (p + 2);
 
-  OCTAVE_LOCAL_BUFFER (double, v, n * (p + 1));
-  OCTAVE_LOCAL_BUFFER (double, workl, lwork + 1);
-  OCTAVE_LOCAL_BUFFER (double, workd, 3 * n + 1);
+  eigs_workspace<double> v_ws (n * (p + 1));
+  double *v = v_ws.data ();
+  eigs_workspace<double> workl_ws (lwork + 1);
+  double *workl = workl_ws.data ();
+  eigs_workspace<double> workd_ws (3 * n + 1);
+  double *workd = workd_ws.data ();
   double *presid = resid.rwdata ();
 
   do
@@ -2513,7 +2853,7 @@ EigsRealNonSymmetricFunc (EigsFunc fcn, octave_idx_type n_arg,
       octave::rand::distribution (rand_dist);
     }
   else if (n != resid.numel ())
-    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1");
+    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1 or n-by-j");
 
   if (n < 3)
     (*current_liboctave_error_handler) ("eigs: n must be at least 3");
@@ -2639,9 +2979,12 @@ EigsRealNonSymmetricFunc (EigsFunc fcn, octave_idx_type n_arg,
   int iter = 0;
   F77_INT lwork = 3 * p * (p + 2);
 
-  OCTAVE_LOCAL_BUFFER (double, v, n * (p + 1));
-  OCTAVE_LOCAL_BUFFER (double, workl, lwork + 1);
-  OCTAVE_LOCAL_BUFFER (double, workd, 3 * n + 1);
+  eigs_workspace<double> v_ws (n * (p + 1));
+  double *v = v_ws.data ();
+  eigs_workspace<double> workl_ws (lwork + 1);
+  double *workl = workl_ws.data ();
+  eigs_workspace<double> workd_ws (3 * n + 1);
+  double *workd = workd_ws.data ();
   double *presid = resid.rwdata ();
 
   do
@@ -2962,7 +3305,7 @@ EigsComplexNonSymmetricMatrix (const M& m, const std::string typ,
       octave::rand::distribution (rand_dist);
     }
   else if (m.cols () != cresid.numel ())
-    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1");
+    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1 or n-by-j");
 
   if (n < 3)
     (*current_liboctave_error_handler) ("eigs: n must be at least 3");
@@ -3060,11 +3403,15 @@ EigsComplexNonSymmetricMatrix (const M& m, const std::string typ,
   int iter = 0;
   F77_INT lwork = p * (3 * p + 5);
 
-  OCTAVE_LOCAL_BUFFER (Complex, v, n * p);
-  OCTAVE_LOCAL_BUFFER (Complex, workl, lwork);
-  OCTAVE_LOCAL_BUFFER (Complex, workd, 3 * n);
+  eigs_workspace<Complex> v_ws (n * p);
+  Complex *v = v_ws.data ();
+  eigs_workspace<Complex> workl_ws (lwork);
+  Complex *workl = workl_ws.data ();
+  eigs_workspace<Complex> workd_ws (3 * n);
+  Complex *workd = workd_ws.data ();
   OCTAVE_LOCAL_BUFFER (double, rwork, p);
   Complex *presid = cresid.rwdata ();
+  eigs_matvec<M> matvec (m, ! have_b);
 
   do
     {
@@ -3121,8 +3468,7 @@ EigsComplexNonSymmetricMatrix (const M& m, const std::string typ,
                 workd[i+iptr(1)-1] = mtmp(i, 0);
 
             }
-          else if (! vector_product (m, workd + iptr(0) - 1,
-                                     workd + iptr(1) - 1))
+          else if (! matvec (workd + iptr(0) - 1, workd + iptr(1) - 1))
             break;
         }
       else
@@ -3269,7 +3615,7 @@ EigsComplexNonSymmetricMatrixShift (const M& m, Complex sigma,
       octave::rand::distribution (rand_dist);
     }
   else if (m.cols () != cresid.numel ())
-    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1");
+    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1 or n-by-j");
 
   if (n < 3)
     (*current_liboctave_error_handler) ("eigs: n must be at least 3");
@@ -3348,9 +3694,12 @@ EigsComplexNonSymmetricMatrixShift (const M& m, Complex sigma,
 
   F77_INT lwork = p * (3 * p + 5);
 
-  OCTAVE_LOCAL_BUFFER (Complex, v, n * p);
-  OCTAVE_LOCAL_BUFFER (Complex, workl, lwork);
-  OCTAVE_LOCAL_BUFFER (Complex, workd, 3 * n);
+  eigs_workspace<Complex> v_ws (n * p);
+  Complex *v = v_ws.data ();
+  eigs_workspace<Complex> workl_ws (lwork);
+  Complex *workl = workl_ws.data ();
+  eigs_workspace<Complex> workd_ws (3 * n);
+  Complex *workd = workd_ws.data ();
   OCTAVE_LOCAL_BUFFER (double, rwork, p);
   Complex *presid = cresid.rwdata ();
 
@@ -3584,7 +3933,7 @@ EigsComplexNonSymmetricFunc (EigsComplexFunc fcn, octave_idx_type n_arg,
       octave::rand::distribution (rand_dist);
     }
   else if (n != cresid.numel ())
-    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1");
+    (*current_liboctave_error_handler) ("eigs: opts.v0 must be n-by-1 or n-by-j");
 
   if (n < 3)
     (*current_liboctave_error_handler) ("eigs: n must be at least 3");
@@ -3710,9 +4059,12 @@ EigsComplexNonSymmetricFunc (EigsComplexFunc fcn, octave_idx_type n_arg,
   int iter = 0;
   F77_INT lwork = p * (3 * p + 5);
 
-  OCTAVE_LOCAL_BUFFER (Complex, v, n * p);
-  OCTAVE_LOCAL_BUFFER (Complex, workl, lwork);
-  OCTAVE_LOCAL_BUFFER (Complex, workd, 3 * n);
+  eigs_workspace<Complex> v_ws (n * p);
+  Complex *v = v_ws.data ();
+  eigs_workspace<Complex> workl_ws (lwork);
+  Complex *workl = workl_ws.data ();
+  eigs_workspace<Complex> workd_ws (3 * n);
+  Complex *workd = workd_ws.data ();
   OCTAVE_LOCAL_BUFFER (double, rwork, p);
   Complex *presid = cresid.rwdata ();
 
@@ -42,6 +42,20 @@ typedef
 std::function<ComplexColumnVector
               (const ComplexColumnVector& x, int& eigs_error)> EigsComplexFunc;
 
+// Combine the columns of V0, for example eigenvectors or a Krylov basis
+// from a previous call, into a single starting vector for ARPACK.
+
+extern OCTAVE_API ColumnVector
+eigs_starting_vector (const Matrix& v0);
+
+extern OCTAVE_API ComplexColumnVector
+eigs_starting_vector (const ComplexMatrix& v0);
+
+// Free the ARPACK work arrays that are kept for reuse by later calls.
+
+extern OCTAVE_API void
+eigs_free_workspaces ();
+
 template <typename M>
 OCTAVE_API octave_idx_type
 EigsRealSymmetricMatrix (const M& m, const std::string typ,
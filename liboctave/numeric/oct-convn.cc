@@ -28,6 +28,8 @@
 #endif
 
 #include <algorithm>
+#include <cmath>
+#include <complex>
 
 #include "Array.h"
 #include "CColVector.h"
@@ -39,7 +41,6 @@
 #include "dMatrix.h"
 #include "dNDArray.h"
 #include "dRowVector.h"
-#include "f77-fcn.h"
 #include "fCColVector.h"
 #include "fCMatrix.h"
 #include "fCNDArray.h"
@@ -48,104 +49,400 @@
 #include "fMatrix.h"
 #include "fNDArray.h"
 #include "fRowVector.h"
+#include "lo-mappers.h"
 #include "oct-convn.h"
+#include "oct-fftw.h"
+#include "oct-locbuf.h"
+#include "oct-parallel.h"
+#include "quit.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
-// 2d convolution with a matrix kernel.
+// Minimum number of multiply-adds of the direct convolution that are
+// worth handing to a separate thread.
+static const double CONVN_MIN_THREAD_WORK = 65536;
+
+// Columns [J0, J1) of the 2d convolution of the MA x NA matrix A with
+// the MB x NB matrix B.  The result is added to C, which has MC rows
+// and holds the part of the full convolution that starts at row OI and
+// column OJ.  For each element of C, the terms are added in the same
+// order whatever part of the full convolution is computed.
+
 template <typename T, typename R>
 static void
-convolve_2d (const T *a, F77_INT ma, F77_INT na,
-             const R *b, F77_INT mb, F77_INT nb,
-             T *c, bool inner);
-
-// Forward instances to our Fortran implementations.
-#define FORWARD_IMPL(T_CXX, R_CXX, T, R, T_CAST, T_CONST_CAST,          \
-                     R_CONST_CAST, f, F)                                \
-  extern "C"                                                            \
-  F77_RET_T                                                             \
-  F77_FUNC (f##conv2o, F##CONV2O) (const F77_INT&, const F77_INT&,      \
-                                   const T*, const F77_INT&,            \
-                                   const F77_INT&, const R*, T *);      \
-                                                                        \
-  extern "C"                                                            \
-  F77_RET_T                                                             \
-  F77_FUNC (f##conv2i, F##CONV2I) (const F77_INT&, const F77_INT&,      \
-                                   const T*, const F77_INT&,            \
-                                   const F77_INT&, const R*, T *);      \
-                                                                        \
-  template <> void                                                      \
-  convolve_2d<T_CXX, R_CXX> (const T_CXX *a, F77_INT ma, F77_INT na,    \
-                             const R_CXX *b, F77_INT mb, F77_INT nb,    \
-                             T_CXX *c, bool inner)                      \
-  {                                                                     \
-    if (inner)                                                          \
-      F77_XFCN (f##conv2i, F##CONV2I, (ma, na, T_CONST_CAST (a),        \
-                                       mb, nb, R_CONST_CAST (b),        \
-                                       T_CAST (c)));                    \
-    else                                                                \
-      F77_XFCN (f##conv2o, F##CONV2O, (ma, na, T_CONST_CAST (a),        \
-                                       mb, nb, R_CONST_CAST (b),        \
-                                       T_CAST (c)));                    \
-  }
+convolve_2d_cols (const T *a, octave_idx_type ma, octave_idx_type na,
+                  const R *b, octave_idx_type mb, octave_idx_type nb,
+                  T *c, octave_idx_type mc,
+                  octave_idx_type oi, octave_idx_type oj,
+                  octave_idx_type j0, octave_idx_type j1)
+{
+  for (octave_idx_type j = j0; j < j1; j++)
+    {
+      T *cj = c + mc*j;
+
+      for (octave_idx_type jb = nb - 1; jb >= 0; jb--)
+        {
+          octave_idx_type ja = j + oj - jb;
+          if (ja < 0 || ja >= na)
+            continue;
+
+          const T *aj = a + ma*ja;
+          const R *bj = b + mb*jb;
 
-FORWARD_IMPL (double, double, F77_DBLE, F77_DBLE,,,, d, D)
-FORWARD_IMPL (float, float, F77_REAL, F77_REAL,,,, s, S)
+          for (octave_idx_type ib = 0; ib < mb; ib++)
+            {
+              // Rows of C for which the corresponding row of A exists.
+              octave_idx_type i0 = std::max (ib - oi,
+                                             static_cast<octave_idx_type> (0));
+              octave_idx_type i1 = std::min (ma + ib - oi, mc);
+              octave_idx_type ia = oi - ib;
+              R bij = bj[ib];
 
-FORWARD_IMPL (std::complex<double>, std::complex<double>,
-              F77_DBLE_CMPLX, F77_DBLE_CMPLX, F77_DBLE_CMPLX_ARG,
-              F77_CONST_DBLE_CMPLX_ARG, F77_CONST_DBLE_CMPLX_ARG, z, Z)
-FORWARD_IMPL (std::complex<float>, std::complex<float>,
-              F77_CMPLX, F77_CMPLX, F77_CMPLX_ARG,
-              F77_CONST_CMPLX_ARG, F77_CONST_CMPLX_ARG, c, C)
+              for (octave_idx_type i = i0; i < i1; i++)
+                cj[i] += aj[i + ia] * bij;
+            }
+        }
+    }
+}
 
-FORWARD_IMPL (std::complex<double>, double,
-              F77_DBLE_CMPLX, F77_DBLE, F77_DBLE_CMPLX_ARG,
-              F77_CONST_DBLE_CMPLX_ARG,, zd, ZD)
-FORWARD_IMPL (std::complex<float>, float, F77_CMPLX, F77_REAL, F77_CMPLX_ARG,
-              F77_CONST_CMPLX_ARG,, cs, CS)
+// 2d convolution.  The columns of the MC x NC result are independent,
+// so they are distributed among threads.
 
 template <typename T, typename R>
-void convolve_nd (const T *a, const dim_vector& ad, const dim_vector& acd,
-                  const R *b, const dim_vector& bd, const dim_vector& bcd,
-                  T *c, const dim_vector& ccd, int nd, bool inner)
+static void
+convolve_2d (const T *a, octave_idx_type ma, octave_idx_type na,
+             const R *b, octave_idx_type mb, octave_idx_type nb,
+             T *c, octave_idx_type mc, octave_idx_type nc,
+             octave_idx_type oi, octave_idx_type oj)
 {
-  if (nd == 2)
+  double col_work = static_cast<double> (mc) * mb * nb;
+  octave_idx_type grain
+    = static_cast<octave_idx_type> (CONVN_MIN_THREAD_WORK
+                                    / std::max (col_work, 1.0)) + 1;
+
+  parallel_for (nc, grain, [=] (octave_idx_type lo, octave_idx_type hi)
     {
-      F77_INT ad0 = to_f77_int (ad(0));
-      F77_INT ad1 = to_f77_int (ad(1));
+      convolve_2d_cols<T, R> (a, ma, na, b, mb, nb, c, mc, oi, oj, lo, hi);
+    });
+}
 
-      F77_INT bd0 = to_f77_int (bd(0));
-      F77_INT bd1 = to_f77_int (bd(1));
+// N-d convolution, computing the part of the full convolution that
+// starts at the offsets OFF.
 
-      convolve_2d<T, R> (a, ad0, ad1, b, bd0, bd1, c, inner);
-    }
+template <typename T, typename R>
+void convolve_nd (const T *a, const dim_vector& ad, const dim_vector& acd,
+                  const R *b, const dim_vector& bd, const dim_vector& bcd,
+                  T *c, const dim_vector& cd, const dim_vector& ccd,
+                  const octave_idx_type *off, int nd)
+{
+  if (nd == 2)
+    convolve_2d<T, R> (a, ad(0), ad(1), b, bd(0), bd(1),
+                       c, cd(0), cd(1), off[0], off[1]);
   else
     {
       octave_idx_type ma = acd(nd-2);
       octave_idx_type na = ad(nd-1);
       octave_idx_type mb = bcd(nd-2);
       octave_idx_type nb = bd(nd-1);
-      octave_idx_type ldc = ccd(nd-2);
+      octave_idx_type mc = ccd(nd-2);
+      octave_idx_type nc = cd(nd-1);
+
+      for (octave_idx_type jc = 0; jc < nc; jc++)
+        for (octave_idx_type jb = nb - 1; jb >= 0; jb--)
+          {
+            octave_idx_type ja = jc + off[nd-1] - jb;
+            if (ja >= 0 && ja < na)
+              convolve_nd<T, R> (a + ma*ja, ad, acd, b + mb*jb, bd, bcd,
+                                 c + mc*jc, cd, ccd, off, nd-1);
+          }
+    }
+}
+
+#if defined (HAVE_FFTW)
+
+// Minimum number of flops of the direct convolution for which the
+// FFT methods are considered.  Below this, the direct method is fast
+// anyway and its results are not affected by FFT round-off.
+static const double CONVN_MIN_FFT_WORK = 1e7;
+
+// Complex type used for the FFT of an array of type T.
+
+template <typename T>
+struct convn_fft_type
+{
+  typedef std::complex<T> type;
+};
+
+template <typename T>
+struct convn_fft_type<std::complex<T>>
+{
+  typedef std::complex<T> type;
+};
+
+static inline void
+convn_add (double& c, const Complex& z)
+{
+  c += z.real ();
+}
+
+static inline void
+convn_add (float& c, const FloatComplex& z)
+{
+  c += z.real ();
+}
+
+static inline void
+convn_add (Complex& c, const Complex& z)
+{
+  c += z;
+}
+
+static inline void
+convn_add (FloatComplex& c, const FloatComplex& z)
+{
+  c += z;
+}
+
+template <typename T>
+static bool
+convn_all_finite (const MArray<T>& x)
+{
+  return std::all_of (x.data (), x.data () + x.numel (),
+                      [] (const T& v) { return math::isfinite (v); });
+}
+
+template <typename T>
+static inline bool
+convn_is_integer (T x)
+{
+  return math::x_nint (x) == x;
+}
+
+template <typename T>
+static inline bool
+convn_is_integer (const std::complex<T>& x)
+{
+  return convn_is_integer (x.real ()) && convn_is_integer (x.imag ());
+}
+
+template <typename T>
+static bool
+convn_all_integer (const MArray<T>& x)
+{
+  return std::all_of (x.data (), x.data () + x.numel (),
+                      [] (const T& v) { return convn_is_integer (v); });
+}
+
+// Smallest length >= N that has no prime factors other than 2, 3, 5,
+// and 7, for which FFTW is fast.
+
+static octave_idx_type
+convn_fft_size (octave_idx_type n)
+{
+  for (octave_idx_type m = std::max (n, static_cast<octave_idx_type> (1));
+       ; m++)
+    {
+      octave_idx_type k = m;
+      for (int p : {2, 3, 5, 7})
+        while (k % p == 0)
+          k /= p;
+
+      if (k == 1)
+        return m;
+    }
+}
+
+// Rough number of flops of an FFT of N points.
+
+static double
+convn_fft_work (double n)
+{
+  return 5 * n * std::log2 (std::max (n, 2.0));
+}
+
+// Choose between the direct method and the FFT methods from rough
+// operation counts.  Return true if an FFT method is cheaper.  In that
+// case, A is split into blocks of BLKLEN slices along dimension DIM
+// (overlap-add).  If BLKLEN is at least ADIMS(DIM), the convolution is
+// done with a single FFT of the whole arrays.
 
-      if (inner)
+static bool
+convn_choose_fft (const dim_vector& adims, const dim_vector& bdims,
+                  const dim_vector& cdims, int nd, convn_type ct,
+                  int& dim, octave_idx_type& blklen)
+{
+  // Multiply-adds of the direct method.
+  double direct = 2.0 * (ct == convn_valid ? cdims.numel ()
+                         : adims.numel ()) * bdims.numel ();
+
+  if (direct < CONVN_MIN_FFT_WORK)
+    return false;
+
+  // Single FFT: transforms of A and B, their product, and the inverse
+  // transform.
+  double nfull = 1;
+  for (int i = 0; i < nd; i++)
+    nfull *= convn_fft_size (adims(i) + bdims(i) - 1);
+
+  double best = 3 * convn_fft_work (nfull) + 6 * nfull;
+  dim = 0;
+  blklen = adims(0);
+
+  // Overlap-add: split A along the dimension in which it is largest
+  // compared to B, and try blocks of increasing length.
+  int d = 0;
+  for (int i = 1; i < nd; i++)
+    if (static_cast<double> (adims(i)) / bdims(i)
+        > static_cast<double> (adims(d)) / bdims(d))
+      d = i;
+
+  octave_idx_type nfull_d = convn_fft_size (adims(d) + bdims(d) - 1);
+  double nrest = nfull / nfull_d;
+
+  for (octave_idx_type nfft = convn_fft_size (2 * bdims(d));
+       nfft < nfull_d; nfft = convn_fft_size (2 * nfft))
+    {
+      octave_idx_type len = nfft - bdims(d) + 1;
+      double nblk = std::ceil (static_cast<double> (adims(d)) / len);
+      double nblkfft = nrest * nfft;
+      double work = (convn_fft_work (nblkfft)
+                     + nblk * (2 * convn_fft_work (nblkfft) + 6 * nblkfft));
+
+      if (work < best)
+        {
+          best = work;
+          dim = d;
+          blklen = len;
+        }
+    }
+
+  return best < direct;
+}
+
+// Add the block Z of the full convolution to C.  Z has dimensions
+// ZDIMS, of which the leading ZLEN elements along each dimension are
+// meaningful, and starts at index K0 along dimension DIM of the full
+// convolution.  C holds the part of the full convolution that starts
+// at the offsets OFF.
+
+template <typename T, typename CT>
+static void
+convn_add_block (T *c, const dim_vector& cdims, const CT *z,
+                 const dim_vector& zdims, const dim_vector& zlen,
+                 const octave_idx_type *off, int dim, octave_idx_type k0,
+                 int nd)
+{
+  const dim_vector ccd = cdims.cumulative ();
+
+  // Rows of Z that end up in C.
+  octave_idx_type s0 = (dim == 0 ? k0 : 0) - off[0];
+  octave_idx_type r0 = std::max (-s0, static_cast<octave_idx_type> (0));
+  octave_idx_type r1 = std::min (zlen(0), cdims(0) - s0);
+
+  if (r0 >= r1)
+    return;
+
+  // Index of the current column of Z.
+  OCTAVE_LOCAL_BUFFER_INIT (octave_idx_type, zi, nd, 0);
+
+  octave_idx_type nzcols = zdims.numel () / zdims(0);
+
+  for (octave_idx_type col = 0; col < nzcols; col++)
+    {
+      bool inside = true;
+      octave_idx_type cpos = s0;
+
+      for (int i = 1; i < nd && inside; i++)
+        {
+          octave_idx_type ci = zi[i] + (i == dim ? k0 : 0) - off[i];
+          if (zi[i] >= zlen(i) || ci < 0 || ci >= cdims(i))
+            inside = false;
+          else
+            cpos += ci * ccd(i-1);
+        }
+
+      if (inside)
+        {
+          const CT *zc = z + col * zdims(0);
+          for (octave_idx_type r = r0; r < r1; r++)
+            convn_add (c[cpos + r], zc[r]);
+        }
+
+      for (int i = 1; i < nd; i++)
         {
-          for (octave_idx_type ja = 0; ja < na - nb + 1; ja++)
-            for (octave_idx_type jb = 0; jb < nb; jb++)
-              convolve_nd<T, R> (a + ma*(ja+jb), ad, acd,
-                                 b + mb*(nb-jb-1), bd, bcd,
-                                 c + ldc*ja, ccd, nd-1, inner);
+          if (++zi[i] < zdims(i))
+            break;
+          zi[i] = 0;
         }
+    }
+}
+
+// Convolution by FFT.  A is split into blocks of BLKLEN slices along
+// dimension DIM, and the convolutions of the blocks with B are added
+// up (overlap-add).  The FFT of B is computed only once.
+
+template <typename T, typename R>
+static void
+convolve_fft (const MArray<T>& a, const dim_vector& adims,
+              const MArray<R>& b, const dim_vector& bdims,
+              MArray<T>& c, const dim_vector& cdims,
+              const octave_idx_type *off, int nd,
+              int dim, octave_idx_type blklen)
+{
+  typedef typename convn_fft_type<T>::type CT;
+
+  octave_idx_type na = adims(dim);
+  blklen = std::min (blklen, na);
+
+  dim_vector fdims = dim_vector::alloc (nd);
+  dim_vector zlen = dim_vector::alloc (nd);
+  for (int i = 0; i < nd; i++)
+    {
+      zlen(i) = (i == dim ? blklen : adims(i)) + bdims(i) - 1;
+      fdims(i) = convn_fft_size (zlen(i));
+    }
+
+  octave_idx_type nf = fdims.numel ();
+
+  Array<CT> fb (fdims);
+  {
+    MArray<R> bp (b);
+    bp.resize (fdims, R ());
+    fftw::fftNd (bp.data (), fb.rwdata (), nd, fdims);
+  }
+
+  Array<CT> fa (fdims);
+  Array<idx_vector> sidx (dim_vector (nd, 1), idx_vector::colon);
+
+  for (octave_idx_type k0 = 0; k0 < na; k0 += blklen)
+    {
+      octave_quit ();
+
+      MArray<T> ap;
+      if (blklen == na)
+        ap = a;
       else
         {
-          for (octave_idx_type ja = 0; ja < na; ja++)
-            for (octave_idx_type jb = 0; jb < nb; jb++)
-              convolve_nd<T, R> (a + ma*ja, ad, acd, b + mb*jb, bd, bcd,
-                                 c + ldc*(ja+jb), ccd, nd-1, inner);
+          sidx(dim) = idx_vector::make_range (k0, 1,
+                                              std::min (blklen, na - k0));
+          ap = a.index (sidx);
         }
+      ap.resize (fdims, T ());
+
+      CT *pa = fa.rwdata ();
+      const CT *pb = fb.data ();
+
+      fftw::fftNd (ap.data (), pa, nd, fdims);
+      for (octave_idx_type i = 0; i < nf; i++)
+        pa[i] *= pb[i];
+      fftw::ifftNd (pa, pa, nd, fdims);
+
+      convn_add_block (c.rwdata (), cdims, pa, fdims, zlen, off, dim, k0, nd);
     }
 }
 
+#endif
+
 // Arbitrary convolutor.
 // The 2nd array is assumed to be the smaller one.
 template <typename T, typename R>
@@ -161,37 +458,55 @@ convolve (const MArray<T>& a, const MArray<R>& b,
   const dim_vector bdims = b.dims ().redim (nd);
   dim_vector cdims = dim_vector::alloc (nd);
 
+  // The result is the part of the full convolution that starts at OFF.
+  OCTAVE_LOCAL_BUFFER (octave_idx_type, off, nd);
+
   for (int i = 0; i < nd; i++)
     {
       if (ct == convn_valid)
-        cdims(i) = std::max (adims(i) - bdims(i) + 1,
-                             static_cast<octave_idx_type> (0));
+        {
+          cdims(i) = std::max (adims(i) - bdims(i) + 1,
+                               static_cast<octave_idx_type> (0));
+          off[i] = bdims(i) - 1;
+        }
+      else if (ct == convn_same)
+        {
+          cdims(i) = adims(i);
+          off[i] = bdims(i) / 2;
+        }
       else
-        cdims(i) = std::max (adims(i) + bdims(i) - 1,
-                             static_cast<octave_idx_type> (0));
+        {
+          cdims(i) = adims(i) + bdims(i) - 1;
+          off[i] = 0;
+        }
     }
 
   MArray<T> c (cdims, T ());
 
-  // "valid" shape can sometimes result in empty matrices which must avoid
-  // calling Fortran code which does not expect this (bug #52067)
+  // "valid" shape can sometimes result in empty matrices (bug #52067).
   if (c.isempty ())
     return c;
 
-  convolve_nd<T, R> (a.data (), adims, adims.cumulative (),
-                     b.data (), bdims, bdims.cumulative (),
-                     c.rwdata (), cdims.cumulative (),
-                     nd, ct == convn_valid);
+#if defined (HAVE_FFTW)
+  // The FFT spreads Inf and NaN values over the whole result, so they
+  // are left to the direct method.  So are integer-valued operands, for
+  // which the direct sums are exact (e.g., counting neighbors in a mask).
+  int dim;
+  octave_idx_type blklen;
 
-  if (ct == convn_same)
+  if (convn_choose_fft (adims, bdims, cdims, nd, ct, dim, blklen)
+      && convn_all_finite (a) && convn_all_finite (b)
+      && ! (convn_all_integer (a) && convn_all_integer (b)))
     {
-      // Pick the relevant part.
-      Array<idx_vector> sidx (dim_vector (nd, 1));
-
-      for (int i = 0; i < nd; i++)
-        sidx(i) = idx_vector::make_range (bdims(i)/2, 1, adims(i));
-      c = c.index (sidx);
+      convolve_fft<T, R> (a, adims, b, bdims, c, cdims, off, nd,
+                          dim, blklen);
+      return c;
     }
+#endif
+
+  convolve_nd<T, R> (a.data (), adims, adims.cumulative (),
+                     b.data (), bdims, bdims.cumulative (),
+                     c.rwdata (), cdims, cdims.cumulative (), off, nd);
 
   return c;
 }
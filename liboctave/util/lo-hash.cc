@@ -28,6 +28,7 @@
 #endif
 
 #include <algorithm>
+#include <fstream>
 #include <iomanip>
 #include <sstream>
 #include <string>
@@ -35,19 +36,17 @@
 #include "hash-wrappers.h"
 #include "lo-error.h"
 #include "lo-hash.h"
+#include "lo-sysdep.h"
 #include "oct-locbuf.h"
+#include "quit.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
 OCTAVE_BEGIN_NAMESPACE(crypto)
 
-std::string
-hash (hash_fptr hash_fcn, const std::string& str, int result_buf_len)
+static std::string
+hex_digest (const unsigned char *result_buf, int result_buf_len)
 {
-  OCTAVE_LOCAL_BUFFER (unsigned char, result_buf, result_buf_len);
-
-  hash_fcn (str.data (), str.length (), result_buf);
-
   std::ostringstream buf;
 
   for (int i = 0; i < result_buf_len; i++)
@@ -57,6 +56,16 @@ hash (hash_fptr hash_fcn, const std::string& str, int result_buf_len)
   return buf.str ();
 }
 
+std::string
+hash (hash_fptr hash_fcn, const std::string& str, int result_buf_len)
+{
+  OCTAVE_LOCAL_BUFFER (unsigned char, result_buf, result_buf_len);
+
+  hash_fcn (str.data (), str.length (), result_buf);
+
+  return hex_digest (result_buf, result_buf_len);
+}
+
 int md2_digest_size () { return octave_md2_digest_size (); }
 int md4_digest_size () { return octave_md4_digest_size (); }
 int md5_digest_size () { return octave_md5_digest_size (); }
@@ -142,5 +151,134 @@ hash (const std::string& hash_type, const std::string& str)
       ("hash function '%s' not supported", hash_type.c_str ());
 }
 
+hash_context::hash_context (const std::string& hash_type)
+  : m_ctx (nullptr), m_digest_size (0), m_finished (false)
+{
+  std::string ht = hash_type;
+
+  std::transform (ht.begin (), ht.end (), ht.begin (), ::toupper);
+
+  octave_hash_type type = octave_hash_md5;
+
+  if (ht == "MD2")
+    {
+      type = octave_hash_md2;
+      m_digest_size = md2_digest_size ();
+    }
+  else if (ht == "MD4")
+    {
+      type = octave_hash_md4;
+      m_digest_size = md4_digest_size ();
+    }
+  else if (ht == "MD5")
+    {
+      type = octave_hash_md5;
+      m_digest_size = md5_digest_size ();
+    }
+  else if (ht == "SHA1")
+    {
+      type = octave_hash_sha1;
+      m_digest_size = sha1_digest_size ();
+    }
+  else if (ht == "SHA224")
+    {
+      type = octave_hash_sha224;
+      m_digest_size = sha224_digest_size ();
+    }
+  else if (ht == "SHA256")
+    {
+      type = octave_hash_sha256;
+      m_digest_size = sha256_digest_size ();
+    }
+  else if (ht == "SHA384")
+    {
+      type = octave_hash_sha384;
+      m_digest_size = sha384_digest_size ();
+    }
+  else if (ht == "SHA512")
+    {
+      type = octave_hash_sha512;
+      m_digest_size = sha512_digest_size ();
+    }
+  else
+    (*current_liboctave_error_handler)
+      ("hash function '%s' not supported", hash_type.c_str ());
+
+  m_ctx = octave_hash_ctx_new (type);
+
+  if (! m_ctx)
+    (*current_liboctave_error_handler)
+      ("unable to allocate context for hash function '%s'",
+       hash_type.c_str ());
+}
+
+hash_context::~hash_context ()
+{
+  octave_hash_ctx_free (m_ctx);
+}
+
+void
+hash_context::update (const void *buf, std::size_t len)
+{
+  if (m_finished)
+    (*current_liboctave_error_handler)
+      ("hash_context: can not add data after the hash value was computed");
+
+  octave_hash_ctx_update (m_ctx, static_cast<const char *> (buf), len);
+}
+
+std::string
+hash_context::finish ()
+{
+  if (m_finished)
+    (*current_liboctave_error_handler)
+      ("hash_context: hash value was already computed");
+
+  OCTAVE_LOCAL_BUFFER (unsigned char, result_buf, m_digest_size);
+
+  octave_hash_ctx_finish (m_ctx, result_buf);
+
+  m_finished = true;
+
+  return hex_digest (result_buf, m_digest_size);
+}
+
+std::string
+hash_file (const std::string& hash_type, const std::string& file_name)
+{
+  hash_context ctx (hash_type);
+
+  std::ifstream file = sys::ifstream (file_name,
+                                      std::ios::in | std::ios::binary);
+
+  if (! file.is_open ())
+    (*current_liboctave_error_handler)
+      ("hash: unable to open file '%s'", file_name.c_str ());
+
+  // Large enough to keep the number of reads small, small enough to
+  // stay in the cache.
+  static const std::streamsize buf_len = 65536;
+
+  OCTAVE_LOCAL_BUFFER (char, buf, buf_len);
+
+  while (file)
+    {
+      octave_quit ();
+
+      file.read (buf, buf_len);
+
+      std::streamsize nread = file.gcount ();
+
+      if (nread > 0)
+        ctx.update (buf, nread);
+    }
+
+  if (file.bad ())
+    (*current_liboctave_error_handler)
+      ("hash: error reading file '%s'", file_name.c_str ());
+
+  return ctx.finish ();
+}
+
 OCTAVE_END_NAMESPACE(crypto)
 OCTAVE_END_NAMESPACE(octave)
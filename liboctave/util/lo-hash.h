@@ -60,6 +60,44 @@ OCTAVE_API std::string sha512_hash (const std::string& str);
 OCTAVE_API std::string
 hash (const std::string& hash_type, const std::string& str);
 
+// Compute a hash value from data that is passed in several pieces.
+// The result is the same as hashing all of the pieces concatenated.
+
+class OCTAVE_API hash_context
+{
+public:
+
+  hash_context (const std::string& hash_type);
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (hash_context)
+
+  ~hash_context ();
+
+  void update (const void *buf, std::size_t len);
+
+  void update (const std::string& str)
+  {
+    update (str.data (), str.length ());
+  }
+
+  // Return the hash value as a string of hexadecimal digits.  No more
+  // data may be added afterward.
+  std::string finish ();
+
+private:
+
+  void *m_ctx;
+
+  int m_digest_size;
+
+  bool m_finished;
+};
+
+// Hash the contents of a file without reading all of it into memory.
+
+OCTAVE_API std::string
+hash_file (const std::string& hash_type, const std::string& file_name);
+
 OCTAVE_END_NAMESPACE(crypto)
 OCTAVE_END_NAMESPACE(octave)
 
@@ -30,6 +30,7 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <atomic>
 #include <complex>
 #include <istream>
 #include <limits>
@@ -72,6 +73,20 @@ is_int_or_inf_or_nan (float x)
   return math::isnan (x) || math::x_nint (x) == x;
 }
 
+static std::atomic<octave_idx_type> array_copies (0);
+
+void
+note_array_copy ()
+{
+  array_copies.fetch_add (1, std::memory_order_relaxed);
+}
+
+octave_idx_type
+array_copy_count ()
+{
+  return array_copies.load (std::memory_order_relaxed);
+}
+
 // Save a string.
 
 char *
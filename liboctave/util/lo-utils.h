@@ -109,6 +109,13 @@ template <> OCTAVE_API void write_value (std::ostream& os, const Complex& value)
 template <> OCTAVE_API void write_value (std::ostream& os, const float& value);
 template <> OCTAVE_API void write_value (std::ostream& os, const FloatComplex& value);
 
+// Count of copies of shared data made by Array<T>::make_unique, for
+// checking that operations on uniquely owned arrays happen in place.
+
+extern OCTAVE_API void note_array_copy ();
+
+extern OCTAVE_API octave_idx_type array_copy_count ();
+
 OCTAVE_BEGIN_NAMESPACE(math)
 
 extern OCTAVE_API bool int_multiply_overflow (int a, int b, int *r);
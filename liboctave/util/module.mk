@@ -27,6 +27,7 @@ UTIL_INC = \
   %reldir%/oct-inttypes.h \
   %reldir%/oct-locbuf.h \
   %reldir%/oct-mutex.h \
+  %reldir%/oct-parallel.h \
   %reldir%/oct-refcount.h \
   %reldir%/oct-rl-edit.h \
   %reldir%/oct-rl-hist.h \
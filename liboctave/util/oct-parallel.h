@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_oct_parallel_h)
+#define octave_oct_parallel_h 1
+
+#include "octave-config.h"
+
+#include <algorithm>
+
+#include "quit.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Call BODY (LO, HI) for consecutive chunks [LO, HI) of at most GRAIN
+// iterations that together cover [0, N).  If Octave was built with
+// OpenMP, the chunks are distributed among threads.
+//
+// BODY is called concurrently from several threads, so it must only
+// write to data that is private to its chunk, and it must not throw
+// exceptions or call into the interpreter (this includes octave_quit).
+// Interrupts are checked here between rounds of chunks instead.
+
+template <typename F>
+void
+parallel_for (octave_idx_type n, octave_idx_type grain, F body)
+{
+  if (grain < 1)
+    grain = 1;
+
+  // Number of iterations done between checks for interrupts.
+  octave_idx_type round = 64 * grain;
+
+  for (octave_idx_type lo = 0; lo < n; lo += round)
+    {
+      octave_quit ();
+
+      octave_idx_type hi = std::min (n, lo + round);
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for schedule (static) if (hi - lo > grain)
+#endif
+      for (octave_idx_type k = lo; k < hi; k += grain)
+        body (k, std::min (hi, k + grain));
+    }
+}
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -32,6 +32,8 @@
 #  include "config.h"
 #endif
 
+#include <stdlib.h>
+
 #include "md2.h"
 #include "md4.h"
 #include "md5.h"
@@ -97,3 +99,146 @@ octave_sha512_buffer_wrapper (const char *buf, size_t len, void *res)
 {
   return sha512_buffer (buf, len, res);
 }
+
+struct octave_hash_ctx
+{
+  enum octave_hash_type type;
+
+  union
+  {
+    struct md2_ctx md2;
+    struct md4_ctx md4;
+    struct md5_ctx md5;
+    struct sha1_ctx sha1;
+    struct sha256_ctx sha256;
+    struct sha512_ctx sha512;
+  } u;
+};
+
+void *
+octave_hash_ctx_new (enum octave_hash_type type)
+{
+  struct octave_hash_ctx *ctx = malloc (sizeof (struct octave_hash_ctx));
+
+  if (! ctx)
+    return NULL;
+
+  ctx->type = type;
+
+  switch (type)
+    {
+    case octave_hash_md2:
+      md2_init_ctx (&ctx->u.md2);
+      break;
+
+    case octave_hash_md4:
+      md4_init_ctx (&ctx->u.md4);
+      break;
+
+    case octave_hash_md5:
+      md5_init_ctx (&ctx->u.md5);
+      break;
+
+    case octave_hash_sha1:
+      sha1_init_ctx (&ctx->u.sha1);
+      break;
+
+    case octave_hash_sha224:
+      sha224_init_ctx (&ctx->u.sha256);
+      break;
+
+    case octave_hash_sha256:
+      sha256_init_ctx (&ctx->u.sha256);
+      break;
+
+    case octave_hash_sha384:
+      sha384_init_ctx (&ctx->u.sha512);
+      break;
+
+    case octave_hash_sha512:
+      sha512_init_ctx (&ctx->u.sha512);
+      break;
+
+    default:
+      free (ctx);
+      return NULL;
+    }
+
+  return ctx;
+}
+
+void
+octave_hash_ctx_free (void *ctx)
+{
+  free (ctx);
+}
+
+void
+octave_hash_ctx_update (void *ctx_arg, const char *buf, size_t len)
+{
+  struct octave_hash_ctx *ctx = ctx_arg;
+
+  switch (ctx->type)
+    {
+    case octave_hash_md2:
+      md2_process_bytes (buf, len, &ctx->u.md2);
+      break;
+
+    case octave_hash_md4:
+      md4_process_bytes (buf, len, &ctx->u.md4);
+      break;
+
+    case octave_hash_md5:
+      md5_process_bytes (buf, len, &ctx->u.md5);
+      break;
+
+    case octave_hash_sha1:
+      sha1_process_bytes (buf, len, &ctx->u.sha1);
+      break;
+
+    case octave_hash_sha224:
+    case octave_hash_sha256:
+      sha256_process_bytes (buf, len, &ctx->u.sha256);
+      break;
+
+    case octave_hash_sha384:
+    case octave_hash_sha512:
+      sha512_process_bytes (buf, len, &ctx->u.sha512);
+      break;
+    }
+}
+
+void *
+octave_hash_ctx_finish (void *ctx_arg, void *res)
+{
+  struct octave_hash_ctx *ctx = ctx_arg;
+
+  switch (ctx->type)
+    {
+    case octave_hash_md2:
+      return md2_finish_ctx (&ctx->u.md2, res);
+
+    case octave_hash_md4:
+      return md4_finish_ctx (&ctx->u.md4, res);
+
+    case octave_hash_md5:
+      return md5_finish_ctx (&ctx->u.md5, res);
+
+    case octave_hash_sha1:
+      return sha1_finish_ctx (&ctx->u.sha1, res);
+
+    case octave_hash_sha224:
+      return sha224_finish_ctx (&ctx->u.sha256, res);
+
+    case octave_hash_sha256:
+      return sha256_finish_ctx (&ctx->u.sha256, res);
+
+    case octave_hash_sha384:
+      return sha384_finish_ctx (&ctx->u.sha512, res);
+
+    case octave_hash_sha512:
+      return sha512_finish_ctx (&ctx->u.sha512, res);
+    }
+
+  return NULL;
+}
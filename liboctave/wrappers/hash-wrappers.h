@@ -69,6 +69,29 @@ octave_sha384_buffer_wrapper (const char *buf, size_t len, void *res);
 extern OCTAVE_API void *
 octave_sha512_buffer_wrapper (const char *buf, size_t len, void *res);
 
+// Contexts for computing a hash value incrementally.
+
+enum octave_hash_type
+{
+  octave_hash_md2,
+  octave_hash_md4,
+  octave_hash_md5,
+  octave_hash_sha1,
+  octave_hash_sha224,
+  octave_hash_sha256,
+  octave_hash_sha384,
+  octave_hash_sha512
+};
+
+extern OCTAVE_API void * octave_hash_ctx_new (enum octave_hash_type type);
+
+extern OCTAVE_API void octave_hash_ctx_free (void *ctx);
+
+extern OCTAVE_API void
+octave_hash_ctx_update (void *ctx, const char *buf, size_t len);
+
+extern OCTAVE_API void * octave_hash_ctx_finish (void *ctx, void *res);
+
 #if defined __cplusplus
 }
 #endif
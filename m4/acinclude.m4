@@ -2302,7 +2302,7 @@ AC_DEFUN([OCTAVE_CHECK_SUNDIALS_COMPATIBLE_API], [
   ac_octave_save_LIBS=$LIBS
   LIBS="$SUNDIALS_IDA_LIBS $SUNDIALS_NVECSERIAL_LIBS $LIBS"
   dnl Current API functions present in SUNDIALS version 4
-  AC_CHECK_FUNCS([IDASetJacFn IDASetLinearSolver SUNLinSol_Dense SUNSparseMatrix_Reallocate SUNContext_Create])
+  AC_CHECK_FUNCS([IDASetJacFn IDASetLinearSolver SUNLinSol_Dense SUNSparseMatrix_Reallocate SUNContext_Create IDAGetNumJacEvals])
   dnl FIXME: The purpose of the following tests is to detect the deprecated
   dnl API from SUNDIALS version 3, which should only be used if the current
   dnl API tests above failed. For now, always test for ida_direct.h.
@@ -2477,6 +2477,35 @@ AC_DEFUN([OCTAVE_CHECK_SUNDIALS_SUNLINSOL_KLU], [
   fi
 ])
 dnl
+dnl Check whether SUNDIALS IDA library includes the SUNLINSOL_SPGMR and
+dnl SUNLINSOL_SPBCGS iterative linear solvers and the functions to set a
+dnl preconditioner for them.
+dnl
+AC_DEFUN([OCTAVE_CHECK_SUNDIALS_SUNLINSOL_SPILS], [
+  ac_octave_save_LIBS=$LIBS
+  LIBS="$SUNDIALS_IDA_LIBS $SUNDIALS_NVECSERIAL_LIBS $LIBS"
+  AC_CHECK_HEADERS([sunlinsol/sunlinsol_spgmr.h sunlinsol/sunlinsol_spbcgs.h])
+  AC_CHECK_FUNCS([SUNLinSol_SPGMR SUNLinSol_SPBCGS IDASetPreconditioner])
+  LIBS=$ac_octave_save_LIBS
+  AC_MSG_CHECKING([whether SUNDIALS IDA includes iterative linear solvers])
+  if test "x$ac_cv_header_sunlinsol_sunlinsol_spgmr_h" = xyes \
+     && test "x$ac_cv_header_sunlinsol_sunlinsol_spbcgs_h" = xyes \
+     && test "x$ac_cv_func_SUNLinSol_SPGMR" = xyes \
+     && test "x$ac_cv_func_SUNLinSol_SPBCGS" = xyes \
+     && test "x$ac_cv_func_IDASetPreconditioner" = xyes; then
+    octave_have_sundials_sunlinsol_spils=yes
+    AC_DEFINE(HAVE_SUNDIALS_SUNLINSOL_SPILS, 1,
+      [Define to 1 if SUNDIALS IDA includes the SUNLINSOL_SPGMR and SUNLINSOL_SPBCGS linear solvers.])
+  else
+    octave_have_sundials_sunlinsol_spils=no
+  fi
+  AC_MSG_RESULT([$octave_have_sundials_sunlinsol_spils])
+  if test $octave_have_sundials_sunlinsol_spils = no; then
+    warn_sundials_sunlinsol_spils="SUNDIALS IDA library does not include the SUNLINSOL_SPGMR and SUNLINSOL_SPBCGS linear solvers.  The solvers ode15i and ode15s will not support iterative linear solvers."
+    OCTAVE_CONFIGURE_WARNING([warn_sundials_sunlinsol_spils])
+  fi
+])
+dnl
 dnl Like AC_CONFIG_FILES, but don't touch the output file if it already
 dnl exists and hasn't changed.
 dnl
@@ -104,6 +104,10 @@ classdef Map < handle
     map = struct ();
 
     numeric_keys = false;
+
+    ## New keys are appended to the map and only sorted when the list of
+    ## keys or values is requested.
+    keys_sorted = true;
   endproperties
 
   methods (Access = public)
@@ -240,6 +244,9 @@ classdef Map < handle
       ## Return the sorted list of all keys of the map as a cell vector.
       ## @end deftypefn
 
+      if (! this.keys_sorted)
+        this = sort_keys (this);
+      endif
       keySet = fieldnames (this.map).';  # compatibility requires row vector
       keySet = decode_keys (this, keySet);
 
@@ -257,21 +264,25 @@ classdef Map < handle
       ## @end deftypefn
 
       if (nargin == 1)
+        if (! this.keys_sorted)
+          this = sort_keys (this);
+        endif
         valueSet = struct2cell (this.map).';
       else
         if (! iscell (keySet))
           error ("containers.Map: input argument 'keySet' must be a cell");
         endif
         enckeySet = encode_keys (this, keySet);
-        valueSet = cell (size (keySet));
-        for i = 1:numel (valueSet)
-          try
-            valueSet{i} = this.map.(enckeySet{i});
-          catch
-            error ("containers.Map: key <%s> does not exist",
-                   strtrim (disp (keySet{i})));
-          end_try_catch
-        endfor
+        if (iscellstr (enckeySet))
+          [valueSet, tf] = __getfields__ (this.map, enckeySet);
+        else
+          tf = false (size (keySet));
+        endif
+        if (! all (tf(:)))
+          i = find (! tf, 1);
+          error ("containers.Map: key <%s> does not exist",
+                 strtrim (disp (keySet{i})));
+        endif
       endif
 
     endfunction
@@ -475,12 +486,10 @@ classdef Map < handle
             val = feval (this.ValueType, val);
           endif
           key = encode_keys (this, key);
-          if (isfield (this.map, key))
-            this.map.(key) = val;
-          else
-            this.map.(key) = val;
-            this = sort_keys (this);
+          if (! isfield (this.map, key))
+            this.keys_sorted = false;
           endif
+          this.map.(key) = val;
         case "{}"
           error ("containers.Map: only '()' indexing is supported for assigning values");
       endswitch
@@ -565,13 +574,14 @@ classdef Map < handle
 
     function this = sort_keys (this)
 
-      keySet = keys (this);
+      keySet = decode_keys (this, fieldnames (this.map).');
       if (this.numeric_keys)
         [~, p] = sort (cell2mat (keySet));
       else
         [~, p] = sort (keySet);
       endif
       this.map = orderfields (this.map, p);
+      this.keys_sorted = true;
 
     endfunction
 
@@ -929,3 +939,32 @@ endclassdef
 %! m1 = containers.Map (1, 1);
 %! m2 = containers.Map ("a", 2);
 %! m3 = [m1, m2];
+
+## Keys added one at a time are sorted when requested
+%!test
+%! m = containers.Map ("KeyType", "double", "ValueType", "any");
+%! k = [5, -1, 3.5, 1e6, 0, 2];
+%! for i = 1:numel (k)
+%!   m(k(i)) = i;
+%! endfor
+%! assert (keys (m), num2cell (sort (k)));
+%! assert (values (m), {2, 5, 6, 3, 1, 4});
+%! m(-2) = 7;
+%! assert (values (m, {-2, 1e6}), {7, 4});
+%! assert (m.Count, uint64 (7));
+%! assert (keys (m), num2cell (sort ([k, -2])));
+
+%!test
+%! m = containers.Map ();
+%! n = 2000;
+%! for i = n:-1:1
+%!   m(sprintf ("k%05d", i)) = i;
+%! endfor
+%! assert (m.Count, uint64 (n));
+%! assert (values (m, {"k00010", "k01999"}), {10, 1999});
+%! k = keys (m);
+%! assert (k{1}, "k00001");
+%! assert (k{end}, sprintf ("k%05d", n));
+%! v = values (m);
+%! assert ([v{:}], 1:n);
+
@@ -127,7 +127,9 @@
 ## generally O(M+N), where N is the number of subscripts and M is the
 ## maximum subscript (linearized in multi-dimensional case).  If
 ## @var{fcn} is one of @code{@@sum} (default), @code{@@max},
-## @code{@@min} or @code{@@(x) @{x@}}, an optimized code path is used.
+## @code{@@min}, @code{@@prod}, @code{@@mean}, @code{@@std}, @code{@@numel},
+## @code{@@length}, @code{@@any}, @code{@@all}, or @code{@@(x) @{x@}}, an
+## optimized code path is used, which is multithreaded for large inputs.
 ## Note that for general reduction function the interpreter overhead can
 ## play a major part and it may be more efficient to do multiple
 ## accumarray calls and compute the results in a vectorized manner.
@@ -213,10 +215,21 @@ function A = accumarray (subs, vals, sz = [], fcn = [], fillval = [], issparse =
       [subs, idx] = sortrows (subs);
       n = rows (subs);
       ## Identify runs.
-      jdx = find (any (diff (subs, 1, 1), 2));
+      runs = any (diff (subs, 1, 1), 2);
+      jdx = find (runs);
       jdx = [jdx; n];
 
-      vals = cellfun (fcn, mat2cell (vals(:)(idx), diff ([0; jdx])));
+      op = native_reduction (fcn, vals);
+      if (n > 0 && ! isempty (op))
+        ## Number the runs and reduce them with a builtin function.
+        if (! isscalar (vals))
+          vals = vals(:)(idx);
+        endif
+        vals = __accumarray_reduce__ (cumsum ([1; runs]), vals, op,
+                                      numel (jdx));
+      else
+        vals = cellfun (fcn, mat2cell (vals(:)(idx), diff ([0; jdx])));
+      endif
       subs = subs(jdx, :);
       mode = "unique";
     else
@@ -267,6 +280,8 @@ function A = accumarray (subs, vals, sz = [], fcn = [], fillval = [], issparse =
 
     ## Some built-in reductions handled efficiently.
 
+    op = native_reduction (fcn, vals);
+
     if (fcn == @sum)
       ## Fast summation.
       if (isempty (sz))
@@ -337,6 +352,21 @@ function A = accumarray (subs, vals, sz = [], fcn = [], fillval = [], issparse =
         mask(subs) = false;
         A(mask) = fillval;
       endif
+    elseif (! isempty (op))
+      ## Other reductions with a builtin grouped implementation.
+
+      if (isempty (sz))
+        A = __accumarray_reduce__ (subs, vals, op);
+      else
+        A = __accumarray_reduce__ (subs, vals, op, prod (sz));
+        A = reshape (A, sz);
+      endif
+
+      if (fillval != 0)
+        mask = true (size (A));
+        mask(subs) = false;
+        A(mask) = fillval;
+      endif
     else
 
       ## The general case.  Reduce values.
@@ -388,6 +418,34 @@ function A = accumarray (subs, vals, sz = [], fcn = [], fillval = [], issparse =
 
 endfunction
 
+## Return the name of the builtin grouped reduction that is equivalent to
+## FCN for values like VALS, or "" if there is none.
+function op = native_reduction (fcn, vals)
+
+  op = "";
+
+  if (isfloat (vals) || islogical (vals))
+    if (fcn == @prod)
+      op = "prod";
+    elseif (fcn == @mean)
+      op = "mean";
+    elseif (fcn == @std)
+      op = "std";
+    endif
+  endif
+
+  if (isempty (op) && (isnumeric (vals) || islogical (vals)))
+    if (fcn == @numel || fcn == @length)
+      op = "count";
+    elseif (fcn == @any)
+      op = "any";
+    elseif (fcn == @all)
+      op = "all";
+    endif
+  endif
+
+endfunction
+
 
 %!assert (accumarray ([1; 2; 4; 2; 4], 101:105), [101; 206; 0; 208])
 %!assert (accumarray ([1 1 1; 2 1 2; 2 3 2; 2 1 2; 2 3 2], 101:105),
@@ -445,6 +503,63 @@ endfunction
 %! assert (accumarray (subsc, vals, [], @max),
 %!         accumarray (subs, vals, [], @max));
 
+## Reductions with a builtin grouped implementation
+%!test
+%! subs = ceil (rand (2000, 2) * 10);
+%! vals = rand (2000, 1);
+%! vals(1:7:end) = 0;
+%! assert (accumarray (subs, vals, [], @prod),
+%!         accumarray (subs, vals, [], @(x) prod (x)), -1e-12);
+%! assert (accumarray (subs, vals, [], @mean),
+%!         accumarray (subs, vals, [], @(x) mean (x)), -1e-12);
+%! assert (accumarray (subs, vals, [], @std),
+%!         accumarray (subs, vals, [], @(x) std (x)), -1e-10);
+%! assert (accumarray (subs, vals, [], @numel),
+%!         accumarray (subs, vals, [], @(x) numel (x)));
+%! assert (accumarray (subs, vals, [], @any),
+%!         accumarray (subs, vals, [], @(x) any (x)));
+%! assert (accumarray (subs, vals, [], @all),
+%!         accumarray (subs, vals, [], @(x) all (x)));
+%! assert (accumarray (subs, vals, [12 12], @mean, NaN),
+%!         accumarray (subs, vals, [12 12], @(x) mean (x), NaN), -1e-12);
+%! assert (accumarray (subs, vals, [], @mean, 0, true),
+%!         accumarray (subs, vals, [], @(x) mean (x), 0, true), -1e-12);
+
+## Inputs large enough to be reduced in several chunks that are merged
+%!test
+%! n = 300000;
+%! subs = mod ((0:n-1)' * 7, 20) + 1;
+%! subs(subs == 13) = 22;
+%! vals = 1 + (rand (n, 1) - 0.5) * 1e-3;
+%! vals(subs == 5 & mod ((1:n)', 97) == 0) = NaN;
+%! vals(subs == 7) = 0;
+%! for fcn = {@sum, @prod, @mean, @std, @max, @min, @numel, @any, @all}
+%!   f = fcn{1};
+%!   assert (accumarray (subs, vals, [22, 1], f, -1),
+%!           accumarray (subs, vals, [22, 1], @(x) f (x), -1), -1e-10);
+%! endfor
+%! subs2 = [mod(subs, 4) + 1, ceil(subs / 4)];
+%! cvals = complex (vals, 1 - vals);
+%! for fcn = {@sum, @mean, @std}
+%!   f = fcn{1};
+%!   assert (accumarray (subs2, cvals, [4, 6], f, NaN),
+%!           accumarray (subs2, cvals, [4, 6], @(x) f (x), NaN), -1e-10);
+%!   assert (accumarray (subs2, single (vals), [4, 6], f, NaN),
+%!           accumarray (subs2, single (vals), [4, 6], @(x) f (x), NaN),
+%!           -1e-3);
+%! endfor
+
+%!test
+%! subs = [1; 2; 4; 2; 4; 2];
+%! vals = single ([1; 2; 3; 4; 5; 6] + 1i);
+%! assert (accumarray (subs, vals, [], @mean),
+%!         single ([1; 4; 0; 4] + [1; 1; 0; 1] * 1i));
+%! assert (accumarray (subs, vals, [], @std), single ([0; 2; 0; sqrt(2)]),
+%!         4*eps ("single"));
+%! assert (accumarray (subs, int8 ([0; 1; 2; 3; 0; 4]), [5 1], @all),
+%!         [false; true; false; false; false]);
+%! assert (accumarray (subs, 1, [], @length), [1; 3; 0; 2]);
+
 %!error accumarray (1:5)
 %!error accumarray ([1,2,3],1:2)
 
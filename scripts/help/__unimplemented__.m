@@ -376,7 +376,7 @@ function txt = __unimplemented__ (fcn)
           "rootmusic", "rssq", "sawtooth", "schurrc", "seqperiod", ...
           "setspecs", "settlingtime", "sfdr", "sgolay", "sgolayfilt", ...
           "shiftdata", "sigwin", "sinad", "slewrate", "snr", "sos2cell", ...
-          "sos2ss", "sos2tf", "sos2zp", "sosfilt", "spectrogram", ...
+          "sos2ss", "sos2tf", "sos2zp", "spectrogram", ...
           "spectrum", "sptool", "square", "ss2sos", "ss2tf", "ss2zp", ...
           "statelevels", "stepz", "stmcb", "strips", "taylorwin", "tf2latc", ...
           "tf2sos", "tf2ss", "tf2zp", "tf2zpk", "tfestimate", "thd", "toi", ...
@@ -59,6 +59,23 @@
 ## The optional fifth argument @var{ode_opt} specifies non-default options to
 ## the ODE solver.  It is a structure generated by @code{odeset}.
 ##
+## For large sparse systems, such as those from the method of lines, the
+## @qcode{"JPattern"} option gives the sparsity pattern of the Jacobian, either
+## as one matrix or as a cell array with the patterns of @code{df/dy} and
+## @code{df/dyp}.  The Jacobian is then approximated with one evaluation of
+## @var{fcn} for each group of columns that have no nonzero element in a common
+## row, and it is factorized with a sparse direct solver if @sc{sundials} was
+## built with KLU.  Alternatively, the Octave-specific option
+## @qcode{"LinearSolver"} selects the Krylov methods @qcode{"gmres"} or
+## @qcode{"bicgstab"}, which do not need the Jacobian at all.  A
+## @qcode{"Jacobian"} option is ignored with a warning by these methods.
+## They can be combined with a @qcode{"Preconditioner"} function
+## @code{@var{z} = psolve (@var{t}, @var{y}, @var{yp}, @var{r}, @var{cj})} that
+## returns an approximate solution of @code{@var{P} * @var{z} = @var{r}}, where
+## @var{P} is the matrix @code{df/dy + @var{cj} * df/dyp}.  With
+## @code{"Stats", "on"}, the number of Jacobian evaluations and
+## factorizations, or of linear iterations, is printed.
+##
 ## The function typically returns two outputs.  Variable @var{t} is a
 ## column vector and contains the times where the solution was found.  The
 ## output @var{y} is a matrix in which each column refers to a different
@@ -163,7 +180,7 @@ function varargout = ode15i (fcn, trange, y0, yp0, varargin)
   classes    = rmfield (classes, ignorefields);
   attributes = rmfield (attributes, ignorefields);
 
-  classes    = odeset (classes, "Vectorized", {});
+  classes    = odeset (classes, "JPattern", {}, "Vectorized", {});
   attributes = odeset (attributes, "Jacobian", {}, "Vectorized", {});
 
   options = odemergeopts ("ode15i", options, defaults,
@@ -220,6 +237,41 @@ function varargout = ode15i (fcn, trange, y0, yp0, varargin)
     endif
   endif
 
+  ## Iterative linear solvers only evaluate FCN
+  if (options.havejac && ! strcmp (options.LinearSolver, "direct"))
+    warning ("ode15i:jacobian_unused",
+             ['ode15i: "Jacobian" is not used by "LinearSolver" "%s";', ...
+              ' use it in a "Preconditioner" function instead'],
+             options.LinearSolver);
+  endif
+
+  ## Sparsity pattern of the Jacobian for finite differences
+  options.havejacpattern = false;
+
+  if (! isempty (options.JPattern) && ! options.havejac)
+    JP = options.JPattern;
+    if (! iscell (JP))
+      JP = {JP};
+    endif
+    if (numel (JP) > 2)
+      error ("Octave:invalid-input-arg",
+             'ode15i: "JPattern" must be a matrix or a 2-element cell array');
+    endif
+    pattern = logical (speye (n));
+    for i = 1:numel (JP)
+      if (! isempty (JP{i}))
+        if (! issquare (JP{i}) || rows (JP{i}) != n
+            || ! (isnumeric (JP{i}) || islogical (JP{i})))
+          error ("Octave:invalid-input-arg",
+                 'ode15i: "JPattern" must contain square matrices');
+        endif
+        pattern |= (JP{i} != 0);
+      endif
+    endfor
+    options.JPattern = sparse (pattern);
+    options.havejacpattern = true;
+  endif
+
   ## Abstol and Reltol
   options.haveabstolvec = false;
 
@@ -372,6 +424,23 @@ endfunction
 %! [t, y] = ode15i (ff, 0:1, 1, -3);
 %! assert ([t(end), y(end)], [1, ref], 1e-3);
 
+## Sparsity patterns of the Jacobians
+%!testif HAVE_SUNDIALS
+%! opt = odeset ("JPattern", {[1, 1, 1; 1, 1, 1; 1, 1, 1], speye (3)});
+%! [t, y] = ode15i (@rob, [0, 100], [1; 0; 0], [-1e-4; 1e-4; 0], opt);
+%! assert ([t(end), y(end,:)], fref, 1e-3);
+
+%!testif HAVE_SUNDIALS
+%! opt = odeset ("JPattern", {speye (3), ones (2)});
+%! fail ("[t, y] = ode15i (@rob, [0, 100], [1; 0; 0], [-1e-4; 1e-4; 0], opt)",
+%!       '"JPattern" must contain square matrices');
+
+%!testif HAVE_SUNDIALS_SUNLINSOL_SPILS
+%! opt = odeset ("LinearSolver", "bicgstab", "Jacobian", {-eye(2), eye(2)});
+%! warning ("error", "ode15i:jacobian_unused", "local");
+%! fail ("ode15i (@(t, y, yp) yp + y, [0, 1], [1; 2], [-1; -2], opt)",
+%!       '"Jacobian" is not used by "LinearSolver" "bicgstab"');
+
 ## function passed as string
 %!testif HAVE_SUNDIALS
 %! [t, y] = ode15i ("rob", [0, 100, 200], [1; 0; 0], [-1e-4; 1e-4; 0]);
@@ -53,6 +53,22 @@
 ## The optional fourth argument @var{ode_opt} specifies non-default options to
 ## the ODE solver.  It is a structure generated by @code{odeset}.
 ##
+## For large sparse systems, such as those from the method of lines, the
+## @qcode{"JPattern"} option gives the sparsity pattern of the Jacobian.  The
+## Jacobian is then approximated with one evaluation of @var{fcn} for each
+## group of columns that have no nonzero element in a common row, and it is
+## factorized with a sparse direct solver if @sc{sundials} was built with KLU.
+## Alternatively, the Octave-specific option @qcode{"LinearSolver"} selects the
+## Krylov methods @qcode{"gmres"} or @qcode{"bicgstab"}, which do not need the
+## Jacobian at all.  A @qcode{"Jacobian"} option is ignored with a warning
+## by these methods.  They can be combined with a @qcode{"Preconditioner"}
+## function @code{@var{z} = psolve (@var{t}, @var{y}, @var{r}, @var{cj})} that
+## returns an approximate solution of @code{@var{P} * @var{z} = @var{r}}, where
+## @var{P} is the matrix @code{@var{cj} * @var{M} - @var{J}} with the mass
+## matrix @var{M} and the Jacobian @var{J}.  With @code{"Stats", "on"}, the
+## number of Jacobian evaluations and factorizations, or of linear iterations,
+## is printed.
+##
 ## The function typically returns two outputs.  Variable @var{t} is a
 ## column vector and contains the times where the solution was found.  The
 ## output @var{y} is a matrix in which each column refers to a different
@@ -168,7 +184,7 @@ function varargout = ode15s (fcn, trange, y0, varargin)
 
   [defaults, classes, attributes] = odedefaults (n, trange(1), trange(end));
 
-  classes    = odeset (classes, "Vectorized", {});
+  classes    = odeset (classes, "JPattern", {}, "Vectorized", {});
   attributes = odeset (attributes, "Jacobian", {}, "Vectorized", {});
 
   options = odemergeopts ("ode15s", options, defaults,
@@ -284,6 +300,47 @@ function varargout = ode15s (fcn, trange, y0, varargin)
     endif
   endif
 
+  ## Sparsity pattern of the Jacobian for finite differences
+  options.havejacpattern = false;
+
+  if (! isempty (options.JPattern) && ! options.havejac)
+    JP = options.JPattern;
+    if (! issquare (JP) || rows (JP) != n
+        || ! (isnumeric (JP) || islogical (JP)))
+      error ("Octave:invalid-input-arg",
+             'ode15s: "JPattern" must be a square matrix');
+    endif
+    ## The iteration matrix also contains the mass matrix.
+    pattern = (JP != 0) | speye (n);
+    if (! isempty (options.Mass))
+      if (isnumeric (options.Mass))
+        M = options.Mass;
+      endif
+      if (! isscalar (M))
+        pattern |= (M != 0);
+      endif
+      if (! isempty (options.MvPattern))
+        pattern |= (options.MvPattern != 0);
+      endif
+    endif
+    options.JPattern = sparse (pattern);
+    options.havejacpattern = true;
+  endif
+
+  ## Iterative linear solvers only evaluate FCN
+  if (options.havejac && ! strcmp (options.LinearSolver, "direct"))
+    warning ("ode15s:jacobian_unused",
+             ['ode15s: "Jacobian" is not used by "LinearSolver" "%s";', ...
+              ' use it in a "Preconditioner" function instead'],
+             options.LinearSolver);
+  endif
+
+  ## Preconditioner for iterative linear solvers
+  if (! isempty (options.Preconditioner))
+    psolve = options.Preconditioner;
+    options.Preconditioner = @(t, y, yp, r, cj) psolve (t, y, r, cj);
+  endif
+
   ## Abstol and Reltol
   options.haveabstolvec = false;
 
@@ -608,6 +665,40 @@ endfunction
 %! y2xct = @(t) - exp (-t) + exp (-100 * t);
 %! assert ([y1xct(t), y2xct(t)], y, 1e-3);
 
+## Sparsity pattern of the Jacobian
+%!testif HAVE_SUNDIALS
+%! n = 20;
+%! A = gallery ("tridiag", n);
+%! y0 = sin (pi * (1:n)' / (n+1));
+%! opt = odeset ("JPattern", A != 0, "RelTol", 1e-6, "AbsTol", 1e-8);
+%! [t, y] = ode15s (@(t, y) -A * y, [0, 1], y0, opt);
+%! assert (y(end,:).', expm (-full (A)) * y0, 1e-4);
+
+## Iterative linear solvers
+%!testif HAVE_SUNDIALS_SUNLINSOL_SPILS
+%! n = 20;
+%! A = gallery ("tridiag", n);
+%! y0 = sin (pi * (1:n)' / (n+1));
+%! opt = odeset ("LinearSolver", "gmres", "RelTol", 1e-6, "AbsTol", 1e-8);
+%! [t, y] = ode15s (@(t, y) -A * y, [0, 1], y0, opt);
+%! assert (y(end,:).', expm (-full (A)) * y0, 1e-4);
+
+%!testif HAVE_SUNDIALS_SUNLINSOL_SPILS
+%! n = 20;
+%! A = gallery ("tridiag", n);
+%! y0 = sin (pi * (1:n)' / (n+1));
+%! opt = odeset ("LinearSolver", "bicgstab", "RelTol", 1e-6, "AbsTol", 1e-8,
+%!               "Preconditioner", @(t, y, r, cj) (cj * speye (n) + A) \ r);
+%! [t, y] = ode15s (@(t, y) -A * y, [0, 1], y0, opt);
+%! assert (y(end,:).', expm (-full (A)) * y0, 1e-4);
+
+%!testif HAVE_SUNDIALS_SUNLINSOL_SPILS
+%! A = gallery ("tridiag", 5);
+%! opt = odeset ("LinearSolver", "gmres", "Jacobian", -A);
+%! warning ("error", "ode15s:jacobian_unused", "local");
+%! fail ("ode15s (@(t, y) -A * y, [0, 1], ones (5, 1), opt)",
+%!       '"Jacobian" is not used by "LinearSolver" "gmres"');
+
 ## two output arguments
 %!testif HAVE_SUNDIALS
 %! [t, y] = ode15s (@fpol, [0, 2], [2, 0]);
@@ -164,8 +164,8 @@ function varargout = ode23 (fcn, trange, init, varargin)
                                                  trange(1), trange(end));
 
   persistent ode23_ignore_options = ...
-    {"BDF", "InitialSlope", "Jacobian", "JPattern",
-     "MassSingular", "MaxOrder", "MvPattern", "Vectorized"};
+    {"BDF", "InitialSlope", "Jacobian", "JPattern", "LinearSolver",
+     "MassSingular", "MaxOrder", "MvPattern", "Preconditioner", "Vectorized"};
 
   defaults   = rmfield (defaults, ode23_ignore_options);
   classes    = rmfield (classes, ode23_ignore_options);
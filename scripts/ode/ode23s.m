@@ -165,8 +165,9 @@ function varargout = ode23s (fcn, trange, init, varargin)
                                                  trange(1), trange(end));
 
   persistent ode23s_ignore_options = ...
-    {"BDF", "InitialSlope", "MassSingular", "MStateDependence", ...
-     "MvPattern", "MaxOrder", "NonNegative"};
+    {"BDF", "InitialSlope", "LinearSolver", "MassSingular", ...
+     "MStateDependence", "MvPattern", "MaxOrder", "NonNegative", ...
+     "Preconditioner"};
 
   defaults   = rmfield (defaults, ode23s_ignore_options);
   classes    = rmfield (classes, ode23s_ignore_options);
@@ -163,8 +163,8 @@ function varargout = ode45 (fcn, trange, init, varargin)
   defaults = odeset (defaults, "Refine", 4);
 
   persistent ode45_ignore_options = ...
-    {"BDF", "InitialSlope", "Jacobian", "JPattern",
-     "MassSingular", "MaxOrder", "MvPattern", "Vectorized"};
+    {"BDF", "InitialSlope", "Jacobian", "JPattern", "LinearSolver",
+     "MassSingular", "MaxOrder", "MvPattern", "Preconditioner", "Vectorized"};
 
   defaults   = rmfield (defaults, ode45_ignore_options);
   classes    = rmfield (classes, ode45_ignore_options);
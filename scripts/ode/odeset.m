@@ -88,6 +88,11 @@
 ## If the Jacobian matrix is sparse and non-constant but maintains a
 ## constant sparsity pattern, specify the sparsity pattern.
 ##
+## @item @code{LinearSolver}: @{@qcode{"direct"}@} | @qcode{"gmres"} | @qcode{"bicgstab"}
+## Method for solving the linear systems in implicit methods.
+## @emph{Note}: This option is specific to Octave and only used by
+## @code{ode15i} and @code{ode15s}.
+##
 ## @item @code{Mass}: matrix | function_handle
 ## Mass matrix, specified as a constant matrix or a function of
 ## time and state.
@@ -125,6 +130,11 @@
 ## Indices of elements of the state vector to be passed to the output
 ## monitoring function.
 ##
+## @item @code{Preconditioner}: function_handle
+## Preconditioner for an iterative @code{LinearSolver}.
+## @emph{Note}: This option is specific to Octave and only used by
+## @code{ode15i} and @code{ode15s}.
+##
 ## @item @code{Refine}: positive scalar
 ## Specify whether output should be returned only at the end of each
 ## time step or also at intermediate time instances.  The value should be
@@ -163,6 +173,7 @@ function odestruct = odeset (varargin)
     p.addParameter ("Jacobian", []);
     p.addParameter ("JConstant", []);
     p.addParameter ("JPattern", []);
+    p.addParameter ("LinearSolver", []);
     p.addParameter ("Mass", []);
     p.addParameter ("MassSingular", []);
     p.addParameter ("MaxOrder", []);
@@ -173,6 +184,7 @@ function odestruct = odeset (varargin)
     p.addParameter ("NormControl", []);
     p.addParameter ("OutputFcn", []);
     p.addParameter ("OutputSel", []);
+    p.addParameter ("Preconditioner", []);
     p.addParameter ("Refine", []);
     p.addParameter ("RelTol", []);
     p.addParameter ("Stats", []);
@@ -216,6 +228,7 @@ function print_options ()
   disp ('           Jacobian:  matrix or function_handle, []');
   disp ('          JConstant:  binary, {["off"], "on"}');
   disp ('           JPattern:  sparse matrix, []');
+  disp ('       LinearSolver:  switch, {["direct"], "gmres", "bicgstab"}');
   disp ('               Mass:  matrix or function_handle, []');
   disp ('       MassSingular:  switch, {["maybe"], "no", "yes"}');
   disp ('           MaxOrder:  switch, {[5], 1, 2, 3, 4, }');
@@ -226,6 +239,7 @@ function print_options ()
   disp ('        NormControl:  binary, {["off"], "on"}');
   disp ('          OutputFcn:  function_handle, []');
   disp ('          OutputSel:  scalar or vector, []');
+  disp ('     Preconditioner:  function_handle, []');
   disp ('             Refine:  scalar, integer, >0, []');
   disp ('             RelTol:  scalar, >0, [1e-3]');
   disp ('              Stats:  binary, {["off"], "on"}');
@@ -255,7 +269,7 @@ endfunction
 %!test
 %! odeoptA = odeset ();
 %! assert (isstruct (odeoptA));
-%! assert (numfields (odeoptA), 22);
+%! assert (numfields (odeoptA), 24);
 %! assert (all (structfun ("isempty", odeoptA)));
 
 %!shared odeoptB, odeoptC
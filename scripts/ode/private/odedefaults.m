@@ -38,6 +38,7 @@ function [rdefaults, rclasses, rattributes] = odedefaults (n, t0, tf)
                                 "Jacobian", [],
                                 "JConstant", "off",
                                 "JPattern", [],
+                                "LinearSolver", "direct",
                                 "Mass", [],
                                 "MassSingular", "maybe",
                                 "MaxOrder", 5,
@@ -48,6 +49,7 @@ function [rdefaults, rclasses, rattributes] = odedefaults (n, t0, tf)
                                 "NormControl", "off",
                                 "OutputFcn", [],
                                 "OutputSel", [],
+                                "Preconditioner", [],
                                 "Refine", 1,
                                 "RelTol", 1e-3,
                                 "Stats", "off",
@@ -64,6 +66,7 @@ function [rdefaults, rclasses, rattributes] = odedefaults (n, t0, tf)
                                "Jacobian", {{"float", "function_handle", "cell"}},
                                "JConstant", "char",
                                "JPattern", {{"float"}},
+                               "LinearSolver", "char",
                                "Mass", {{"float", "function_handle"}},
                                "MassSingular", "char",
                                "MaxOrder", {{"float"}},
@@ -74,6 +77,7 @@ function [rdefaults, rclasses, rattributes] = odedefaults (n, t0, tf)
                                "NormControl", "char",
                                "OutputFcn", {{"function_handle"}},
                                "OutputSel", {{"float"}},
+                               "Preconditioner", {{"function_handle"}},
                                "Refine", {{"float"}},
                                "RelTol", {{"float"}},
                                "Stats", "char",
@@ -87,6 +91,7 @@ function [rdefaults, rclasses, rattributes] = odedefaults (n, t0, tf)
                                   "Jacobian", {{}},
                                   "JConstant", {{"on", "off"}},
                                   "JPattern", {{}},
+                                  "LinearSolver", {{"direct", "gmres", "bicgstab"}},
                                   "Mass", {{}},
                                   "MassSingular", {{"no", "maybe", "yes"}},
                                   "MaxOrder", {{">=", 0, "<=", 5, "integer"}},
@@ -98,6 +103,7 @@ function [rdefaults, rclasses, rattributes] = odedefaults (n, t0, tf)
                                   "OutputFcn", {{}},
                                   "OutputSel", {{"vector", "integer", "positive",...
                                                  ">", 0, "<=", n}},
+                                  "Preconditioner", {{}},
                                   "Refine", {{"scalar", ">", 0, "integer"}},
                                   "RelTol", {{"scalar", "positive", "real"}},
                                   "Stats", {{"on", "off"}},
@@ -146,6 +146,12 @@
 ## randomly generate a starting vector.  If specified, @code{v0} must be
 ## an @var{n}-by-1 vector where @code{@var{n} = rows (@var{A})}.
 ##
+## To warm-start a computation from a previous one, for example when the
+## matrix changes only slightly between calls, @code{v0} may also be an
+## @var{n}-by-@var{j} matrix such as the eigenvectors @var{V} returned by the
+## earlier call.  Its columns are scaled to unit norm and summed to form the
+## starting vector.
+##
 ## @item disp
 ## The level of diagnostic printout (0|1|2).  If @code{disp} is 0 then
 ## diagnostics are disabled.  The default value is 0.
@@ -1645,6 +1651,47 @@ endfunction
 %! [~, d] = eigs (A);
 %! assert (isreal (d));
 
+## Warm start from the eigenvectors of a previous call
+%!testif HAVE_ARPACK
+%! n = 100;
+%! A = spdiags ([ones(n,1), (1:n)', ones(n,1)], -1:1, n, n);
+%! [V, D] = eigs (A, 4);
+%! opts.v0 = V;
+%! d = eigs (A + 1e-3 * speye (n), 4, "lm", opts);
+%! assert (d, diag (D) + 1e-3, 1e-10);
+%! opts.v0 = V.';
+%! fail ("eigs (A, 4, 'lm', opts)", "opts.v0 must be n-by-1 or n-by-j");
+%! opts.v0 = [V(:,1), -V(:,1)];
+%! fail ("eigs (A, 4, 'lm', opts)", "opts.v0 must add up to a nonzero");
+%! opts.v0 = [zeros(n,1), NaN(n,1)];
+%! fail ("eigs (A, 4, 'lm', opts)", "opts.v0 must add up to a nonzero");
+%! __eigs_free_workspaces__ ();
+%!testif HAVE_ARPACK
+%! n = 100;
+%! A = spdiags ([ones(n,1), (1:n)', 1i*ones(n,1)], -1:1, n, n);
+%! [V, D] = eigs (A, 4);
+%! opts.v0 = V;
+%! d = eigs (A, 4, "lm", opts);
+%! assert (d, diag (D), 1e-10);
+
+## Large sparse matrices use the multi-threaded product
+%!testif HAVE_ARPACK
+%! n = 30000;
+%! d = (1:n)' / n;
+%! d(end-3:end) = [2; 3; 4; 5];
+%! A = spdiags ([0.01*ones(n,1), d, 0.01*ones(n,1)], -1:1, n, n);
+%! opts.v0 = ones (n, 1);
+%! d1 = eigs (A, 4, "lm", opts);
+%! opts.issym = true;
+%! d2 = eigs (@(x) A * x, n, 4, "lm", opts);
+%! assert (d1, d2, 1e-10);
+%! B = A + spdiags (0.005*ones (n,1), 2, n, n);
+%! opts = struct ("v0", ones (n, 1));
+%! d1 = eigs (B, 4, "lm", opts);
+%! opts.issym = false;
+%! d2 = eigs (@(x) B * x, n, 4, "lm", opts);
+%! assert (d1, d2, 1e-10);
+
 %!testif HAVE_ARPACK <*59486>
 %! A = magic (5);
 %! d = eigs (A, [], 1);
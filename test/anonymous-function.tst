@@ -28,3 +28,16 @@
 %! f = @(x) x.re ;
 %! f(s);
 %! assert (ans, pi);
+
+## Captured variables are bound once and reused by every call
+%!test
+%! a = 2;  b = [1, 2, 3];
+%! f = @(x) a*x + b;
+%! a = 5;  b = 0;
+%! for i = 1:3
+%!   assert (f (i), 2*i + [1, 2, 3]);
+%! endfor
+%! g = f;
+%! assert (g (1), [3, 4, 5]);
+%! w = functions (f).workspace{1};
+%! assert (w, struct ("a", 2, "b", [1, 2, 3]));
@@ -213,3 +213,50 @@
 
 ## test class with methods in @folder and in classdef definition
 %!assert <*62802> (numel (methods ("class_bug62802")), 4)
+
+## repeated lookups of inherited members
+%!test
+%! B = class_bug52614B ();
+%! for i = 1:3
+%!   B.a = i;
+%!   foo (B);
+%!   assert (B.a, 1);
+%!   assert (B.b, 2);
+%!   assert (isprop (B, "a"));
+%!   assert (! isprop (B, "c"));
+%! endfor
+%! A = class_bug52614A ();
+%! assert (! isprop (A, "b"));
+
+## objects created after the first share the default property layout
+%!test
+%! B1 = class_bug52614B ();
+%! B2 = class_bug52614B ();
+%! B1.a = 10;
+%! assert (B2.a, 1);
+%! assert (B2.b, 2);
+%! assert (sort (properties (B2)), sort (properties (B1)));
+%! A = class_bug52614A ();
+%! assert (properties (A), {"a"});
+
+%!test
+%! v1 = foo_value_class ();
+%! v2 = v1;
+%! props = properties (v1);
+%! for i = 1:numel (props)
+%!   assert (v2.(props{i}), v1.(props{i}));
+%! endfor
+
+## the saved layout of a superclass must not replace properties that an
+## earlier superclass has already added
+%!test
+%! B = foo_mi_super2 ();
+%! B = foo_mi_super2 ();
+%! for i = 1:2
+%!   C = foo_mi_derived ();
+%!   assert (sort (properties (C)), sort ({"a"; "a2"; "b"; "b2"; "c"}));
+%!   assert ({C.a, C.a2, C.b, C.b2, C.c}, {1, "one", 2, "two", 3});
+%! endfor
+%! A = foo_mi_super1 ();
+%! assert (sort (properties (A)), {"a"; "a2"});
+%! assert (B.b2, "two");
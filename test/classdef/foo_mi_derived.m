@@ -0,0 +1,5 @@
+classdef foo_mi_derived < foo_mi_super1 & foo_mi_super2
+  properties
+    c = 3
+  end
+end
@@ -0,0 +1,6 @@
+classdef foo_mi_super1
+  properties
+    a = 1
+    a2 = "one"
+  end
+end
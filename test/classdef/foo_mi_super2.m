@@ -0,0 +1,6 @@
+classdef foo_mi_super2
+  properties
+    b = 2
+    b2 = "two"
+  end
+end
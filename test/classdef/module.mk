@@ -7,6 +7,9 @@ classdef_TEST_FILES = \
   %reldir%/class_bug55766.m \
   %reldir%/classdef.tst \
   %reldir%/foo_method_changes_property_size.m \
+  %reldir%/foo_mi_derived.m \
+  %reldir%/foo_mi_super1.m \
+  %reldir%/foo_mi_super2.m \
   %reldir%/foo_static_method_constant_property.m \
   %reldir%/foo_subsref_subsasgn.m \
   %reldir%/foo_value_class.m \
@@ -612,3 +612,23 @@
 %! c = cell (1,1,1);
 %! c{1,1,1} = zeros(5, 2);
 %! c{1,1,1}(:, 1) = 1;
+
+## Contiguous vector and mask indices produce shallow slices
+%!test
+%! a = reshape (1:60, [4, 5, 3]);
+%! assert (a(:, [2, 3, 4], 2), a(:, 2:4, 2));
+%! assert (a(:, :, [false, true, true]), a(:, :, 2:3));
+%! assert (a(:, [2, 3, 5], 1), [a(:, 2:3, 1), a(:, 5, 1)]);
+%! assert (a([6; 7; 8]), (6:8)');
+%! b = a(:, [1, 2]);
+%! b(1) = -1;
+%! assert (a(1), 1);
+
+## Matrix-shaped consecutive indices keep their shape for sparse arrays
+%!test
+%! s = sparse ([1; 0; 2; 3]);
+%! assert (s([1, 3; 2, 4]), sparse ([1, 2; 0, 3]));
+%! assert (s([1, 2; 3, 4]), sparse ([1, 0; 2, 3]));
+%! s = sparse ([1, 0, 2, 3]);
+%! assert (s([1, 3; 2, 4]), sparse ([1, 2; 0, 3]));
+%! assert (s([2, 3]), sparse ([0, 2]));
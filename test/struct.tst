@@ -264,3 +264,22 @@
 %! s = resize (struct (),3,2);
 %! s(3).foo = 42;
 %! s(7);
+
+## field lookup in structs with many fields
+%!test
+%! names = arrayfun (@(k) sprintf ("f%03d", k), 1:200, "uniformoutput", false);
+%! s = cell2struct (num2cell (1:200), names, 2);
+%! for k = 1:200
+%!   assert (s.(names{k}), k);
+%! endfor
+%! s = rmfield (s, names(1:2:end));
+%! assert (numfields (s), 100);
+%! assert (isfield (s, names), logical (mod (0:199, 2)));
+%! for k = 2:2:200
+%!   assert (s.(names{k}), k);
+%! endfor
+%! s.("new") = -1;
+%! t = orderfields (s);
+%! assert (fieldnames (t), sort ([names(2:2:end), {"new"}])');
+%! assert (t.new, -1);
+%! assert (t.f200, 200);